@@ -8,11 +8,12 @@ make_directory(${destDir})
 # Get all files with the following extentions
 # vert
 # frag
+# comp
 
 # Compile shaders
 if( $ENV{COMPILE_SHADERS} )
     message("Compiling shaders...")
-    file( GLOB_RECURSE  shaders "${srcDir}/*.vert" "${srcDir}/*.frag")
+    file( GLOB_RECURSE  shaders "${srcDir}/*.vert" "${srcDir}/*.frag" "${srcDir}/*.comp")
 
     foreach(shader ${shaders})
         file(RELATIVE_PATH relative_path ${srcDir} ${shader})
@@ -47,6 +48,37 @@ else() # Copy shaders
         configure_file("${shader}" "${destDir}/${relative_path}" COPYONLY)
     endforeach(shader ${shaders})
 
+    # Shaders without a precompiled spv are compiled & validated as part of the build
+    set(vcpkgTools "${VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}/tools")
+    find_program(GLSLC_EXECUTABLE glslc HINTS "${vcpkgTools}/shaderc" "$ENV{VULKAN_SDK}/bin")
+    find_program(SPIRV_VAL_EXECUTABLE spirv-val
+        HINTS "${vcpkgTools}/spirv-tools" "$ENV{VULKAN_SDK}/bin")
+    file( GLOB sources "${srcDir}/*.vert" "${srcDir}/*.frag" "${srcDir}/*.comp")
+
+    foreach(source ${sources})
+        get_filename_component(name ${source} NAME)
+        if(NOT EXISTS "${srcDir}/compiled/${name}.spv")
+            if(NOT GLSLC_EXECUTABLE OR NOT SPIRV_VAL_EXECUTABLE)
+                message(FATAL_ERROR "glslc and spirv-val are needed to compile shader: ${source}")
+            endif()
+
+            message("Compiling shader: ${source}")
+            set(OUTF "${destDir}/${name}.spv")
+
+            # Only a spv that passed validation reaches the output
+            add_custom_command(
+                OUTPUT "${OUTF}"
+                COMMAND "${GLSLC_EXECUTABLE}" "${source}" -o "${OUTF}.unvalidated"
+                COMMAND "${SPIRV_VAL_EXECUTABLE}" --target-env vulkan1.2 "${OUTF}.unvalidated"
+                COMMAND ${CMAKE_COMMAND} -E rename "${OUTF}.unvalidated" "${OUTF}"
+                DEPENDS "${source}"
+                VERBATIM
+            )
+
+            target_sources("engine" PRIVATE "${source}" "${OUTF}")
+        endif()
+    endforeach(source ${sources})
+
 endif()
 
 
@@ -6,6 +6,7 @@
 for filename in *.vert; 
     do echo "Compiling ${filename}";
     glslc ${filename} -o compiled/${filename}.spv
+    spirv-val --target-env vulkan1.2 compiled/${filename}.spv
 done
 
 
@@ -13,4 +14,13 @@ done
 for filename in *.frag; 
     do echo "Compiling ${filename}";
     glslc ${filename} -o compiled/${filename}.spv
+    spirv-val --target-env vulkan1.2 compiled/${filename}.spv
+done
+
+
+# Compile compute files
+for filename in *.comp; 
+    do echo "Compiling ${filename}";
+    glslc ${filename} -o compiled/${filename}.spv
+    spirv-val --target-env vulkan1.2 compiled/${filename}.spv
 done
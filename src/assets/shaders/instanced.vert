@@ -0,0 +1,39 @@
+#version 450
+
+// Written once per frame, MAX_DRAW_MATERIALS colors
+layout(binding = 0) uniform CameraData {
+    mat4 view;
+    mat4 proj;
+    vec4 materials[64];
+} camera;
+
+// Per draw, changed without touching descriptors
+layout(push_constant) uniform DrawConstants {
+    uint material;
+} draw;
+
+// One model matrix per instance
+layout(std430, binding = 2) readonly buffer InstanceBuffer {
+    mat4 models[];
+} instances;
+
+// Instances that survived culling, firstInstance of each indirect command offsets into it
+layout(std430, binding = 3) readonly buffer VisibleBuffer {
+    uint indices[];
+} visible;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out vec3 fragMaterial;
+
+void main() {
+    mat4 model = instances.models[visible.indices[gl_InstanceIndex]];
+    gl_Position = camera.proj * camera.view * model * vec4(inPosition, 1.0);
+    fragColor = inColor;
+    fragTexCoord = inTexCoord;
+    fragMaterial = camera.materials[draw.material].rgb;
+}
@@ -0,0 +1,44 @@
+##################################
+########## Benchmarking ##########
+##################################
+
+find_package(benchmark CONFIG REQUIRED)
+
+add_executable(engine_bench_logger benchmarking/logger_bench.cc)
+set_target_properties(engine_bench_logger PROPERTIES LINKER_LANGUAGE CXX)
+
+target_link_libraries(
+  engine_bench_logger
+  benchmark::benchmark
+  logger
+)
+
+# Machine-readable results for comparing runs, e.g. with benchmark's compare.py
+add_custom_target(
+  bench_logger_json
+  COMMAND engine_bench_logger
+          --benchmark_out=${CMAKE_BINARY_DIR}/logger_bench.json
+          --benchmark_out_format=json
+  DEPENDS engine_bench_logger
+  WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+)
+
+# Needs a Vulkan device & a display, compares frame rate and latency across frames in flight
+add_executable(engine_bench_frames benchmarking/frame_bench.cc)
+set_target_properties(engine_bench_frames PROPERTIES LINKER_LANGUAGE CXX)
+
+target_link_libraries(
+  engine_bench_frames
+  benchmark::benchmark
+  logger
+  window_manager
+)
+
+add_custom_target(
+  bench_frames_json
+  COMMAND engine_bench_frames
+          --benchmark_out=${CMAKE_BINARY_DIR}/frame_bench.json
+          --benchmark_out_format=json
+  DEPENDS engine_bench_frames
+  WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+)
@@ -0,0 +1,102 @@
+/**
+ * @file frame_bench.cc
+ * @author Thumpy (◕‿◕✿)
+ * @brief Frame rate & input to present latency with 1, 2 and 3 frames in flight
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <logger.hpp>
+
+#include "vulkan/vulkan_draw_list.hpp"
+#include "vulkan/vulkan_helper.hpp"
+#include "vulkan/vulkan_render.hpp"
+#include "vulkan/vulkan_window.hpp"
+
+bool APPLICATION_RUNNING = true;
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+// Frames drawn before timing starts, fills every frame in flight slot
+const int WARM_UP_FRAMES = 10;
+
+/**
+ * @brief Draws the model every iteration. items_per_second is the frame rate, latency_ms the
+ * average from the start of a frame to its present
+ */
+static void BM_frames_in_flight( benchmark::State &state ) {
+  VulkanWindow *window = nullptr;
+  try {
+    window = new VulkanWindow( "Frames in flight benchmark", static_cast<int>( state.range( 0 ) ) );
+  } catch ( VulkanNotCompatible &ex ) {
+    state.SkipWithError( "No Vulkan device" );
+    return;
+  }
+
+  DrawList &drawList = window->draw_list();
+  drawList.clear();
+  drawList.add_instance( window->mesh_id(), glm::mat4( 1.0f ) );
+  drawList.build();
+
+  for ( int i = 0; i < WARM_UP_FRAMES; i++ ) {
+    glfwPollEvents();
+    window->draw_frame();
+  }
+
+  FramePacing start = window->frame_pacing();
+  for ( auto _ : state ) {
+    glfwPollEvents();
+    window->draw_frame();
+  }
+  FramePacing end = window->frame_pacing();
+
+  state.SetItemsProcessed( state.iterations() );
+  uint64_t samples = end.latencySamples - start.latencySamples;
+  if ( samples > 0 ) {
+    state.counters["latency_ms"] =
+        ( end.latencyMilliseconds - start.latencyMilliseconds ) / static_cast<double>( samples );
+  }
+  // 0 when the device has no present wait, latency then ends when the GPU finished the frame
+  state.counters["to_present"] = window->times_present() ? 1.0 : 0.0;
+
+  window->deconstruct_window();
+  glfwTerminate();
+}
+BENCHMARK( BM_frames_in_flight )
+    ->Arg( 1 )
+    ->Arg( 2 )
+    ->Arg( 3 )
+    ->Iterations( 600 )
+    ->UseRealTime()
+    ->Unit( benchmark::kMillisecond );
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
+
+int main( int argc, char **argv ) {
+  // Keep the window & device logs out of the benchmark report
+  Thumpy::Core::Logger::init();
+  Thumpy::Core::Logger::set_term_log_vision( Thumpy::Core::Logger::NONE );
+
+  benchmark::Initialize( &argc, argv );
+  if ( benchmark::ReportUnrecognizedArguments( argc, argv ) ) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  Thumpy::Core::Logger::close_logger();
+  return 0;
+}
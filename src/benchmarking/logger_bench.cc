@@ -0,0 +1,299 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <logger.hpp>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "async_logger.hpp"
+#include "binary_logger.hpp"
+#include "file_logger.hpp"
+#include "log_record.hpp"
+#include "logger_helper.hpp"
+#include "ring_sink.hpp"
+#include "term_logger.hpp"
+
+namespace Thumpy {
+namespace Core {
+
+// Accepted by the file sink, DEBUG is filtered out by every sink
+const Logger::LogLevel ACCEPTED_LEVEL = Logger::INFO;
+const Logger::LogLevel FILTERED_LEVEL = Logger::DEBUG;
+
+/**
+ * @brief Times each call and reports latency percentiles as counters
+ *
+ */
+class LatencyRecorder {
+ public:
+  explicit LatencyRecorder( benchmark::State &state ) : state_( state ) {
+    samples_.reserve( std::min<size_t>( state.max_iterations, 1 << 20 ) );
+  }
+
+  ~LatencyRecorder() {
+    state_.SetItemsProcessed( state_.iterations() );
+    if ( samples_.empty() ) {
+      return;
+    }
+    std::sort( samples_.begin(), samples_.end() );
+    report( "p50_ns", 0.50 );
+    report( "p99_ns", 0.99 );
+    report( "p999_ns", 0.999 );
+    state_.counters["max_ns"] = benchmark::Counter( static_cast<double>( samples_.back() ),
+                                                    benchmark::Counter::kAvgThreads );
+  }
+
+  template <typename Call>
+  void measure( Call &&call ) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    auto end = std::chrono::steady_clock::now();
+    if ( samples_.size() < samples_.capacity() ) {
+      samples_.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+    }
+  }
+
+ private:
+  void report( const char *name, double percentile ) {
+    size_t index = static_cast<size_t>( percentile * static_cast<double>( samples_.size() - 1 ) );
+    state_.counters[name] = benchmark::Counter( static_cast<double>( samples_[index] ),
+                                                benchmark::Counter::kAvgThreads );
+  }
+
+  benchmark::State &state_;
+  std::vector<int64_t> samples_;
+};
+
+#pragma region Setup
+
+static void start_async( const benchmark::State & ) { Logger::start_async(); }
+
+static void stop_async( const benchmark::State & ) { Logger::stop_async(); }
+
+// The terminal sink writes to std::cout, keep it away from the benchmark report
+static std::ostringstream terminalCapture;
+static std::streambuf *coutBuffer = nullptr;
+
+static void capture_terminal( const benchmark::State & ) {
+  terminalCapture.str( std::string() );
+  coutBuffer = std::cout.rdbuf( terminalCapture.rdbuf() );
+}
+
+static void release_terminal( const benchmark::State & ) {
+  std::cout.rdbuf( coutBuffer );
+  terminalCapture.str( std::string() );
+}
+
+static void open_binary_log( const benchmark::State & ) {
+  Logger::open_binary_log( "bench_binary.bin", 256 * 1024 * 1024, Logger::ALL & ~FILTERED_LEVEL );
+}
+
+static void close_binary_log( const benchmark::State & ) { Logger::close_binary_log(); }
+
+// Opened before any benchmark thread starts writing & closed once they are all done
+static std::ofstream fileSinkStream;
+static Logger::FileSink fileSink( &fileSinkStream, Logger::ALL, 256 );
+
+static void open_file_sink( const benchmark::State & ) { fileSink.open( "bench_file_sink.dump" ); }
+
+static void close_file_sink( const benchmark::State & ) { fileSink.close(); }
+
+#pragma endregion Setup
+
+#pragma region Front end
+
+static void BM_log_accepted( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  for ( auto _ : state ) {
+    recorder.measure(
+        [] { Logger::log( "Benchmark message accepted by the file sink", ACCEPTED_LEVEL ); } );
+  }
+}
+BENCHMARK( BM_log_accepted )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+BENCHMARK( BM_log_accepted )
+    ->Name( "BM_log_accepted_async" )
+    ->Setup( start_async )
+    ->Teardown( stop_async )
+    ->Threads( 1 )
+    ->Threads( 4 )
+    ->Threads( 16 )
+    ->UseRealTime();
+
+static void BM_log_filtered( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  for ( auto _ : state ) {
+    recorder.measure( [] { Logger::log( "Benchmark message no sink accepts", FILTERED_LEVEL ); } );
+  }
+}
+BENCHMARK( BM_log_filtered )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+
+static void BM_thumpy_log_accepted( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  int frame = 0;
+  for ( auto _ : state ) {
+    recorder.measure( [&frame] {
+      THUMPY_LOG( ACCEPTED_LEVEL, "Frame ", frame++, " took ", 16.6, " ms" );
+    } );
+  }
+}
+BENCHMARK( BM_thumpy_log_accepted )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+BENCHMARK( BM_thumpy_log_accepted )
+    ->Name( "BM_thumpy_log_accepted_async" )
+    ->Setup( start_async )
+    ->Teardown( stop_async )
+    ->Threads( 1 )
+    ->Threads( 4 )
+    ->Threads( 16 )
+    ->UseRealTime();
+
+static void BM_thumpy_log_filtered( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  int frame = 0;
+  for ( auto _ : state ) {
+    recorder.measure( [&frame] {
+      THUMPY_LOG( FILTERED_LEVEL, "Frame ", frame++, " took ", 16.6, " ms" );
+    } );
+  }
+}
+BENCHMARK( BM_thumpy_log_filtered )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+
+#pragma endregion Front end
+
+#pragma region Helpers
+
+static void BM_format_message( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  std::string message = "Benchmark message to format";
+  for ( auto _ : state ) {
+    recorder.measure( [&message] {
+      benchmark::DoNotOptimize( Logger::format_message( &message, ACCEPTED_LEVEL ) );
+    } );
+  }
+}
+BENCHMARK( BM_format_message )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+
+static void BM_format_message_view( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  for ( auto _ : state ) {
+    recorder.measure( [] {
+      benchmark::DoNotOptimize( Logger::format_message_view(
+          "Benchmark message to format", ACCEPTED_LEVEL, std::chrono::system_clock::now() ) );
+    } );
+  }
+}
+BENCHMARK( BM_format_message_view )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+
+static void BM_get_time_as_string( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  for ( auto _ : state ) {
+    recorder.measure( [] { benchmark::DoNotOptimize( Logger::get_time_as_string() ); } );
+  }
+}
+BENCHMARK( BM_get_time_as_string )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+
+#pragma endregion Helpers
+
+#pragma region Sinks
+
+/**
+ * @brief Submit records to a sink, serialized the same way the sink registry does
+ *
+ * @param state
+ * @param sink
+ */
+static void run_sink( benchmark::State &state, Logger::Sink *sink ) {
+  static std::mutex sinkMutex;
+  Logger::LogRecord record;
+  record.level = ACCEPTED_LEVEL;
+  record.set_message( "Benchmark message written to a sink" );
+
+  LatencyRecorder recorder( state );
+  for ( auto _ : state ) {
+    recorder.measure( [&] {
+      record.time = std::chrono::system_clock::now();
+      std::lock_guard<std::mutex> lock( sinkMutex );
+      std::string_view line = sink->uses_text() ? Logger::format_message_view(
+                                                      record.message(), record.level, record.time )
+                                                : std::string_view();
+      sink->submit( record, line );
+    } );
+  }
+}
+
+static void BM_file_sink( benchmark::State &state ) { run_sink( state, &fileSink ); }
+BENCHMARK( BM_file_sink )
+    ->Setup( open_file_sink )
+    ->Teardown( close_file_sink )
+    ->Threads( 1 )
+    ->Threads( 4 )
+    ->Threads( 16 )
+    ->UseRealTime();
+
+static void BM_terminal_sink( benchmark::State &state ) {
+  static Logger::TerminalSink sink( Logger::ALL, 256 );
+  run_sink( state, &sink );
+}
+BENCHMARK( BM_terminal_sink )
+    ->Setup( capture_terminal )
+    ->Teardown( release_terminal )
+    ->Threads( 1 )
+    ->Threads( 4 )
+    ->Threads( 16 )
+    ->UseRealTime();
+
+static void BM_ring_sink( benchmark::State &state ) {
+  static Logger::RingSink sink( 4096, "" );
+  run_sink( state, &sink );
+}
+BENCHMARK( BM_ring_sink )->Threads( 1 )->Threads( 4 )->Threads( 16 )->UseRealTime();
+
+static void BM_binary_sink( benchmark::State &state ) {
+  LatencyRecorder recorder( state );
+  int frame = 0;
+  for ( auto _ : state ) {
+    recorder.measure( [&frame] {
+      THUMPY_BLOG( ACCEPTED_LEVEL, "Frame {} took {} ms", frame++, 16.6 );
+    } );
+  }
+  if ( state.thread_index() == 0 ) {
+    state.counters["dropped"] = static_cast<double>( Logger::binary_dropped_count() );
+  }
+}
+BENCHMARK( BM_binary_sink )
+    ->Setup( open_binary_log )
+    ->Teardown( close_binary_log )
+    ->Threads( 1 )
+    ->Threads( 4 )
+    ->Threads( 16 )
+    ->UseRealTime();
+
+#pragma endregion Sinks
+
+}  // namespace Core
+}  // namespace Thumpy
+
+int main( int argc, char **argv ) {
+  // File sink takes everything but DEBUG, keep the terminal quiet
+  Thumpy::Core::Logger::init();
+  Thumpy::Core::Logger::set_term_log_vision( Thumpy::Core::Logger::NONE );
+  Thumpy::Core::Logger::set_file_log_vision( Thumpy::Core::Logger::ALL &
+                                             ~Thumpy::Core::FILTERED_LEVEL );
+
+  benchmark::Initialize( &argc, argv );
+  if ( benchmark::ReportUnrecognizedArguments( argc, argv ) ) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  Thumpy::Core::Logger::close_logger();
+  return 0;
+}
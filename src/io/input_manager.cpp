@@ -1,5 +1,6 @@
 
 
+#include "flight_recorder.hpp"
 #include "logger.hpp"
 #include <input_manager.hpp>
 #include <signal.h>
@@ -17,6 +18,8 @@ void init() { (void)signal(SIGINT, finish); }
 #pragma region Signal Handling
 
 static void finish(int sig) {
+  // Post-mortem data first, only uses async-signal-safe calls
+  Thumpy::Core::Logger::dump_flight_recorder();
 
   // Shutdown
   Thumpy::Core::Logger::log("Shuting down by exit signal...",
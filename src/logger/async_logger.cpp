@@ -0,0 +1,304 @@
+/**
+ * @file async_logger.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief async_logger cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "async_logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "logger.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+#pragma region Record queue
+
+static size_t round_up_to_power_of_two( size_t value ) {
+  size_t result = 2;
+  while ( result < value ) {
+    result <<= 1;
+  }
+  return result;
+}
+
+RecordQueue::RecordQueue( size_t capacity ) {
+  size_t size = round_up_to_power_of_two( capacity );
+  cells_ = std::make_unique<Cell[]>( size );
+  mask_ = size - 1;
+  for ( size_t i = 0; i < size; i++ ) {
+    cells_[i].sequence.store( i, std::memory_order_relaxed );
+  }
+  enqueuePos_.store( 0, std::memory_order_relaxed );
+  dequeuePos_.store( 0, std::memory_order_relaxed );
+}
+
+bool RecordQueue::try_push( LogRecord &record ) {
+  Cell *cell;
+  size_t pos = enqueuePos_.load( std::memory_order_relaxed );
+  for ( ;; ) {
+    cell = &cells_[pos & mask_];
+    size_t sequence = cell->sequence.load( std::memory_order_acquire );
+    intptr_t difference = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( pos );
+    if ( difference == 0 ) {
+      // Cell is free, claim it
+      if ( enqueuePos_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+        break;
+      }
+    } else if ( difference < 0 ) {
+      // Queue is full
+      return false;
+    } else {
+      // Another producer claimed this cell
+      pos = enqueuePos_.load( std::memory_order_relaxed );
+    }
+  }
+
+  cell->record = std::move( record );
+  cell->sequence.store( pos + 1, std::memory_order_release );
+  return true;
+}
+
+bool RecordQueue::try_pop( LogRecord &record ) {
+  size_t pos = dequeuePos_.load( std::memory_order_relaxed );
+  Cell *cell = &cells_[pos & mask_];
+  size_t sequence = cell->sequence.load( std::memory_order_acquire );
+  if ( static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( pos + 1 ) < 0 ) {
+    // Nothing published yet
+    return false;
+  }
+
+  dequeuePos_.store( pos + 1, std::memory_order_relaxed );
+  record = std::move( cell->record );
+  cell->sequence.store( pos + mask_ + 1, std::memory_order_release );
+  return true;
+}
+
+bool RecordQueue::empty() const {
+  size_t pos = dequeuePos_.load( std::memory_order_relaxed );
+  size_t sequence = cells_[pos & mask_].sequence.load( std::memory_order_acquire );
+  return static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( pos + 1 ) < 0;
+}
+
+#pragma endregion Record queue
+
+#pragma region Writer thread
+
+namespace {
+
+std::unique_ptr<RecordQueue> queue;
+AsyncOptions activeOptions;
+std::thread writer;
+std::atomic<std::thread::id> writerId;
+// Producers may push while running, the writer exits once stopping & the queue is empty
+std::atomic<bool> running{ false };
+std::atomic<bool> stopping{ false };
+// Producers between their running check & their push, stop_async waits for them
+std::atomic<uint32_t> activeProducers{ 0 };
+
+// Wake up the writer when it is idle
+std::mutex wakeMutex;
+std::condition_variable wakeCondition;
+std::atomic<bool> writerIdle{ false };
+
+// Track progress for flush_async
+std::atomic<uint64_t> pushedCount{ 0 };
+std::atomic<uint64_t> writtenCount{ 0 };
+std::mutex drainedMutex;
+std::condition_variable drainedCondition;
+
+std::atomic<uint64_t> droppedCount{ 0 };
+uint64_t reportedDropCount = 0;
+
+void wake_writer() {
+  if ( writerIdle.load() ) {
+    std::lock_guard<std::mutex> lock( wakeMutex );
+    wakeCondition.notify_one();
+  }
+}
+
+void report_dropped_records() {
+  uint64_t dropped = droppedCount.load( std::memory_order_relaxed );
+  if ( dropped == reportedDropCount ) {
+    return;
+  }
+
+  LogRecord record;
+  record.time = std::chrono::system_clock::now();
+  record.level = WARNING;
+  record.set_message( "Async logger dropped " + std::to_string( dropped - reportedDropCount ) +
+                      " records, queue is full." );
+  reportedDropCount = dropped;
+  write_record( record );
+}
+
+void writer_loop() {
+  writerId.store( std::this_thread::get_id() );
+  LogRecord record;
+  while ( true ) {
+    size_t written = 0;
+    while ( written < activeOptions.batchSize && queue->try_pop( record ) ) {
+      write_record( record );
+      written++;
+    }
+
+    if ( written > 0 ) {
+      if ( activeOptions.overflow == DROP_AND_COUNT ) {
+        report_dropped_records();
+      }
+      flush_sinks();
+      writtenCount.fetch_add( written );
+      std::lock_guard<std::mutex> lock( drainedMutex );
+      drainedCondition.notify_all();
+      continue;
+    }
+
+    // Queue is empty, stop once asked to and everything has been written
+    if ( stopping.load() ) {
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock( wakeMutex );
+    writerIdle.store( true );
+    if ( queue->empty() && !stopping.load() ) {
+      // Timeout covers a producer that pushed between the empty check and the idle flag
+      wakeCondition.wait_for( lock, std::chrono::milliseconds( 5 ) );
+    }
+    writerIdle.store( false );
+  }
+}
+
+}  // namespace
+
+void start_async( const AsyncOptions &options ) {
+  if ( running.load() ) {
+    return;
+  }
+
+  activeOptions = options;
+  if ( activeOptions.batchSize == 0 ) {
+    activeOptions.batchSize = 1;
+  }
+  queue = std::make_unique<RecordQueue>( activeOptions.capacity );
+  pushedCount.store( 0 );
+  writtenCount.store( 0 );
+  droppedCount.store( 0 );
+  reportedDropCount = 0;
+
+  stopping.store( false );
+  running.store( true );
+  writer = std::thread( writer_loop );
+}
+
+void stop_async() {
+  if ( !running.exchange( false ) ) {
+    return;
+  }
+
+  // New records are written by their producers now, the writer keeps draining for the ones
+  // that saw running before it was cleared
+  while ( activeProducers.load() != 0 ) {
+    wake_writer();
+    std::this_thread::yield();
+  }
+
+  stopping.store( true );
+  {
+    std::lock_guard<std::mutex> lock( wakeMutex );
+    wakeCondition.notify_one();
+  }
+  writer.join();
+
+  // Nothing pushes any more, write whatever the writer left behind before the queue goes away
+  LogRecord record;
+  uint64_t written = 0;
+  while ( queue->try_pop( record ) ) {
+    write_record( record );
+    written++;
+  }
+  if ( activeOptions.overflow == DROP_AND_COUNT ) {
+    report_dropped_records();
+  }
+  flush_sinks();
+  if ( written > 0 ) {
+    writtenCount.fetch_add( written );
+    std::lock_guard<std::mutex> lock( drainedMutex );
+    drainedCondition.notify_all();
+  }
+
+  queue.reset();
+  writerId.store( std::thread::id() );
+}
+
+bool is_async() { return running.load(); }
+
+bool push_record( LogRecord &record ) {
+  // The writer thread logging about itself writes directly instead of waiting on its own queue
+  if ( std::this_thread::get_id() == writerId.load() ) {
+    return false;
+  }
+
+  // Registered before checking running, so stop_async can't take the queue away mid push
+  activeProducers.fetch_add( 1 );
+  if ( !is_async() ) {
+    activeProducers.fetch_sub( 1 );
+    return false;
+  }
+
+  while ( !queue->try_push( record ) ) {
+    switch ( activeOptions.overflow ) {
+      case DROP_AND_COUNT:
+        droppedCount.fetch_add( 1, std::memory_order_relaxed );
+        [[fallthrough]];
+      case DROP:
+        activeProducers.fetch_sub( 1 );
+        return true;
+      case BLOCK:
+      default:
+        wake_writer();
+        std::this_thread::yield();
+        break;
+    }
+  }
+
+  pushedCount.fetch_add( 1 );
+  wake_writer();
+  activeProducers.fetch_sub( 1 );
+  return true;
+}
+
+void flush_async() {
+  if ( !is_async() || std::this_thread::get_id() == writerId.load() ) {
+    return;
+  }
+
+  uint64_t target = pushedCount.load();
+  {
+    std::lock_guard<std::mutex> lock( wakeMutex );
+    wakeCondition.notify_one();
+  }
+
+  std::unique_lock<std::mutex> lock( drainedMutex );
+  drainedCondition.wait( lock, [target] { return writtenCount.load() >= target; } );
+}
+
+uint64_t dropped_record_count() { return droppedCount.load( std::memory_order_relaxed ); }
+
+#pragma endregion Writer thread
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
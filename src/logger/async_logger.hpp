@@ -0,0 +1,126 @@
+/**
+ * @file async_logger.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Background log writer fed by a bounded multi-producer ring buffer
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "log_record.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+/**
+ * @brief What a producer does when the ring buffer is full
+ *
+ */
+enum OverflowPolicy {
+  BLOCK,          // Wait for the writer thread to make room
+  DROP,           // Silently discard the record
+  DROP_AND_COUNT  // Discard the record and report the count from the writer thread
+};
+
+struct AsyncOptions {
+  size_t capacity = 8192;  // Rounded up to a power of two
+  size_t batchSize = 256;  // Records written between flushes
+  OverflowPolicy overflow = BLOCK;
+};
+
+/**
+ * @brief Bounded lock-free queue, many producers / one consumer.
+ * Each cell carries a sequence number so producers only contend on the enqueue index.
+ */
+class RecordQueue {
+ public:
+  explicit RecordQueue( size_t capacity );
+
+  /**
+   * @brief Try to push a record, fails when the queue is full
+   *
+   * @param record moved from on success
+   * @return true if the record was queued
+   */
+  bool try_push( LogRecord &record );
+
+  /**
+   * @brief Try to pop a record, only called from the writer thread
+   *
+   * @param record
+   * @return true if a record was popped
+   */
+  bool try_pop( LogRecord &record );
+
+  bool empty() const;
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    LogRecord record;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+
+  alignas( 64 ) std::atomic<size_t> enqueuePos_;
+  alignas( 64 ) std::atomic<size_t> dequeuePos_;
+};
+
+/**
+ * @brief Start the writer thread, Logger::log pushes records from now on
+ *
+ * @param options
+ */
+void start_async( const AsyncOptions &options = AsyncOptions() );
+
+/**
+ * @brief Drain every queued record and join the writer thread. Safe while other threads log,
+ * records pushed before it returns are written, later ones are written by their producers
+ */
+void stop_async();
+
+/**
+ * @brief Check if the writer thread is running
+ *
+ * @return true when records are queued instead of written
+ */
+bool is_async();
+
+/**
+ * @brief Queue a record for the writer thread
+ *
+ * @param record
+ * @return true if the writer took the record (queued or dropped by the overflow policy),
+ * false if the caller has to write it itself
+ */
+bool push_record( LogRecord &record );
+
+/**
+ * @brief Block until every record queued before this call has been written
+ *
+ */
+void flush_async();
+
+/**
+ * @brief Records dropped by the DROP_AND_COUNT policy since start_async
+ *
+ * @return uint64_t
+ */
+uint64_t dropped_record_count();
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
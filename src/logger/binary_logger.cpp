@@ -0,0 +1,428 @@
+/**
+ * @file binary_logger.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief binary_logger cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "binary_logger.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined( _WIN32 )
+#include <windows.h>
+#endif
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+std::atomic<int> binary_log_levels{ NONE };
+
+#pragma region Mapping
+
+namespace {
+
+// Published once the header is written, cleared before unmapping
+std::atomic<char *> mappedData{ nullptr };
+size_t mappedCapacity = 0;
+std::atomic<size_t> writeOffset{ 0 };
+// Writers between reserve_binary_entry & commit_binary_entry, close waits for them
+std::atomic<uint32_t> activeWriters{ 0 };
+std::atomic<uint64_t> droppedCount{ 0 };
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+int fileDescriptor = -1;
+#elif defined( _WIN32 )
+HANDLE fileHandle = INVALID_HANDLE_VALUE;
+HANDLE mappingHandle = NULL;
+#endif
+
+// Registered formats, guarded by formatMutex
+std::mutex formatMutex;
+std::vector<std::string> formats;
+
+size_t align_entry( size_t size ) {
+  return ( size + Binary::ENTRY_ALIGNMENT - 1 ) & ~( Binary::ENTRY_ALIGNMENT - 1 );
+}
+
+bool map_file( const std::string &path, size_t capacity, char **mapped ) {
+#if defined( __unix__ ) || defined( __APPLE__ )
+  fileDescriptor = ::open( path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+  if ( fileDescriptor < 0 ) {
+    return false;
+  }
+  if ( ::ftruncate( fileDescriptor, static_cast<off_t>( capacity ) ) != 0 ) {
+    ::close( fileDescriptor );
+    fileDescriptor = -1;
+    return false;
+  }
+  void *data = ::mmap( nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0 );
+  if ( data == MAP_FAILED ) {
+    ::close( fileDescriptor );
+    fileDescriptor = -1;
+    return false;
+  }
+  *mapped = static_cast<char *>( data );
+  return true;
+#elif defined( _WIN32 )
+  fileHandle = CreateFileA( path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+  if ( fileHandle == INVALID_HANDLE_VALUE ) {
+    return false;
+  }
+  ULARGE_INTEGER size;
+  size.QuadPart = capacity;
+  mappingHandle =
+      CreateFileMappingA( fileHandle, NULL, PAGE_READWRITE, size.HighPart, size.LowPart, NULL );
+  if ( mappingHandle == NULL ) {
+    CloseHandle( fileHandle );
+    fileHandle = INVALID_HANDLE_VALUE;
+    return false;
+  }
+  *mapped = static_cast<char *>( MapViewOfFile( mappingHandle, FILE_MAP_WRITE, 0, 0, 0 ) );
+  if ( *mapped == nullptr ) {
+    CloseHandle( mappingHandle );
+    CloseHandle( fileHandle );
+    mappingHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void unmap_file( char *mapped, size_t used ) {
+#if defined( __unix__ ) || defined( __APPLE__ )
+  ::msync( mapped, mappedCapacity, MS_SYNC );
+  ::munmap( mapped, mappedCapacity );
+  // Drop the unused tail so the file is only as big as the log
+  if ( ::ftruncate( fileDescriptor, static_cast<off_t>( used ) ) != 0 ) {
+    // Keeping the zero filled tail is harmless, the decoder stops at it
+  }
+  ::close( fileDescriptor );
+  fileDescriptor = -1;
+#elif defined( _WIN32 )
+  FlushViewOfFile( mapped, 0 );
+  UnmapViewOfFile( mapped );
+  CloseHandle( mappingHandle );
+  mappingHandle = NULL;
+  LARGE_INTEGER end;
+  end.QuadPart = static_cast<LONGLONG>( used );
+  SetFilePointerEx( fileHandle, end, NULL, FILE_BEGIN );
+  SetEndOfFile( fileHandle );
+  CloseHandle( fileHandle );
+  fileHandle = INVALID_HANDLE_VALUE;
+#endif
+}
+
+void write_format_entry( uint32_t id, std::string_view format ) {
+  char *payload = reserve_binary_entry( sizeof( id ) + format.size() );
+  if ( payload == nullptr ) {
+    return;
+  }
+  std::memcpy( payload, &id, sizeof( id ) );
+  std::memcpy( payload + sizeof( id ), format.data(), format.size() );
+  commit_binary_entry( payload, sizeof( id ) + format.size(), Binary::FORMAT_ENTRY, NONE );
+}
+
+}  // namespace
+
+bool open_binary_log( const std::string &path, size_t capacity, int levels ) {
+  close_binary_log();
+
+  capacity = align_entry( capacity < sizeof( Binary::FileHeader ) ? 4096 : capacity );
+  char *mapped;
+  if ( !map_file( path, capacity, &mapped ) ) {
+    log( "Binary log failed to open.", ERROR_LOG );
+    return false;
+  }
+  mappedCapacity = capacity;
+
+  Binary::FileHeader header;
+  std::memcpy( header.magic, Binary::FILE_MAGIC, sizeof( header.magic ) );
+  header.version = Binary::FILE_VERSION;
+  header.headerSize = sizeof( Binary::FileHeader );
+  std::memcpy( mapped, &header, sizeof( header ) );
+  writeOffset.store( align_entry( sizeof( header ) ) );
+  droppedCount.store( 0 );
+  mappedData.store( mapped );
+
+  // Formats registered before the log was opened still need to be in the file
+  std::lock_guard<std::mutex> lock( formatMutex );
+  for ( size_t i = 0; i < formats.size(); i++ ) {
+    write_format_entry( static_cast<uint32_t>( i ), formats[i] );
+  }
+  binary_log_levels.store( levels );
+  return true;
+}
+
+void close_binary_log() {
+  std::lock_guard<std::mutex> lock( formatMutex );
+  char *mapped = mappedData.exchange( nullptr );
+  if ( mapped == nullptr ) {
+    return;
+  }
+  binary_log_levels.store( NONE );
+
+  // New entries are dropped now, let the ones being written finish before the memory goes away
+  while ( activeWriters.load() != 0 ) {
+    std::this_thread::yield();
+  }
+
+  size_t used = writeOffset.load();
+  if ( used > mappedCapacity ) {
+    used = mappedCapacity;
+  }
+  unmap_file( mapped, used );
+  mappedCapacity = 0;
+}
+
+uint64_t binary_dropped_count() { return droppedCount.load( std::memory_order_relaxed ); }
+
+uint32_t register_format( std::string_view format ) {
+  std::lock_guard<std::mutex> lock( formatMutex );
+  uint32_t id = static_cast<uint32_t>( formats.size() );
+  formats.emplace_back( format );
+  if ( mappedData.load() != nullptr ) {
+    write_format_entry( id, format );
+  }
+  return id;
+}
+
+char *reserve_binary_entry( size_t size ) {
+  // Registered before loading the mapping, so close_binary_log waits for this entry
+  activeWriters.fetch_add( 1 );
+  char *mapped = mappedData.load();
+  if ( mapped == nullptr ) {
+    activeWriters.fetch_sub( 1, std::memory_order_release );
+    droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    return nullptr;
+  }
+
+  size_t entrySize = align_entry( sizeof( Binary::EntryHeader ) + size );
+  size_t offset = writeOffset.fetch_add( entrySize, std::memory_order_relaxed );
+  if ( offset + entrySize > mappedCapacity ) {
+    activeWriters.fetch_sub( 1, std::memory_order_release );
+    droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    return nullptr;
+  }
+
+  return mapped + offset + sizeof( Binary::EntryHeader );
+}
+
+void commit_binary_entry( char *payload, size_t size, Binary::EntryKind kind, LogLevel level ) {
+  Binary::EntryHeader *header =
+      reinterpret_cast<Binary::EntryHeader *>( payload - sizeof( Binary::EntryHeader ) );
+  header->kind = kind;
+  header->level = static_cast<uint16_t>( level );
+  uint32_t entrySize = static_cast<uint32_t>( align_entry( sizeof( Binary::EntryHeader ) + size ) );
+  std::atomic_ref<uint32_t>( header->size ).store( entrySize, std::memory_order_release );
+  activeWriters.fetch_sub( 1, std::memory_order_release );
+}
+
+#pragma endregion Mapping
+
+#pragma region Decoding
+
+namespace {
+
+template <typename T>
+bool read_value( const char *&in, const char *end, T *value ) {
+  if ( static_cast<size_t>( end - in ) < sizeof( T ) ) {
+    return false;
+  }
+  std::memcpy( value, in, sizeof( T ) );
+  in += sizeof( T );
+  return true;
+}
+
+template <typename T>
+void append_number( std::string *text, T value, int base = 10 ) {
+  char number[64];
+  std::to_chars_result result;
+  if constexpr ( std::is_floating_point_v<T> ) {
+    result = std::to_chars( number, number + sizeof( number ), value );
+  } else {
+    result = std::to_chars( number, number + sizeof( number ), value, base );
+  }
+  text->append( number, result.ptr - number );
+}
+
+bool decode_argument( const char *&in, const char *end, std::string *text ) {
+  uint8_t type;
+  if ( !read_value( in, end, &type ) ) {
+    return false;
+  }
+
+  switch ( type ) {
+    case Binary::INT_ARGUMENT: {
+      int64_t value;
+      if ( !read_value( in, end, &value ) ) return false;
+      append_number( text, value );
+      return true;
+    }
+    case Binary::UINT_ARGUMENT: {
+      uint64_t value;
+      if ( !read_value( in, end, &value ) ) return false;
+      append_number( text, value );
+      return true;
+    }
+    case Binary::FLOAT_ARGUMENT: {
+      double value;
+      if ( !read_value( in, end, &value ) ) return false;
+      append_number( text, value );
+      return true;
+    }
+    case Binary::BOOL_ARGUMENT: {
+      uint8_t value;
+      if ( !read_value( in, end, &value ) ) return false;
+      text->append( value ? "true" : "false" );
+      return true;
+    }
+    case Binary::CHAR_ARGUMENT: {
+      char value;
+      if ( !read_value( in, end, &value ) ) return false;
+      text->push_back( value );
+      return true;
+    }
+    case Binary::STRING_ARGUMENT: {
+      uint32_t length;
+      if ( !read_value( in, end, &length ) || static_cast<size_t>( end - in ) < length ) {
+        return false;
+      }
+      text->append( in, length );
+      in += length;
+      return true;
+    }
+    case Binary::POINTER_ARGUMENT: {
+      uint64_t value;
+      if ( !read_value( in, end, &value ) ) return false;
+      text->append( "0x" );
+      append_number( text, value, 16 );
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+size_t decode_binary_log( const std::string &path, std::ostream &out, bool *valid ) {
+  if ( valid != nullptr ) {
+    *valid = false;
+  }
+
+  std::ifstream file( path, std::ios::in | std::ios::binary );
+  if ( !file.is_open() ) {
+    log( "Failed to open binary log: " + path, ERROR_LOG );
+    return 0;
+  }
+  std::vector<char> data( ( std::istreambuf_iterator<char>( file ) ),
+                          std::istreambuf_iterator<char>() );
+
+  Binary::FileHeader header;
+  if ( data.size() < sizeof( header ) ) {
+    log( "Binary log is too small: " + path, ERROR_LOG );
+    return 0;
+  }
+  std::memcpy( &header, data.data(), sizeof( header ) );
+  if ( std::memcmp( header.magic, Binary::FILE_MAGIC, sizeof( header.magic ) ) != 0 ||
+       header.version != Binary::FILE_VERSION ) {
+    log( "Not a binary log: " + path, ERROR_LOG );
+    return 0;
+  }
+  if ( valid != nullptr ) {
+    *valid = true;
+  }
+
+  std::unordered_map<uint32_t, std::string> formatTable;
+  std::string message;
+  size_t decoded = 0;
+  size_t offset = align_entry( header.headerSize );
+  while ( offset + sizeof( Binary::EntryHeader ) <= data.size() ) {
+    Binary::EntryHeader entry;
+    std::memcpy( &entry, data.data() + offset, sizeof( entry ) );
+    // A zero size is the end of the log, or an entry that was never committed
+    if ( entry.size < sizeof( entry ) || offset + entry.size > data.size() ) {
+      break;
+    }
+    const char *in = data.data() + offset + sizeof( entry );
+    const char *end = data.data() + offset + entry.size;
+    offset += entry.size;
+
+    if ( entry.kind == Binary::FORMAT_ENTRY ) {
+      uint32_t id;
+      if ( read_value( in, end, &id ) ) {
+        // Trailing padding is zero filled
+        std::string_view format( in, end - in );
+        formatTable[id] = std::string( format.substr( 0, format.find( '\0' ) ) );
+      }
+      continue;
+    }
+    if ( entry.kind != Binary::RECORD_ENTRY ) {
+      continue;
+    }
+
+    Binary::RecordHeader record;
+    if ( !read_value( in, end, &record ) ) {
+      continue;
+    }
+    auto format = formatTable.find( record.formatId );
+    std::string_view remaining =
+        format != formatTable.end() ? std::string_view( format->second ) : "{unknown format}";
+
+    // Replace each {} with the next argument, extra arguments are appended
+    message.clear();
+    for ( uint32_t i = 0; i < record.argumentCount; i++ ) {
+      size_t placeholder = remaining.find( "{}" );
+      if ( placeholder == std::string_view::npos ) {
+        message.append( remaining );
+        message.push_back( ' ' );
+        remaining = std::string_view();
+      } else {
+        message.append( remaining.substr( 0, placeholder ) );
+        remaining.remove_prefix( placeholder + 2 );
+      }
+      if ( !decode_argument( in, end, &message ) ) {
+        message.append( "{corrupt}" );
+        break;
+      }
+    }
+    message.append( remaining );
+
+    std::chrono::system_clock::time_point time{ std::chrono::duration_cast<
+        std::chrono::system_clock::duration>( std::chrono::nanoseconds( record.timeNanoseconds ) ) };
+    out << format_message_view( message, static_cast<LogLevel>( entry.level ), time ) << '\n';
+    decoded++;
+  }
+  return decoded;
+}
+
+#pragma endregion Decoding
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,265 @@
+/**
+ * @file binary_logger.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Binary log sink, writes a format id plus raw argument bytes into a memory mapped file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "logger.hpp"
+#include "logger_helper.hpp"
+
+/**
+ * @brief Log to the binary sink, format is a string literal with {} placeholders.
+ * The format string is registered once per call site, each call only copies the arguments.
+ * e.g. THUMPY_BLOG( Logger::DEBUG, "Frame {} took {} ms", frame, milliseconds );
+ */
+#define THUMPY_BLOG( level, format, ... )                                                       \
+  do {                                                                                          \
+    if constexpr ( ::Thumpy::Core::Logger::is_compiled_in( level ) ) {                          \
+      if ( ::Thumpy::Core::Logger::is_binary_level_accepted( level ) ) {                        \
+        static const uint32_t thumpyFormatId = ::Thumpy::Core::Logger::register_format( format ); \
+        ::Thumpy::Core::Logger::binary_log( thumpyFormatId, level __VA_OPT__(, ) __VA_ARGS__ ); \
+      }                                                                                         \
+    }                                                                                           \
+  } while ( 0 )
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+namespace Binary {
+
+const char FILE_MAGIC[8] = { 'T', 'H', 'M', 'P', 'B', 'L', 'O', 'G' };
+const uint32_t FILE_VERSION = 1;
+
+// Entries are padded so every entry header is aligned
+const size_t ENTRY_ALIGNMENT = 8;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+};
+
+enum EntryKind : uint16_t {
+  FORMAT_ENTRY = 1,  // uint32 id followed by the format string
+  RECORD_ENTRY = 2   // RecordHeader followed by encoded arguments
+};
+
+/**
+ * @brief Starts every entry, size is published last so readers stop at a half written entry
+ *
+ */
+struct EntryHeader {
+  uint32_t size;  // Including this header and padding, 0 marks the end of the log
+  uint16_t kind;
+  uint16_t level;
+};
+
+struct RecordHeader {
+  uint32_t formatId;
+  uint32_t argumentCount;
+  int64_t timeNanoseconds;  // Since the system_clock epoch
+};
+
+enum ArgumentType : uint8_t {
+  INT_ARGUMENT = 1,     // int64
+  UINT_ARGUMENT = 2,    // uint64
+  FLOAT_ARGUMENT = 3,   // double
+  BOOL_ARGUMENT = 4,    // uint8
+  CHAR_ARGUMENT = 5,    // char
+  STRING_ARGUMENT = 6,  // uint32 length followed by the bytes
+  POINTER_ARGUMENT = 7  // uint64
+};
+
+/**
+ * @brief Bytes an argument takes in a record
+ *
+ * @param value
+ * @return size_t
+ */
+template <typename T>
+size_t encoded_size( const T &value ) {
+  if constexpr ( std::is_same_v<T, bool> || std::is_same_v<T, char> ) {
+    return 1 + 1;
+  } else if constexpr ( std::is_arithmetic_v<T> || std::is_enum_v<T> ) {
+    return 1 + 8;
+  } else if constexpr ( std::is_convertible_v<const T &, std::string_view> ) {
+    return 1 + sizeof( uint32_t ) + std::string_view( value ).size();
+  } else if constexpr ( std::is_pointer_v<T> ) {
+    return 1 + 8;
+  } else {
+    static_assert( sizeof( T ) == 0, "THUMPY_BLOG argument type is not supported" );
+  }
+}
+
+/**
+ * @brief Copy an argument into a record
+ *
+ * @param out advanced past the argument
+ * @param value
+ */
+template <typename T>
+void encode( char *&out, const T &value ) {
+  auto put = [&out]( ArgumentType type, const void *data, size_t size ) {
+    *out++ = static_cast<char>( type );
+    std::memcpy( out, data, size );
+    out += size;
+  };
+
+  if constexpr ( std::is_same_v<T, bool> ) {
+    uint8_t raw = value ? 1 : 0;
+    put( BOOL_ARGUMENT, &raw, 1 );
+  } else if constexpr ( std::is_same_v<T, char> ) {
+    put( CHAR_ARGUMENT, &value, 1 );
+  } else if constexpr ( std::is_floating_point_v<T> ) {
+    double raw = static_cast<double>( value );
+    put( FLOAT_ARGUMENT, &raw, 8 );
+  } else if constexpr ( std::is_enum_v<T> ) {
+    int64_t raw = static_cast<int64_t>( value );
+    put( INT_ARGUMENT, &raw, 8 );
+  } else if constexpr ( std::is_integral_v<T> && std::is_signed_v<T> ) {
+    int64_t raw = value;
+    put( INT_ARGUMENT, &raw, 8 );
+  } else if constexpr ( std::is_integral_v<T> ) {
+    uint64_t raw = value;
+    put( UINT_ARGUMENT, &raw, 8 );
+  } else if constexpr ( std::is_convertible_v<const T &, std::string_view> ) {
+    std::string_view text( value );
+    uint32_t length = static_cast<uint32_t>( text.size() );
+    put( STRING_ARGUMENT, &length, sizeof( length ) );
+    std::memcpy( out, text.data(), text.size() );
+    out += text.size();
+  } else if constexpr ( std::is_pointer_v<T> ) {
+    uint64_t raw = reinterpret_cast<uintptr_t>( value );
+    put( POINTER_ARGUMENT, &raw, 8 );
+  }
+}
+
+}  // namespace Binary
+
+/**
+ * @brief Levels the binary sink accepts, 0 while no binary log is open
+ *
+ */
+extern std::atomic<int> binary_log_levels;
+
+/**
+ * @brief Check if the binary sink will take level
+ *
+ * @param level
+ * @return bool
+ */
+inline bool is_binary_level_accepted( LogLevel level ) {
+  return ( level & binary_log_levels.load( std::memory_order_relaxed ) ) != 0;
+}
+
+/**
+ * @brief Create / truncate a binary log and map it into memory
+ *
+ * @param path
+ * @param capacity bytes reserved for the log, records past this are dropped
+ * @param levels LogLevel mask written to the binary log
+ * @return true if the log was opened
+ */
+bool open_binary_log( const std::string &path, size_t capacity = 64 * 1024 * 1024,
+                      int levels = ALL );
+
+/**
+ * @brief Unmap the binary log and trim it to the bytes written.
+ * Waits for entries being written by other threads, later ones are dropped
+ */
+void close_binary_log();
+
+/**
+ * @brief Records dropped because the binary log was full
+ *
+ * @return uint64_t
+ */
+uint64_t binary_dropped_count();
+
+/**
+ * @brief Register a format string, the id is stable for the run
+ * Also writes the format into the open binary log so the decoder can find it.
+ * @param format
+ * @return uint32_t id
+ */
+uint32_t register_format( std::string_view format );
+
+/**
+ * @brief Reserve an entry in the mapped log
+ *
+ * @param size payload bytes after the entry header
+ * @return char* payload, nullptr when the log is full or closed. Has to be committed, closing
+ * the log waits for it
+ */
+char *reserve_binary_entry( size_t size );
+
+/**
+ * @brief Publish an entry reserved with reserve_binary_entry
+ *
+ * @param payload
+ * @param size same size passed to reserve_binary_entry
+ * @param kind
+ * @param level
+ */
+void commit_binary_entry( char *payload, size_t size, Binary::EntryKind kind, LogLevel level );
+
+/**
+ * @brief Write a record to the binary log, used by THUMPY_BLOG
+ *
+ * @param formatId from register_format
+ * @param level
+ * @param arguments
+ */
+template <typename... Arguments>
+void binary_log( uint32_t formatId, LogLevel level, const Arguments &...arguments ) {
+  size_t size = sizeof( Binary::RecordHeader ) + ( size_t( 0 ) + ... +
+                                                   Binary::encoded_size( arguments ) );
+  char *payload = reserve_binary_entry( size );
+  if ( payload == nullptr ) {
+    return;
+  }
+
+  Binary::RecordHeader header;
+  header.formatId = formatId;
+  header.argumentCount = sizeof...( Arguments );
+  header.timeNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch() )
+                               .count();
+  std::memcpy( payload, &header, sizeof( header ) );
+
+  char *out = payload + sizeof( header );
+  ( Binary::encode( out, arguments ), ... );
+  commit_binary_entry( payload, size, Binary::RECORD_ENTRY, level );
+}
+
+/**
+ * @brief Turn a binary log back into text lines
+ * [LOG_LEVEL] [DAY-MONTH-YEAR HOUR:MIN:SECOND.FRACTION]: MESSAGE
+ * @param path
+ * @param out
+ * @param valid set to false when the file can't be read or isn't a binary log
+ * @return size_t records decoded
+ */
+size_t decode_binary_log( const std::string &path, std::ostream &out, bool *valid = nullptr );
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
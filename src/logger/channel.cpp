@@ -0,0 +1,173 @@
+/**
+ * @file channel.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief channel cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "channel.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+namespace {
+
+// Deque so channel references survive new channels being added
+std::mutex &channel_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::deque<Channel> &channels() {
+  static std::deque<Channel> registry;
+  return registry;
+}
+
+std::thread watcher;
+std::mutex watcherMutex;
+std::condition_variable watcherCondition;
+bool watcherRunning = false;
+
+std::string_view trim( std::string_view text ) {
+  size_t first = text.find_first_not_of( " \t\r" );
+  if ( first == std::string_view::npos ) {
+    return std::string_view();
+  }
+  size_t last = text.find_last_not_of( " \t\r" );
+  return text.substr( first, last - first + 1 );
+}
+
+void watch_loop( std::string path, std::chrono::milliseconds interval ) {
+  std::filesystem::file_time_type lastWrite{};
+  std::unique_lock<std::mutex> lock( watcherMutex );
+  while ( watcherRunning ) {
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time( path, error );
+    if ( !error && writeTime != lastWrite ) {
+      lastWrite = writeTime;
+      lock.unlock();
+      load_channel_config( path );
+      lock.lock();
+    }
+    watcherCondition.wait_for( lock, interval, [] { return !watcherRunning; } );
+  }
+}
+
+}  // namespace
+
+Channel::Channel( std::string_view name, int levels ) : name_( name ), levels_( levels ) {}
+
+Channel &get_channel( std::string_view name ) {
+  std::lock_guard<std::mutex> lock( channel_mutex() );
+  for ( Channel &channel : channels() ) {
+    if ( channel.name() == name ) {
+      return channel;
+    }
+  }
+  return channels().emplace_back( name, ALL );
+}
+
+void set_channel_levels( std::string_view name, int levels ) {
+  if ( name != "*" ) {
+    get_channel( name ).set_levels( levels );
+    return;
+  }
+  std::lock_guard<std::mutex> lock( channel_mutex() );
+  for ( Channel &channel : channels() ) {
+    channel.set_levels( levels );
+  }
+}
+
+bool parse_levels( std::string_view text, int *levels ) {
+  int result = NONE;
+  while ( !text.empty() ) {
+    size_t separator = text.find( '|' );
+    std::string_view name = trim( text.substr( 0, separator ) );
+    text = separator == std::string_view::npos ? std::string_view() : text.substr( separator + 1 );
+
+    if ( name == "NONE" ) {
+      continue;
+    } else if ( name == "INFO" ) {
+      result |= INFO;
+    } else if ( name == "DEBUG" ) {
+      result |= DEBUG;
+    } else if ( name == "WARNING" ) {
+      result |= WARNING;
+    } else if ( name == "ERROR" || name == "ERROR_LOG" ) {
+      result |= ERROR_LOG;
+    } else if ( name == "CRITICAL" ) {
+      result |= CRITICAL;
+    } else if ( name == "ALL" ) {
+      result |= ALL;
+    } else {
+      return false;
+    }
+  }
+  *levels = result;
+  return true;
+}
+
+bool load_channel_config( const std::string &path ) {
+  std::ifstream file( path, std::ios::in );
+  if ( !file.is_open() ) {
+    return false;
+  }
+
+  std::string line;
+  int lineNumber = 0;
+  while ( std::getline( file, line ) ) {
+    lineNumber++;
+    std::string_view text = trim( line );
+    if ( text.empty() || text.front() == '#' ) {
+      continue;
+    }
+
+    size_t equals = text.find( '=' );
+    int levels;
+    if ( equals == std::string_view::npos || !parse_levels( text.substr( equals + 1 ), &levels ) ) {
+      THUMPY_LOG( WARNING, "Ignoring bad channel config line ", lineNumber, " in ", path, ": ",
+                  text );
+      continue;
+    }
+    set_channel_levels( trim( text.substr( 0, equals ) ), levels );
+  }
+  return true;
+}
+
+void watch_channel_config( const std::string &path, std::chrono::milliseconds interval ) {
+  stop_channel_config_watch();
+  std::lock_guard<std::mutex> lock( watcherMutex );
+  watcherRunning = true;
+  watcher = std::thread( watch_loop, path, interval );
+}
+
+void stop_channel_config_watch() {
+  {
+    std::lock_guard<std::mutex> lock( watcherMutex );
+    if ( !watcherRunning ) {
+      return;
+    }
+    watcherRunning = false;
+    watcherCondition.notify_one();
+  }
+  watcher.join();
+}
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
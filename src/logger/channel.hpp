@@ -0,0 +1,125 @@
+/**
+ * @file channel.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Named log channels with levels that can be changed while the engine runs
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <source_location>
+#include <string>
+#include <string_view>
+
+#include "logger.hpp"
+#include "logger_helper.hpp"
+
+/**
+ * @brief Log the concatenated arguments to a channel
+ * Costs one relaxed load when the channel has level turned off, and like THUMPY_LOG skips
+ * building the record when no sink accepts the level.
+ * e.g. THUMPY_LOG_CHANNEL( imageChannel, Logger::DEBUG, "Mip levels: ", mipLevels );
+ */
+#define THUMPY_LOG_CHANNEL( channel, level, ... )                                          \
+  do {                                                                                     \
+    if constexpr ( ::Thumpy::Core::Logger::is_compiled_in( level ) ) {                     \
+      if ( ( channel ).enabled( level ) &&                                                 \
+           ::Thumpy::Core::Logger::is_level_accepted( level ) ) {                          \
+        ::Thumpy::Core::Logger::log_parts( level, std::source_location::current(), "[",    \
+                                           ( channel ).name(), "] ", __VA_ARGS__ );        \
+      }                                                                                    \
+    }                                                                                      \
+  } while ( 0 )
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+const std::string channel_config_path = "log_channels.cfg";
+
+/**
+ * @brief A subsystem's view of the logger, e.g. "Vulkan::Image"
+ *
+ */
+class Channel {
+ public:
+  Channel( std::string_view name, int levels );
+
+  const std::string &name() const { return name_; }
+
+  /**
+   * @brief Check if the channel lets level through, CRITICAL always is
+   *
+   * @param level
+   * @return bool
+   */
+  bool enabled( LogLevel level ) const {
+    return ( level & ( levels_.load( std::memory_order_relaxed ) | CRITICAL ) ) != 0;
+  }
+
+  void set_levels( int levels ) { levels_.store( levels, std::memory_order_relaxed ); }
+
+  int levels() const { return levels_.load( std::memory_order_relaxed ); }
+
+ private:
+  std::string name_;
+  std::atomic<int> levels_;
+};
+
+/**
+ * @brief Get a channel by name, created with ALL levels on first use.
+ * The reference stays valid for the lifetime of the program.
+ * @param name
+ * @return Channel&
+ */
+Channel &get_channel( std::string_view name );
+
+/**
+ * @brief Set the levels of a channel, "*" sets every channel
+ *
+ * @param name
+ * @param levels
+ */
+void set_channel_levels( std::string_view name, int levels );
+
+/**
+ * @brief Parse a level list such as "DEBUG | WARNING", "ALL" or "NONE"
+ *
+ * @param text
+ * @param levels set on success
+ * @return true if every name was recognised
+ */
+bool parse_levels( std::string_view text, int *levels );
+
+/**
+ * @brief Apply a channel config file, one "Channel::Name = LEVEL | LEVEL" per line.
+ * "*" matches every channel, lines starting with # are comments.
+ * @param path
+ * @return true if the file was read
+ */
+bool load_channel_config( const std::string &path );
+
+/**
+ * @brief Re-read the config file from a background thread whenever it changes
+ *
+ * @param path
+ * @param interval how often the file is checked
+ */
+void watch_channel_config( const std::string &path,
+                           std::chrono::milliseconds interval = std::chrono::milliseconds( 1000 ) );
+
+/**
+ * @brief Stop the config watcher thread
+ *
+ */
+void stop_channel_config_watch();
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -11,44 +11,130 @@
 
 #include "file_logger.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <system_error>
 
 #include "logger.hpp"
+#include "log_rotation.hpp"
 #include "logger_helper.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Logger {
 
-int file_log_vision = ALL;
 std::ofstream *log_file = new std::ofstream();
 
+FileSink::FileSink( std::ofstream *file, int levels, size_t batchSize )
+    : Sink( levels, batchSize ), file_( file ) {}
+
+bool FileSink::open( const std::string &path ) {
+  close();
+  path_ = path;
+
+  // Keep the previous session's log instead of truncating it
+  std::error_code error;
+  if ( std::filesystem::file_size( path_, error ) > 0 && !error ) {
+    rotate_log( path_, rotation_ );
+  }
+
+  file_->open( path_, std::ofstream::out | std::ofstream::trunc );
+  bytesWritten_ = 0;
+  rotateAt_ = rotation_.interval.count() > 0
+                  ? std::chrono::system_clock::now() + rotation_.interval
+                  : std::chrono::system_clock::time_point::max();
+  return file_->is_open();
+}
+
+void FileSink::close() {
+  if ( file_->is_open() ) {
+    file_->close();
+  }
+}
+
+void FileSink::set_rotation( const RotationOptions &options ) {
+  rotation_ = options;
+  if ( file_->is_open() && rotation_.interval.count() > 0 ) {
+    rotateAt_ = std::chrono::system_clock::now() + rotation_.interval;
+  }
+}
+
+void FileSink::write_line( std::string_view line, std::chrono::system_clock::time_point time ) {
+  if ( !file_->is_open() ) {
+    return;
+  }
+  if ( time >= rotateAt_ ||
+       ( rotation_.maxBytes > 0 && bytesWritten_ + line.size() + 1 > rotation_.maxBytes &&
+         bytesWritten_ > 0 ) ) {
+    rotate();
+  }
+  *file_ << line << '\n';
+  bytesWritten_ += line.size() + 1;
+}
+
+void FileSink::write( const LogRecord &record, std::string_view line ) {
+  write_line( line, record.time );
+}
+
+void FileSink::flush() {
+  if ( file_->is_open() ) {
+    file_->flush();
+  }
+}
+
+void FileSink::rotate() {
+  // Only a rename on this thread, compression runs in the background
+  file_->close();
+  rotate_log( path_, rotation_ );
+  file_->open( path_, std::ofstream::out | std::ofstream::trunc );
+  bytesWritten_ = 0;
+  if ( rotation_.interval.count() > 0 ) {
+    rotateAt_ = std::chrono::system_clock::now() + rotation_.interval;
+  }
+}
+
+std::shared_ptr<FileSink> get_file_sink() {
+  static std::shared_ptr<FileSink> sink = std::make_shared<FileSink>( log_file );
+  return sink;
+}
+
+std::string get_log_file_path() { return get_executable_directory() + "/" + log_path; }
+
 void start_log_file() {
   // Open log file
-  log_file->open( log_path, std::ofstream::out | std::ofstream::trunc );
-  if ( !log_file->is_open() ) {
+  if ( !get_file_sink()->open( get_log_file_path() ) ) {
     log( "Log file failed to open.", ERROR_LOG );
   }
 }
 
+void set_log_rotation( const RotationOptions &options ) {
+  get_file_sink()->set_rotation( options );
+}
+
 void close_log_file() {
   // Close file
   if ( log_file->is_open() ) {
-    log( "Dumping log to " + std::filesystem::current_path().string() + "/" +
-             log_path,
-         DEBUG );
-    log_file->close();
+    THUMPY_LOG( DEBUG, "Dumping log to ", get_file_sink()->path() );
+    get_file_sink()->close();
   }
+  // Let queued compressions finish
+  stop_rotation_worker();
 }
 
-void log_to_file( const std::string &message, LogLevel level ) {
+void log_to_file( std::string_view message, LogLevel level ) {
+  submit_line( *get_file_sink(), level, message );
+}
+
+void set_file_log_vision( int levels ) { get_file_sink()->set_levels( levels ); }
+
+int get_file_log_vision() { return get_file_sink()->levels(); }
+
+void flush_log_file() {
   if ( log_file->is_open() ) {
-    if ( ( level & file_log_vision ) != 0 ) {
-      // Append to file
-      *log_file << message << std::endl;
-    }
+    log_file->flush();
   }
 }
 
@@ -11,9 +11,15 @@
 
 #pragma once
 
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
 
+#include "log_rotation.hpp"
 #include "logger_helper.hpp"
+#include "sink.hpp"
 
 namespace Thumpy {
 namespace Core {
@@ -22,11 +28,81 @@ namespace Logger {
 const std::string log_path = "log.dump";
 
 /**
- * @brief Create & open log file
+ * @brief Writes formatted records to an output file stream
+ *
+ */
+class FileSink : public Sink {
+ public:
+  explicit FileSink( std::ofstream *file, int levels = ALL, size_t batchSize = 0 );
+
+  /**
+   * @brief Open path for writing, a non-empty log left at path is rotated first
+   *
+   * @param path
+   * @return true if the file was opened
+   */
+  bool open( const std::string &path );
+
+  void close();
+
+  /**
+   * @brief Set when the log is rotated, call before records are being written
+   *
+   * @param options
+   */
+  void set_rotation( const RotationOptions &options );
+
+  /**
+   * @brief Write a formatted line, rotating the file when it is due
+   *
+   * @param line
+   * @param time time of the record, checked against the rotation interval
+   */
+  void write_line( std::string_view line, std::chrono::system_clock::time_point time );
+
+  const std::string &path() const { return path_; }
+
+ protected:
+  void write( const LogRecord &record, std::string_view line ) override;
+  void flush() override;
+
+ private:
+  void rotate();
+
+  std::ofstream *file_;
+  std::string path_;
+  RotationOptions rotation_;
+  size_t bytesWritten_ = 0;
+  std::chrono::system_clock::time_point rotateAt_ = std::chrono::system_clock::time_point::max();
+};
+
+/**
+ * @brief Get the sink writing to log_path, registered by default
+ *
+ * @return std::shared_ptr<FileSink>
+ */
+std::shared_ptr<FileSink> get_file_sink();
+
+/**
+ * @brief Get the full log file path, log_path next to the executable
+ *
+ * @return std::string
+ */
+std::string get_log_file_path();
+
+/**
+ * @brief Create & open log file, the previous session's log is rotated
  *
  */
 void start_log_file();
 
+/**
+ * @brief Set when the log file is rotated
+ *
+ * @param options
+ */
+void set_log_rotation( const RotationOptions &options );
+
 /**
  * @brief Close log file
  *
@@ -39,7 +115,27 @@ void close_log_file();
  * @param message
  * @param level
  */
-void log_to_file( const std::string &message, LogLevel level );
+void log_to_file( std::string_view message, LogLevel level );
+
+/**
+ * @brief Set levels written to the log file
+ *
+ * @param levels LogLevel mask
+ */
+void set_file_log_vision( int levels );
+
+/**
+ * @brief Get levels written to the log file
+ *
+ * @return int LogLevel mask
+ */
+int get_file_log_vision();
+
+/**
+ * @brief Flush buffered writes to the log file
+ *
+ */
+void flush_log_file();
 
 /**
  * @brief Get log file path
@@ -0,0 +1,326 @@
+/**
+ * @file flight_recorder.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief flight_recorder cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "flight_recorder.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "logger.hpp"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+std::atomic<int> flight_recorder_levels{ NONE };
+
+namespace {
+
+/**
+ * @brief Ring slot, sequence is odd while a writer is filling it in
+ *
+ */
+struct FlightEntry {
+  std::atomic<uint64_t> sequence{ 0 };
+  int64_t timeNanoseconds;
+  uint32_t level;
+  uint32_t length;
+  char message[FLIGHT_MESSAGE_SIZE];
+};
+
+// Everything the dump touches lives in static storage so a crash never needs the heap
+FlightEntry entries[FLIGHT_RECORD_CAPACITY];
+std::atomic<uint64_t> entryHead{ 0 };
+
+FrameStats frames[FLIGHT_FRAME_CAPACITY];
+std::atomic<uint64_t> frameHead{ 0 };
+std::chrono::steady_clock::time_point lastFrameTime;
+
+char dumpPath[512];
+// Entries are copied out before they're checked & written, a slot may be reused meanwhile
+char dumpMessage[FLIGHT_MESSAGE_SIZE];
+std::atomic<bool> dumping{ false };
+bool handlersInstalled = false;
+
+int64_t now_nanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch() )
+      .count();
+}
+
+#pragma region Signal-safe formatting
+
+/**
+ * @brief Fixed size line builder, writes with write() once full or on flush
+ *
+ */
+struct DumpWriter {
+  int file;
+  char buffer[512];
+  size_t length = 0;
+
+  void flush() {
+    size_t written = 0;
+    while ( written < length ) {
+#ifdef _WIN32
+      int result = _write( file, buffer + written, static_cast<unsigned int>( length - written ) );
+#else
+      ssize_t result = ::write( file, buffer + written, length - written );
+#endif
+      if ( result <= 0 ) {
+        break;
+      }
+      written += static_cast<size_t>( result );
+    }
+    length = 0;
+  }
+
+  void text( std::string_view value ) {
+    for ( char character : value ) {
+      if ( length == sizeof( buffer ) ) {
+        flush();
+      }
+      buffer[length++] = character;
+    }
+  }
+
+  void number( uint64_t value, int width = 0 ) {
+    char digits[20];
+    int count = 0;
+    do {
+      digits[count++] = static_cast<char>( '0' + value % 10 );
+      value /= 10;
+    } while ( value > 0 );
+    for ( ; width > count; width-- ) {
+      text( "0" );
+    }
+    while ( count > 0 ) {
+      char digit = digits[--count];
+      text( std::string_view( &digit, 1 ) );
+    }
+  }
+
+  void milliseconds( float value ) {
+    if ( value < 0 ) {
+      value = 0;
+    }
+    uint64_t micros = static_cast<uint64_t>( value * 1000.0f );
+    number( micros / 1000 );
+    text( "." );
+    number( micros % 1000, 3 );
+  }
+
+  // YYYY-MM-DD HH:MM:SS.mmm UTC, localtime is not async-signal-safe
+  void timestamp( int64_t nanoseconds ) {
+    int64_t milliseconds = nanoseconds / 1000000;
+    int64_t seconds = milliseconds / 1000;
+    int64_t days = seconds / 86400;
+    int64_t secondOfDay = seconds % 86400;
+
+    // Civil date from days since 1970-01-01 (Howard Hinnant's algorithm)
+    days += 719468;
+    int64_t era = days / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra =
+        ( dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096 ) / 365;
+    int64_t dayOfYear = dayOfEra - ( 365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100 );
+    int64_t monthPrime = ( 5 * dayOfYear + 2 ) / 153;
+    int64_t day = dayOfYear - ( 153 * monthPrime + 2 ) / 5 + 1;
+    int64_t month = monthPrime < 10 ? monthPrime + 3 : monthPrime - 9;
+    int64_t year = yearOfEra + era * 400 + ( month <= 2 ? 1 : 0 );
+
+    number( static_cast<uint64_t>( year ), 4 );
+    text( "-" );
+    number( static_cast<uint64_t>( month ), 2 );
+    text( "-" );
+    number( static_cast<uint64_t>( day ), 2 );
+    text( " " );
+    number( static_cast<uint64_t>( secondOfDay / 3600 ), 2 );
+    text( ":" );
+    number( static_cast<uint64_t>( secondOfDay / 60 % 60 ), 2 );
+    text( ":" );
+    number( static_cast<uint64_t>( secondOfDay % 60 ), 2 );
+    text( "." );
+    number( static_cast<uint64_t>( milliseconds % 1000 ), 3 );
+    text( " UTC" );
+  }
+};
+
+#pragma endregion Signal-safe formatting
+
+#pragma region Signal handlers
+
+void crash_handler( int signal ) {
+  dump_flight_recorder();
+  // Let the default action take over
+  std::signal( signal, SIG_DFL );
+  std::raise( signal );
+}
+
+void install_crash_handlers() {
+  if ( handlersInstalled ) {
+    return;
+  }
+  handlersInstalled = true;
+#ifdef _WIN32
+  std::signal( SIGSEGV, crash_handler );
+  std::signal( SIGABRT, crash_handler );
+#else
+  struct sigaction action;
+  std::memset( &action, 0, sizeof( action ) );
+  action.sa_handler = crash_handler;
+  sigemptyset( &action.sa_mask );
+  action.sa_flags = SA_RESETHAND;
+  sigaction( SIGSEGV, &action, nullptr );
+  sigaction( SIGABRT, &action, nullptr );
+#endif
+}
+
+#pragma endregion Signal handlers
+
+}  // namespace
+
+void enable_flight_recorder( const std::string &path, int levels ) {
+  size_t length = path.size() < sizeof( dumpPath ) - 1 ? path.size() : sizeof( dumpPath ) - 1;
+  std::memcpy( dumpPath, path.data(), length );
+  dumpPath[length] = '\0';
+
+  lastFrameTime = std::chrono::steady_clock::now();
+  install_crash_handlers();
+  flight_recorder_levels.store( levels );
+  update_accepted_levels();
+}
+
+void disable_flight_recorder() {
+  flight_recorder_levels.store( NONE );
+  update_accepted_levels();
+}
+
+void record_flight_entry( const LogRecord &record ) {
+  uint64_t ticket = entryHead.fetch_add( 1, std::memory_order_relaxed );
+  FlightEntry &entry = entries[ticket & ( FLIGHT_RECORD_CAPACITY - 1 )];
+
+  entry.sequence.store( 2 * ticket + 1, std::memory_order_relaxed );
+  std::atomic_thread_fence( std::memory_order_release );
+
+  std::string_view message = record.message();
+  size_t length = message.size() < FLIGHT_MESSAGE_SIZE ? message.size() : FLIGHT_MESSAGE_SIZE;
+  std::memcpy( entry.message, message.data(), length );
+  entry.length = static_cast<uint32_t>( length );
+  entry.level = static_cast<uint32_t>( record.level );
+  entry.timeNanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>( record.time.time_since_epoch() )
+          .count();
+
+  entry.sequence.store( 2 * ticket + 2, std::memory_order_release );
+}
+
+void record_frame_stats( float cpuMilliseconds ) {
+  auto now = std::chrono::steady_clock::now();
+  uint64_t frame = frameHead.load( std::memory_order_relaxed );
+  FrameStats &stats = frames[frame & ( FLIGHT_FRAME_CAPACITY - 1 )];
+  stats.frame = frame;
+  stats.timeNanoseconds = now_nanoseconds();
+  stats.frameMilliseconds =
+      std::chrono::duration<float, std::chrono::milliseconds::period>( now - lastFrameTime )
+          .count();
+  stats.cpuMilliseconds = cpuMilliseconds;
+  lastFrameTime = now;
+  frameHead.store( frame + 1, std::memory_order_release );
+}
+
+bool dump_flight_recorder() noexcept {
+  if ( flight_recorder_levels.load() == NONE || dumping.exchange( true ) ) {
+    return false;
+  }
+
+#ifdef _WIN32
+  int file = _open( dumpPath, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644 );
+#else
+  int file = ::open( dumpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+#endif
+  if ( file < 0 ) {
+    dumping.store( false );
+    return false;
+  }
+
+  DumpWriter writer;
+  writer.file = file;
+
+  // Records, oldest first
+  uint64_t head = entryHead.load( std::memory_order_acquire );
+  uint64_t first = head > FLIGHT_RECORD_CAPACITY ? head - FLIGHT_RECORD_CAPACITY : 0;
+  for ( uint64_t ticket = first; ticket < head; ticket++ ) {
+    FlightEntry &entry = entries[ticket & ( FLIGHT_RECORD_CAPACITY - 1 )];
+    // Skip slots being written or already reused by a newer record
+    uint64_t sequence = 2 * ticket + 2;
+    if ( entry.sequence.load( std::memory_order_acquire ) != sequence ) {
+      continue;
+    }
+    int64_t timeNanoseconds = entry.timeNanoseconds;
+    uint32_t level = entry.level;
+    uint32_t length = entry.length < FLIGHT_MESSAGE_SIZE ? entry.length : FLIGHT_MESSAGE_SIZE;
+    std::memcpy( dumpMessage, entry.message, length );
+    // A writer that reused the slot while copying leaves a torn entry, skip it too
+    std::atomic_thread_fence( std::memory_order_acquire );
+    if ( entry.sequence.load( std::memory_order_relaxed ) != sequence ) {
+      continue;
+    }
+    writer.text( "[" );
+    writer.text( log_level_name( static_cast<LogLevel>( level ) ) );
+    writer.text( "] [" );
+    writer.timestamp( timeNanoseconds );
+    writer.text( "]: " );
+    writer.text( std::string_view( dumpMessage, length ) );
+    writer.text( "\n" );
+  }
+
+  // Frame stats, oldest first
+  uint64_t frameCount = frameHead.load( std::memory_order_acquire );
+  uint64_t firstFrame = frameCount > FLIGHT_FRAME_CAPACITY ? frameCount - FLIGHT_FRAME_CAPACITY : 0;
+  for ( uint64_t frame = firstFrame; frame < frameCount; frame++ ) {
+    const FrameStats &stats = frames[frame & ( FLIGHT_FRAME_CAPACITY - 1 )];
+    writer.text( "[FRAME] [" );
+    writer.timestamp( stats.timeNanoseconds );
+    writer.text( "]: #" );
+    writer.number( stats.frame );
+    writer.text( " frame " );
+    writer.milliseconds( stats.frameMilliseconds );
+    writer.text( " ms, cpu " );
+    writer.milliseconds( stats.cpuMilliseconds );
+    writer.text( " ms\n" );
+  }
+  writer.flush();
+
+#ifdef _WIN32
+  _close( file );
+#else
+  ::close( file );
+#endif
+  dumping.store( false );
+  return true;
+}
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
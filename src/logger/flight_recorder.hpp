@@ -0,0 +1,92 @@
+/**
+ * @file flight_recorder.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Preallocated ring of recent log records & frame stats, dumped on crashes
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "log_record.hpp"
+#include "logger_helper.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+const std::string flight_recorder_path = "flight.dump";
+
+// Power of two so the ring index is a mask
+const size_t FLIGHT_RECORD_CAPACITY = 1024;
+const size_t FLIGHT_FRAME_CAPACITY = 256;
+// Longer messages are truncated
+const size_t FLIGHT_MESSAGE_SIZE = 232;
+
+/**
+ * @brief Stats kept for each rendered frame
+ *
+ */
+struct FrameStats {
+  uint64_t frame;
+  int64_t timeNanoseconds;  // Since the system_clock epoch
+  float frameMilliseconds;  // Since the previous frame
+  float cpuMilliseconds;    // Spent building & submitting the frame
+};
+
+/**
+ * @brief Levels the flight recorder keeps, 0 while disabled
+ *
+ */
+extern std::atomic<int> flight_recorder_levels;
+
+/**
+ * @brief Start recording and install SIGSEGV / SIGABRT handlers that dump the recorder
+ *
+ * @param path file written by dump_flight_recorder
+ * @param levels LogLevel mask kept by the recorder
+ */
+void enable_flight_recorder( const std::string &path = flight_recorder_path, int levels = ALL );
+
+/**
+ * @brief Stop recording, the signal handlers stay installed but no longer dump
+ *
+ */
+void disable_flight_recorder();
+
+inline bool is_flight_recorded( LogLevel level ) {
+  return ( level & flight_recorder_levels.load( std::memory_order_relaxed ) ) != 0;
+}
+
+/**
+ * @brief Copy a record into the ring, never allocates
+ *
+ * @param record
+ */
+void record_flight_entry( const LogRecord &record );
+
+/**
+ * @brief Add the stats for a finished frame, called from the render thread
+ *
+ * @param cpuMilliseconds
+ */
+void record_frame_stats( float cpuMilliseconds );
+
+/**
+ * @brief Write the ring & frame stats to the dump path, does nothing while disabled.
+ * Async-signal-safe: only open() / write() / close() on preallocated memory, times are UTC.
+ * @return bool true if the dump was written
+ */
+bool dump_flight_recorder() noexcept;
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
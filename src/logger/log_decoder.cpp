@@ -0,0 +1,40 @@
+/**
+ * @file log_decoder.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Turns a binary log back into text, usage: engine_log_decoder <binary log> [output]
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "binary_logger.hpp"
+
+int main( int argc, char **argv ) {
+  if ( argc < 2 ) {
+    std::cerr << "usage: " << argv[0] << " <binary log> [output]\n";
+    return 1;
+  }
+
+  size_t decoded;
+  bool valid;
+  if ( argc > 2 ) {
+    std::ofstream output( argv[2], std::ios::out | std::ios::trunc );
+    if ( !output.is_open() ) {
+      std::cerr << "Failed to open " << argv[2] << '\n';
+      return 1;
+    }
+    decoded = Thumpy::Core::Logger::decode_binary_log( argv[1], output, &valid );
+  } else {
+    decoded = Thumpy::Core::Logger::decode_binary_log( argv[1], std::cout, &valid );
+  }
+
+  std::cerr << "Decoded " << decoded << " records\n";
+  // An empty log is still a valid one
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file log_record.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Compact log record passed between the logger front end and its writers
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "logger_helper.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+/**
+ * @brief Bytes of message stored inline in a record.
+ * Longer messages spill into LogRecord::longMessage.
+ */
+const size_t LOG_RECORD_INLINE_CAPACITY = 216;
+
+struct LogRecord {
+  std::chrono::system_clock::time_point time;
+  LogLevel level = NONE;
+  uint32_t length = 0;
+  // Where the record was logged from, set by THUMPY_LOG
+  const char *file = nullptr;
+  uint32_t line = 0;
+  char inlineMessage[LOG_RECORD_INLINE_CAPACITY];
+  std::string longMessage;
+
+  /**
+   * @brief Copy message into the record, only allocating when it does not fit inline
+   *
+   * @param message
+   */
+  void set_message( std::string_view message ) {
+    length = static_cast<uint32_t>( message.size() );
+    if ( message.size() <= LOG_RECORD_INLINE_CAPACITY ) {
+      std::memcpy( inlineMessage, message.data(), message.size() );
+      longMessage.clear();
+    } else {
+      longMessage.assign( message );
+    }
+  }
+
+  /**
+   * @brief Get the stored message
+   *
+   * @return std::string_view
+   */
+  std::string_view message() const {
+    if ( length <= LOG_RECORD_INLINE_CAPACITY ) {
+      return std::string_view( inlineMessage, length );
+    }
+    return longMessage;
+  }
+};
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
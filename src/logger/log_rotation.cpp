@@ -0,0 +1,236 @@
+/**
+ * @file log_rotation.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief log_rotation cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "log_rotation.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+namespace {
+
+struct RotationJob {
+  std::string rotatedPath;
+  std::string livePath;
+  RotationOptions options;
+};
+
+std::thread worker;
+std::mutex jobMutex;
+std::condition_variable jobCondition;
+std::condition_variable idleCondition;
+std::deque<RotationJob> jobs;
+bool workerRunning = false;
+bool jobActive = false;
+
+bool is_rotated_name( const std::string &name, const std::string &stem, const std::string &ext ) {
+  if ( !name.starts_with( stem + "." ) || name == stem + ext ) {
+    return false;
+  }
+  return name.ends_with( ext ) || name.ends_with( ext + ".gz" );
+}
+
+/**
+ * @brief Split a rotated name into its UTC stamp & sequence number
+ * e.g. log.20261016-204621-1000.dump -> { "20261016-204621", 1000 }
+ */
+std::pair<std::string, unsigned long> rotation_order( const std::string &name,
+                                                      const std::string &stem ) {
+  std::string stamp = name.substr( stem.size() + 1, 15 );
+  size_t sequenceStart = stem.size() + 1 + stamp.size() + 1;
+  unsigned long sequence = 0;
+  if ( sequenceStart < name.size() ) {
+    sequence = std::strtoul( name.c_str() + sequenceStart, nullptr, 10 );
+  }
+  return { stamp, sequence };
+}
+
+void worker_loop() {
+  std::unique_lock<std::mutex> lock( jobMutex );
+  while ( true ) {
+    jobCondition.wait( lock, [] { return !jobs.empty() || !workerRunning; } );
+    if ( jobs.empty() ) {
+      break;
+    }
+
+    RotationJob job = std::move( jobs.front() );
+    jobs.pop_front();
+    jobActive = true;
+    lock.unlock();
+
+    if ( job.options.compress ) {
+      compress_log( job.rotatedPath );
+    }
+    prune_rotated_logs( job.livePath, job.options.retainedFiles );
+
+    lock.lock();
+    jobActive = false;
+    idleCondition.notify_all();
+  }
+}
+
+}  // namespace
+
+std::string rotated_log_path( const std::string &path,
+                              std::chrono::system_clock::time_point time ) {
+  std::filesystem::path live( path );
+  std::time_t seconds = std::chrono::system_clock::to_time_t( time );
+  // UTC, so names never repeat or go backwards when the clocks change
+  std::tm utc{};
+#ifdef _WIN32
+  gmtime_s( &utc, &seconds );
+#else
+  gmtime_r( &seconds, &utc );
+#endif
+  char stamp[32];
+  std::strftime( stamp, sizeof( stamp ), "%Y%m%d-%H%M%S", &utc );
+
+  // Several rotations can happen within a second
+  for ( int sequence = 0;; sequence++ ) {
+    // Room for any int, so the sequence never truncates
+    char suffix[16];
+    std::snprintf( suffix, sizeof( suffix ), "-%03d", sequence );
+    std::filesystem::path candidate = live.parent_path() / ( live.stem().string() + "." + stamp +
+                                                             suffix + live.extension().string() );
+    std::error_code error;
+    if ( !std::filesystem::exists( candidate, error ) &&
+         !std::filesystem::exists( candidate.string() + ".gz", error ) ) {
+      return candidate.string();
+    }
+  }
+}
+
+bool rotate_log( const std::string &path, const RotationOptions &options ) {
+  std::error_code error;
+  if ( !std::filesystem::exists( path, error ) ) {
+    return false;
+  }
+
+  std::string rotatedPath = rotated_log_path( path, std::chrono::system_clock::now() );
+  std::filesystem::rename( path, rotatedPath, error );
+  if ( error ) {
+    return false;
+  }
+
+  // Compression & pruning happen off the writer thread
+  std::lock_guard<std::mutex> lock( jobMutex );
+  if ( !workerRunning ) {
+    workerRunning = true;
+    worker = std::thread( worker_loop );
+  }
+  jobs.push_back( RotationJob{ rotatedPath, path, options } );
+  jobCondition.notify_one();
+  return true;
+}
+
+bool compress_log( const std::string &path ) {
+  std::ifstream input( path, std::ios::in | std::ios::binary );
+  if ( !input.is_open() ) {
+    return false;
+  }
+
+  std::string compressedPath = path + ".gz";
+  gzFile output = gzopen( compressedPath.c_str(), "wb" );
+  if ( output == nullptr ) {
+    return false;
+  }
+
+  std::vector<char> buffer( 64 * 1024 );
+  bool ok = true;
+  while ( ok && input ) {
+    input.read( buffer.data(), static_cast<std::streamsize>( buffer.size() ) );
+    std::streamsize count = input.gcount();
+    if ( count > 0 ) {
+      ok = gzwrite( output, buffer.data(), static_cast<unsigned int>( count ) ) == count;
+    }
+  }
+  ok = ( gzclose( output ) == Z_OK ) && ok;
+  input.close();
+
+  std::error_code error;
+  if ( !ok ) {
+    // Keep the uncompressed log rather than a broken archive
+    std::filesystem::remove( compressedPath, error );
+    return false;
+  }
+  std::filesystem::remove( path, error );
+  return true;
+}
+
+size_t prune_rotated_logs( const std::string &path, size_t retained ) {
+  std::filesystem::path live( path );
+  std::filesystem::path directory = live.parent_path().empty() ? "." : live.parent_path();
+  std::string stem = live.stem().string();
+  std::string ext = live.extension().string();
+
+  std::error_code error;
+  std::vector<std::filesystem::path> rotated;
+  for ( const auto &entry : std::filesystem::directory_iterator( directory, error ) ) {
+    if ( entry.is_regular_file( error ) &&
+         is_rotated_name( entry.path().filename().string(), stem, ext ) ) {
+      rotated.push_back( entry.path() );
+    }
+  }
+  if ( rotated.size() <= retained ) {
+    return 0;
+  }
+
+  // Oldest first, the sequence is compared as a number so -1000 comes after -999
+  std::sort( rotated.begin(), rotated.end(), [&stem]( const auto &a, const auto &b ) {
+    return rotation_order( a.filename().string(), stem ) <
+           rotation_order( b.filename().string(), stem );
+  } );
+  size_t removed = 0;
+  for ( size_t i = 0; i < rotated.size() - retained; i++ ) {
+    if ( std::filesystem::remove( rotated[i], error ) ) {
+      removed++;
+    }
+  }
+  return removed;
+}
+
+void wait_for_rotations() {
+  std::unique_lock<std::mutex> lock( jobMutex );
+  idleCondition.wait( lock, [] { return jobs.empty() && !jobActive; } );
+}
+
+void stop_rotation_worker() {
+  {
+    std::lock_guard<std::mutex> lock( jobMutex );
+    if ( !workerRunning ) {
+      return;
+    }
+    workerRunning = false;
+    jobCondition.notify_one();
+  }
+  worker.join();
+}
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
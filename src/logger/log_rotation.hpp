@@ -0,0 +1,78 @@
+/**
+ * @file log_rotation.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Rotated log naming, background compression and retention
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+struct RotationOptions {
+  size_t maxBytes = 0;                 // Rotate once the file reaches this size, 0 disables
+  std::chrono::seconds interval{ 0 };  // Rotate after the file has been open this long, 0 disables
+  size_t retainedFiles = 5;            // Rotated files kept next to the live log
+  bool compress = true;                // gzip rotated files on a background thread
+};
+
+/**
+ * @brief Pick an unused name for a rotated log
+ * e.g. log.dump -> log.20261016-204621-000.dump, stamped in UTC
+ * @param path live log path
+ * @param time when the log was rotated
+ * @return std::string
+ */
+std::string rotated_log_path( const std::string &path, std::chrono::system_clock::time_point time );
+
+/**
+ * @brief Move the live log aside and hand it to the background thread
+ * The caller has to close the file first.
+ * @param path live log path
+ * @param options
+ * @return true if the log was moved
+ */
+bool rotate_log( const std::string &path, const RotationOptions &options );
+
+/**
+ * @brief gzip a file to path.gz and remove the original
+ *
+ * @param path
+ * @return true if the file was compressed
+ */
+bool compress_log( const std::string &path );
+
+/**
+ * @brief Delete the oldest rotated logs so at most retained are left
+ *
+ * @param path live log path, never deleted
+ * @param retained
+ * @return size_t files deleted
+ */
+size_t prune_rotated_logs( const std::string &path, size_t retained );
+
+/**
+ * @brief Block until every queued rotation has been compressed & pruned
+ *
+ */
+void wait_for_rotations();
+
+/**
+ * @brief Finish queued rotations and join the background thread
+ *
+ */
+void stop_rotation_worker();
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
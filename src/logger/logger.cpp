@@ -11,11 +11,20 @@
 
 #include "logger.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
+#include "async_logger.hpp"
+#include "binary_logger.hpp"
+#include "channel.hpp"
 #include "file_logger.hpp"
+#include "flight_recorder.hpp"
 #include "logger_helper.hpp"
-#include "term_logger.hpp"
+#include "sink.hpp"
 
 namespace Thumpy {
 namespace Core {
@@ -23,18 +32,97 @@ namespace Logger {
 
 void init() { start_log_file(); }
 
-void close_logger() { close_log_file(); }
+void init( const AsyncOptions &options ) {
+  start_log_file();
+  start_async( options );
+}
+
+void close_logger() {
+  stop_channel_config_watch();
+  stop_async();
+  flush_registered_sinks( true );
+  close_binary_log();
+  close_log_file();
+}
+
+std::atomic<int> accepted_levels{ ALL };
+
+namespace {
+
+// Per-thread storage for MessageBuilder
+thread_local char messageBuffer[LOG_FORMAT_BUFFER_SIZE];
+thread_local std::string messageOverflow;
+
+void submit_record( LogRecord &record, std::string_view message, LogLevel level ) {
+  record.time = std::chrono::system_clock::now();
+  record.level = level;
+  record.set_message( message );
 
-void log( const std::string &message, LogLevel level ) {
-  std::string modded_message = format_message( &message, level );
-  log_to_file( modded_message, level );
-  log_to_terminal( modded_message, level );
+  // Captured before queueing so a crash can not lose it
+  if ( is_flight_recorded( level ) ) {
+    record_flight_entry( record );
+  }
+
+  if ( !push_record( record ) ) {
+    write_record( record );
+    flush_sinks();
+  }
 
   if ( ( level & CRITICAL ) != 0 ) {
-    throw std::runtime_error( message );
+    // Make sure the record is on disk before unwinding
+    flush_async();
+    dump_flight_recorder();
+    throw std::runtime_error( std::string( message ) );
+  }
+}
+
+}  // namespace
+
+void update_accepted_levels() {
+  accepted_levels.store( registered_sink_levels() | flight_recorder_levels.load(),
+                         std::memory_order_relaxed );
+}
+
+void log( std::string_view message, LogLevel level ) {
+  LogRecord record;
+  submit_record( record, message, level );
+}
+
+void log( std::string_view message, LogLevel level, const std::source_location &location ) {
+  LogRecord record;
+  record.file = location.file_name();
+  record.line = location.line();
+  submit_record( record, message, level );
+}
+
+MessageBuilder::MessageBuilder() { messageOverflow.clear(); }
+
+void MessageBuilder::append_text( std::string_view text ) {
+  if ( messageOverflow.empty() && length_ + text.size() <= LOG_FORMAT_BUFFER_SIZE ) {
+    std::memcpy( messageBuffer + length_, text.data(), text.size() );
+    length_ += text.size();
+    return;
   }
+
+  // Outgrew the buffer, move to the heap
+  if ( messageOverflow.empty() ) {
+    messageOverflow.assign( messageBuffer, length_ );
+  }
+  messageOverflow.append( text );
+  length_ = messageOverflow.size();
 }
 
+std::string_view MessageBuilder::view() const {
+  if ( !messageOverflow.empty() ) {
+    return messageOverflow;
+  }
+  return std::string_view( messageBuffer, length_ );
+}
+
+void write_record( const LogRecord &record ) { dispatch_record( record ); }
+
+void flush_sinks() { flush_registered_sinks( false ); }
+
 }  // namespace Logger
 }  // namespace Core
 }  // namespace Thumpy
@@ -11,14 +11,83 @@
 
 #pragma once
 
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <source_location>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
+#include "async_logger.hpp"
+#include "log_record.hpp"
 #include "logger_helper.hpp"
 
+/**
+ * @brief Levels compiled into the binary, THUMPY_LOG calls for other levels are removed.
+ * CRITICAL is always kept since it stops the engine.
+ * Override with -DTHUMPY_LOG_COMPILED_LEVELS=...
+ */
+#ifndef THUMPY_LOG_COMPILED_LEVELS
+#ifdef NDEBUG
+#define THUMPY_LOG_COMPILED_LEVELS \
+  ( ::Thumpy::Core::Logger::ALL & ~::Thumpy::Core::Logger::DEBUG )
+#else
+#define THUMPY_LOG_COMPILED_LEVELS ::Thumpy::Core::Logger::ALL
+#endif
+#endif
+
+/**
+ * @brief Log the concatenated arguments at level
+ * Arguments are only evaluated when the level is compiled in and some sink accepts it.
+ * e.g. THUMPY_LOG( Logger::DEBUG, "Loading model: ", path, " (", count, " vertices)" );
+ */
+#define THUMPY_LOG( level, ... )                                                            \
+  do {                                                                                      \
+    if constexpr ( ::Thumpy::Core::Logger::is_compiled_in( level ) ) {                      \
+      if ( ::Thumpy::Core::Logger::is_level_accepted( level ) ) {                           \
+        ::Thumpy::Core::Logger::log_parts( level, std::source_location::current(),          \
+                                           __VA_ARGS__ );                                   \
+      }                                                                                     \
+    }                                                                                       \
+  } while ( 0 )
+
 namespace Thumpy {
 namespace Core {
 namespace Logger {
 
+/**
+ * @brief Levels accepted by at least one sink, kept up to date by the sinks
+ *
+ */
+extern std::atomic<int> accepted_levels;
+
+/**
+ * @brief Check if a level survived compilation
+ *
+ * @param level
+ * @return true if THUMPY_LOG calls at level are compiled in
+ */
+constexpr bool is_compiled_in( LogLevel level ) {
+  return ( level & ( THUMPY_LOG_COMPILED_LEVELS | CRITICAL ) ) != 0;
+}
+
+/**
+ * @brief Check if any sink will accept level
+ * CRITICAL is always accepted since it stops the engine.
+ * @param level
+ * @return bool
+ */
+inline bool is_level_accepted( LogLevel level ) {
+  return ( level & ( accepted_levels.load( std::memory_order_relaxed ) | CRITICAL ) ) != 0;
+}
+
+/**
+ * @brief Recompute accepted_levels from the sink visions
+ *
+ */
+void update_accepted_levels();
+
 /**
  * @brief Starts logger / creates log file
  *
@@ -26,8 +95,15 @@ namespace Logger {
 void init();
 
 /**
- * @brief Closes logger / log file
+ * @brief Starts logger with records written by a background thread
  *
+ * @param options
+ */
+void init( const AsyncOptions &options );
+
+/**
+ * @brief Closes logger / log file
+ * Drains any queued records first
  */
 void close_logger();
 
@@ -37,7 +113,84 @@ void close_logger();
  * @param message
  * @param level
  */
-void log( const std::string &message, LogLevel level = INFO );
+void log( std::string_view message, LogLevel level = INFO );
+
+/**
+ * @brief log a message with the location it was logged from
+ *
+ * @param message
+ * @param level
+ * @param location
+ */
+void log( std::string_view message, LogLevel level, const std::source_location &location );
+
+/**
+ * @brief Builds a message from parts in a per-thread buffer
+ * Numbers are written with std::to_chars, nothing allocates unless the message outgrows
+ * LOG_FORMAT_BUFFER_SIZE.
+ */
+class MessageBuilder {
+ public:
+  MessageBuilder();
+
+  template <typename T>
+  void append( const T &value ) {
+    if constexpr ( std::is_same_v<T, bool> ) {
+      append_text( value ? "true" : "false" );
+    } else if constexpr ( std::is_same_v<T, char> ) {
+      append_text( std::string_view( &value, 1 ) );
+    } else if constexpr ( std::is_arithmetic_v<T> ) {
+      char number[64];
+      auto result = std::to_chars( number, number + sizeof( number ), value );
+      append_text( std::string_view( number, result.ptr - number ) );
+    } else if constexpr ( std::is_enum_v<T> ) {
+      append( static_cast<std::underlying_type_t<T>>( value ) );
+    } else if constexpr ( std::is_convertible_v<const T &, std::string_view> ) {
+      append_text( std::string_view( value ) );
+    } else if constexpr ( std::is_pointer_v<T> ) {
+      char number[32] = { '0', 'x' };
+      auto result = std::to_chars( number + 2, number + sizeof( number ),
+                                   reinterpret_cast<uintptr_t>( value ), 16 );
+      append_text( std::string_view( number, result.ptr - number ) );
+    } else {
+      static_assert( sizeof( T ) == 0, "THUMPY_LOG argument type is not supported" );
+    }
+  }
+
+  std::string_view view() const;
+
+ private:
+  void append_text( std::string_view text );
+
+  size_t length_ = 0;
+};
+
+/**
+ * @brief Concatenate parts and log them, used by THUMPY_LOG
+ *
+ * @param level
+ * @param location
+ * @param parts
+ */
+template <typename... Parts>
+void log_parts( LogLevel level, const std::source_location &location, const Parts &...parts ) {
+  MessageBuilder builder;
+  ( builder.append( parts ), ... );
+  log( builder.view(), level, location );
+}
+
+/**
+ * @brief Format and write a record to the file & terminal without flushing
+ *
+ * @param record
+ */
+void write_record( const LogRecord &record );
+
+/**
+ * @brief Flush the file & terminal
+ *
+ */
+void flush_sinks();
 
 }  // namespace Logger
 }  // namespace Core
@@ -12,51 +12,174 @@
 
 #include "logger_helper.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
 #include <chrono>
-#include <ctime>
+#include <cstring>
+#include <filesystem>
 #include <string>
+#include <string_view>
+
+#include "logger.hpp"
+#include "timestamp.hpp"
+
+#ifdef __unix__
+#include <climits>
+#include <unistd.h>
+#elif defined( __APPLE__ )
+#include <mach-o/dyld.h>
+
+#include <climits>
+#elif _WIN32
+#include <windows.h>
+#endif  // _WIN32
 
 namespace Thumpy {
 namespace Core {
 namespace Logger {
 
+namespace {
+
+// Indexed by the lowest set bit of the level
+constexpr std::array<std::string_view, 6> LEVEL_NAMES = { "UNKNOWN", "INFO",  "DEBUG",
+                                                         "WARNING", "ERROR", "CRITICAL" };
+
+// Append text, truncating at capacity
+inline size_t append( char *buffer, size_t capacity, size_t length, std::string_view text ) {
+  size_t count = std::min( text.size(), capacity - length );
+  std::memcpy( buffer + length, text.data(), count );
+  return length + count;
+}
+
+thread_local char formatBuffer[LOG_FORMAT_BUFFER_SIZE];
+thread_local std::string overflowBuffer;
+
+std::atomic<bool> sourceLocationVisible{ false };
+
+// Strip directories from a source path
+std::string_view file_name( const char *file ) {
+  std::string_view path( file );
+  size_t slash = path.find_last_of( "\\/" );
+  return slash == std::string_view::npos ? path : path.substr( slash + 1 );
+}
+
+}  // namespace
+
 std::string format_message( const std::string *message, LogLevel level ) {
-  return std::string( "[" + log_level_to_string( level ) + "] [" +
-                      get_time_as_string() + "]: " + message->c_str() );
+  return format_message( message, level, std::chrono::system_clock::now() );
 }
 
-std::string log_level_to_string( LogLevel level ) {
-  if ( ( level & INFO ) != 0 ) {
-    return "INFO";
-  }
-  if ( ( level & DEBUG ) != 0 ) {
-    return "DEBUG";
-  }
-  if ( ( level & WARNING ) != 0 ) {
-    return "WARNING";
-  }
-  if ( ( level & ERROR_LOG ) != 0 ) {
-    return "ERROR";
+std::string format_message( const std::string *message, LogLevel level,
+                            std::chrono::system_clock::time_point time ) {
+  return std::string( format_message_view( *message, level, time ) );
+}
+
+size_t format_message_to( char *buffer, size_t capacity, std::string_view message, LogLevel level,
+                          std::chrono::system_clock::time_point time, const char *file,
+                          uint32_t line ) {
+  // [LEVEL] [TIME]: MESSAGE
+  size_t length = append( buffer, capacity, 0, "[" );
+  length = append( buffer, capacity, length, log_level_name( level ) );
+  length = append( buffer, capacity, length, "] [" );
+  length += write_time( buffer + length, capacity - length, time );
+  length = append( buffer, capacity, length, "]: " );
+  length = append( buffer, capacity, length, message );
+
+  if ( file != nullptr ) {
+    // MESSAGE (FILE:LINE)
+    char number[16];
+    auto result = std::to_chars( number, number + sizeof( number ), line );
+    length = append( buffer, capacity, length, " (" );
+    length = append( buffer, capacity, length, file_name( file ) );
+    length = append( buffer, capacity, length, ":" );
+    length = append( buffer, capacity, length, std::string_view( number, result.ptr - number ) );
+    length = append( buffer, capacity, length, ")" );
   }
-  if ( ( level & CRITICAL ) != 0 ) {
-    return "CRITICAL";
+  return length;
+}
+
+std::string_view format_message_view( std::string_view message, LogLevel level,
+                                      std::chrono::system_clock::time_point time, const char *file,
+                                      uint32_t line ) {
+  // Level, time, location and separators need a little headroom
+  size_t headroom = 64 + ( file != nullptr ? std::strlen( file ) + 16 : 0 );
+  if ( message.size() + headroom <= LOG_FORMAT_BUFFER_SIZE ) {
+    size_t length = format_message_to( formatBuffer, LOG_FORMAT_BUFFER_SIZE, message, level, time,
+                                       file, line );
+    return std::string_view( formatBuffer, length );
   }
-  return "UNKNOWN";
+
+  overflowBuffer.resize( message.size() + headroom );
+  size_t length = format_message_to( overflowBuffer.data(), overflowBuffer.size(), message, level,
+                                     time, file, line );
+  return std::string_view( overflowBuffer.data(), length );
 }
 
-std::string get_time_as_string() {
-  std::string time_string;
+void set_source_location_visible( bool visible ) {
+  sourceLocationVisible.store( visible, std::memory_order_relaxed );
+}
 
-  time_t current_time = std::chrono::system_clock::to_time_t(
-      std::chrono::system_clock::now() );
+bool is_source_location_visible() { return sourceLocationVisible.load( std::memory_order_relaxed ); }
+
+std::string log_level_to_string( LogLevel level ) { return std::string( log_level_name( level ) ); }
+
+std::string_view log_level_name( LogLevel level ) {
+  unsigned int bits = static_cast<unsigned int>( level & ALL );
+  if ( bits == 0 ) {
+    return LEVEL_NAMES[0];
+  }
+  return LEVEL_NAMES[std::countr_zero( bits )];
+}
 
-  std::time_t now = std::time( &current_time );
-  std::tm *ptm = std::localtime( &now );
+std::string get_time_as_string() { return get_time_as_string( std::chrono::system_clock::now() ); }
+
+std::string get_time_as_string( std::chrono::system_clock::time_point time ) {
   char buffer[32];
-  // Format: 02.12.2024 20:20:00
-  std::strftime( buffer, 32, "%d-%m-%Y %H:%M:%S", ptm );
-  return buffer;
+  size_t length = write_time( buffer, sizeof( buffer ), time );
+  return std::string( buffer, length );
+}
+
+size_t write_time( char *buffer, size_t capacity, std::chrono::system_clock::time_point time ) {
+  return write_timestamp( buffer, capacity, time );
+}
+
+std::string get_executable_directory() {
+  static std::string executableDirectory;
+  if ( executableDirectory.empty() ) {
+#ifdef __unix__
+    char result[PATH_MAX];
+    ssize_t count = readlink( "/proc/self/exe", result, PATH_MAX );
+    executableDirectory = std::string( result, ( count > 0 ) ? count : 0 );
+#elif defined( __APPLE__ )
+    char result[PATH_MAX];
+    uint32_t size = sizeof( result );
+    if ( _NSGetExecutablePath( result, &size ) == 0 ) {
+      executableDirectory = result;
+    }
+#elif _WIN32
+    wchar_t modulePath[MAX_PATH] = { 0 };
+    GetModuleFileNameW( NULL, modulePath, MAX_PATH );
+
+    std::wstring ws = std::wstring( modulePath );
+    std::string buffer( wcstombs( nullptr, ws.c_str(), 0 ), '\0' );
+    wcstombs( buffer.data(), ws.c_str(), buffer.size() + 1 );
+    executableDirectory = buffer;
+#endif
+    if ( executableDirectory.empty() ) {
+      // Unknown platform or the lookup failed, use the directory the engine was started from
+      std::error_code error;
+      executableDirectory = std::filesystem::current_path( error ).string();
+      return executableDirectory;
+    }
+    executableDirectory =
+        executableDirectory.substr( 0, executableDirectory.find_last_of( "\\/" ) );
+  }
+  return executableDirectory;
 }
+
 }  // namespace Logger
 }  // namespace Core
 }  // namespace Thumpy
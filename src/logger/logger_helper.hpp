@@ -10,7 +10,11 @@
  */
 
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace Thumpy {
 namespace Core {
@@ -28,13 +32,75 @@ enum LogLevel {
 
 /**
  * @brief Formats the message to the following:
- * [LOG_LEVEL] [DAY-MONTH-YEAR HOUR:MIN:SECOND]: MESSAGE
+ * [LOG_LEVEL] [DAY-MONTH-YEAR HOUR:MIN:SECOND.FRACTION]: MESSAGE
  * @param message
  * @param level
  * @return std::string
  */
 std::string format_message( const std::string *message, LogLevel level );
 
+/**
+ * @brief Formats the message using the time it was logged at
+ *
+ * @param message
+ * @param level
+ * @param time
+ * @return std::string
+ */
+std::string format_message( const std::string *message, LogLevel level,
+                            std::chrono::system_clock::time_point time );
+
+/**
+ * @brief Size of the per-thread buffer format_message_view writes into
+ * Lines longer than this fall back to a heap allocated buffer.
+ */
+const size_t LOG_FORMAT_BUFFER_SIZE = 1024;
+
+/**
+ * @brief Write the formatted line straight into a caller supplied buffer
+ * Output is truncated when it does not fit.
+ * @param buffer
+ * @param capacity
+ * @param message
+ * @param level
+ * @param time
+ * @param file appended as " (file:line)" when not null
+ * @param line
+ * @return size_t characters written
+ */
+size_t format_message_to( char *buffer, size_t capacity, std::string_view message, LogLevel level,
+                          std::chrono::system_clock::time_point time, const char *file = nullptr,
+                          uint32_t line = 0 );
+
+/**
+ * @brief Format into a reusable per-thread buffer
+ * Does not allocate when the line fits in LOG_FORMAT_BUFFER_SIZE.
+ * The view is valid until the next call on the same thread.
+ * @param message
+ * @param level
+ * @param time
+ * @param file appended as " (file:line)" when not null
+ * @param line
+ * @return std::string_view
+ */
+std::string_view format_message_view( std::string_view message, LogLevel level,
+                                      std::chrono::system_clock::time_point time,
+                                      const char *file = nullptr, uint32_t line = 0 );
+
+/**
+ * @brief Show where a record was logged from, for records logged with THUMPY_LOG
+ *
+ * @param visible
+ */
+void set_source_location_visible( bool visible );
+
+/**
+ * @brief Check if the source location is added to formatted records
+ *
+ * @return bool
+ */
+bool is_source_location_visible();
+
 /**
  * @brief Return log level as string
  *
@@ -43,13 +109,46 @@ std::string format_message( const std::string *message, LogLevel level );
  */
 std::string log_level_to_string( LogLevel level );
 
+/**
+ * @brief Return log level name from a static table
+ *
+ * @param level
+ * @return std::string_view
+ */
+std::string_view log_level_name( LogLevel level );
+
 /**
  * @brief Get current time as string
- * Format: [DAY-MONTH-YEAR HOUR:MIN:SECOND]
+ * Format: [DAY-MONTH-YEAR HOUR:MIN:SECOND.FRACTION]
  * @return std::string
  */
 std::string get_time_as_string();
 
+/**
+ * @brief Get time as string
+ * Format: [DAY-MONTH-YEAR HOUR:MIN:SECOND.FRACTION]
+ * @param time
+ * @return std::string
+ */
+std::string get_time_as_string( std::chrono::system_clock::time_point time );
+
+/**
+ * @brief Write time into buffer, see write_timestamp
+ * Format: DAY-MONTH-YEAR HOUR:MIN:SECOND.FRACTION
+ * @param buffer
+ * @param capacity
+ * @param time
+ * @return size_t characters written
+ */
+size_t write_time( char *buffer, size_t capacity, std::chrono::system_clock::time_point time );
+
+/**
+ * @brief Get the directory the executable lives in, without a trailing slash
+ * Cached after the first call.
+ * @return std::string
+ */
+std::string get_executable_directory();
+
 }  // namespace Logger
 }  // namespace Core
 }  // namespace Thumpy
@@ -0,0 +1,74 @@
+/**
+ * @file ring_sink.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief ring_sink cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ring_sink.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "logger_helper.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+RingSink::RingSink( size_t capacity, std::string dumpPath, int levels )
+    : Sink( levels ), records_( capacity > 0 ? capacity : 1 ), dumpPath_( std::move( dumpPath ) ) {}
+
+void RingSink::write( const LogRecord &record, std::string_view ) {
+  std::lock_guard<std::mutex> lock( mutex_ );
+  // Reuses the slot's inline storage, only long messages allocate
+  records_[next_] = record;
+  next_ = ( next_ + 1 ) % records_.size();
+  if ( count_ < records_.size() ) {
+    count_++;
+  }
+}
+
+void RingSink::on_critical() {
+  if ( !dumpPath_.empty() ) {
+    dump();
+  }
+}
+
+size_t RingSink::dump( std::ostream &out ) {
+  std::lock_guard<std::mutex> lock( mutex_ );
+  size_t first = ( next_ + records_.size() - count_ ) % records_.size();
+  for ( size_t i = 0; i < count_; i++ ) {
+    const LogRecord &record = records_[( first + i ) % records_.size()];
+    const char *file = is_source_location_visible() ? record.file : nullptr;
+    out << format_message_view( record.message(), record.level, record.time, file, record.line )
+        << '\n';
+  }
+  out.flush();
+  return count_;
+}
+
+bool RingSink::dump() {
+  // Called while the registry is dispatching, so failures can not be logged from here
+  std::ofstream file( dumpPath_, std::ofstream::out | std::ofstream::trunc );
+  if ( !file.is_open() ) {
+    return false;
+  }
+  dump( file );
+  return true;
+}
+
+size_t RingSink::size() {
+  std::lock_guard<std::mutex> lock( mutex_ );
+  return count_;
+}
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,79 @@
+/**
+ * @file ring_sink.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief In-memory sink keeping the last N records, dumped to disk on CRITICAL
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_record.hpp"
+#include "sink.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+const std::string ring_dump_path = "ring.dump";
+
+/**
+ * @brief Keeps the most recent records in memory without doing any I/O.
+ * Lets verbose tracing stay on and only reach the disk when something goes wrong.
+ */
+class RingSink : public Sink {
+ public:
+  /**
+   * @param capacity records kept, older records are overwritten
+   * @param dumpPath file written on CRITICAL, empty to never dump automatically
+   * @param levels LogLevel mask the sink accepts
+   */
+  explicit RingSink( size_t capacity, std::string dumpPath = ring_dump_path, int levels = ALL );
+
+  bool uses_text() const override { return false; }
+
+  void on_critical() override;
+
+  /**
+   * @brief Write the kept records, oldest first
+   *
+   * @param out
+   * @return size_t records written
+   */
+  size_t dump( std::ostream &out );
+
+  /**
+   * @brief Write the kept records to the dump path
+   *
+   * @return true if the file was written
+   */
+  bool dump();
+
+  size_t size();
+
+  size_t capacity() const { return records_.size(); }
+
+ protected:
+  void write( const LogRecord &record, std::string_view line ) override;
+
+ private:
+  std::mutex mutex_;
+  std::vector<LogRecord> records_;
+  std::string dumpPath_;
+  size_t next_ = 0;
+  size_t count_ = 0;
+};
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,155 @@
+/**
+ * @file sink.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief sink cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "sink.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "file_logger.hpp"
+#include "logger.hpp"
+#include "term_logger.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+#pragma region Sink
+
+Sink::Sink( int levels, size_t batchSize ) : levels_( levels ), batchSize_( batchSize ) {}
+
+void Sink::set_levels( int levels ) {
+  levels_.store( levels, std::memory_order_relaxed );
+  update_accepted_levels();
+}
+
+void Sink::submit( const LogRecord &record, std::string_view line ) {
+  write( record, line );
+  pending_++;
+  if ( batchSize_ > 0 && pending_ >= batchSize_ ) {
+    flush();
+    pending_ = 0;
+  }
+}
+
+void Sink::flush_pending( bool force ) {
+  if ( pending_ == 0 ) {
+    return;
+  }
+  if ( force || batchSize_ == 0 ) {
+    flush();
+    pending_ = 0;
+  }
+}
+
+#pragma endregion Sink
+
+#pragma region Registry
+
+namespace {
+
+std::mutex &registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// The file and terminal sinks are registered by default
+std::vector<std::shared_ptr<Sink>> &registry() {
+  static std::vector<std::shared_ptr<Sink>> sinks = { get_file_sink(), get_terminal_sink() };
+  return sinks;
+}
+
+}  // namespace
+
+void add_sink( std::shared_ptr<Sink> sink ) {
+  {
+    std::lock_guard<std::mutex> lock( registry_mutex() );
+    registry().push_back( std::move( sink ) );
+  }
+  update_accepted_levels();
+}
+
+void remove_sink( const std::shared_ptr<Sink> &sink ) {
+  {
+    std::lock_guard<std::mutex> lock( registry_mutex() );
+    auto &sinks = registry();
+    auto found = std::find( sinks.begin(), sinks.end(), sink );
+    if ( found == sinks.end() ) {
+      return;
+    }
+    ( *found )->flush_pending( true );
+    sinks.erase( found );
+  }
+  update_accepted_levels();
+}
+
+int registered_sink_levels() {
+  std::lock_guard<std::mutex> lock( registry_mutex() );
+  int levels = NONE;
+  for ( const auto &sink : registry() ) {
+    levels |= sink->levels();
+  }
+  return levels;
+}
+
+void dispatch_record( const LogRecord &record ) {
+  std::lock_guard<std::mutex> lock( registry_mutex() );
+  auto &sinks = registry();
+
+  // Only format when some sink wants the text
+  std::string_view line;
+  bool formatted = false;
+  for ( const auto &sink : sinks ) {
+    if ( !sink->accepts( record.level ) ) {
+      continue;
+    }
+    if ( sink->uses_text() && !formatted ) {
+      const char *file = is_source_location_visible() ? record.file : nullptr;
+      line = format_message_view( record.message(), record.level, record.time, file, record.line );
+      formatted = true;
+    }
+    sink->submit( record, sink->uses_text() ? line : std::string_view() );
+  }
+
+  if ( ( record.level & CRITICAL ) != 0 ) {
+    for ( const auto &sink : sinks ) {
+      sink->flush_pending( true );
+      sink->on_critical();
+    }
+  }
+}
+
+void submit_line( Sink &sink, LogLevel level, std::string_view line ) {
+  std::lock_guard<std::mutex> lock( registry_mutex() );
+  if ( !sink.accepts( level ) ) {
+    return;
+  }
+  LogRecord record;
+  record.time = std::chrono::system_clock::now();
+  record.level = level;
+  sink.submit( record, line );
+}
+
+void flush_registered_sinks( bool force ) {
+  std::lock_guard<std::mutex> lock( registry_mutex() );
+  for ( const auto &sink : registry() ) {
+    sink->flush_pending( force );
+  }
+}
+
+#pragma endregion Registry
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
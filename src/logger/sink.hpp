@@ -0,0 +1,140 @@
+/**
+ * @file sink.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Log sink interface and the registry write_record dispatches to
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "log_record.hpp"
+#include "logger_helper.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+/**
+ * @brief Somewhere log records end up.
+ * Writes are serialized by the registry, a sink only sees one record at a time.
+ */
+class Sink {
+ public:
+  /**
+   * @param levels LogLevel mask the sink accepts
+   * @param batchSize records written between flushes, 0 flushes whenever the logger does
+   */
+  explicit Sink( int levels = ALL, size_t batchSize = 0 );
+  virtual ~Sink() = default;
+
+  bool accepts( LogLevel level ) const {
+    return ( level & levels_.load( std::memory_order_relaxed ) ) != 0;
+  }
+
+  /**
+   * @brief Set the levels this sink accepts, also updates the logger's accepted levels
+   *
+   * @param levels LogLevel mask
+   */
+  void set_levels( int levels );
+
+  int levels() const { return levels_.load( std::memory_order_relaxed ); }
+
+  void set_batch_size( size_t batchSize ) { batchSize_ = batchSize; }
+
+  size_t batch_size() const { return batchSize_; }
+
+  /**
+   * @brief Write a record, flushing once a batch is full
+   *
+   * @param record
+   * @param line formatted record, empty when uses_text is false
+   */
+  void submit( const LogRecord &record, std::string_view line );
+
+  /**
+   * @brief Flush pending writes, batched sinks wait for a full batch unless forced
+   *
+   * @param force
+   */
+  void flush_pending( bool force );
+
+  /**
+   * @brief Does the sink want the formatted line, records are only formatted if one does
+   *
+   * @return bool
+   */
+  virtual bool uses_text() const { return true; }
+
+  /**
+   * @brief Called after a CRITICAL record has been written to every sink
+   *
+   */
+  virtual void on_critical() {}
+
+ protected:
+  virtual void write( const LogRecord &record, std::string_view line ) = 0;
+  virtual void flush() {}
+
+ private:
+  std::atomic<int> levels_;
+  size_t batchSize_;
+  size_t pending_ = 0;
+};
+
+/**
+ * @brief Register a sink, records written from now on reach it
+ *
+ * @param sink
+ */
+void add_sink( std::shared_ptr<Sink> sink );
+
+/**
+ * @brief Unregister a sink, flushing it first
+ *
+ * @param sink
+ */
+void remove_sink( const std::shared_ptr<Sink> &sink );
+
+/**
+ * @brief Levels accepted by at least one registered sink
+ *
+ * @return int LogLevel mask
+ */
+int registered_sink_levels();
+
+/**
+ * @brief Hand a record to every sink that accepts it
+ *
+ * @param record
+ */
+void dispatch_record( const LogRecord &record );
+
+/**
+ * @brief Hand an already formatted line to a single sink if it accepts level
+ * Serialized with dispatch_record, so it is safe while the async writer runs.
+ * @param sink
+ * @param level
+ * @param line
+ */
+void submit_line( Sink &sink, LogLevel level, std::string_view line );
+
+/**
+ * @brief Flush every registered sink
+ *
+ * @param force also flush batched sinks with a partial batch
+ */
+void flush_registered_sinks( bool force );
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -11,43 +11,65 @@
 
 #include "term_logger.hpp"
 
+#include <array>
+#include <bit>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 
+#include "logger.hpp"
 #include "logger_helper.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Logger {
 
-int term_log_vision = /* INFO | */ DEBUG | WARNING | ERROR_LOG | CRITICAL;
+namespace {
 
-void log_to_terminal( const std::string &message, LogLevel level ) {
-  if ( ( level & term_log_vision ) != 0 ) {
-    std::cout << terminal_color_from_level( level ) << message << std::endl;
-  }
+// Indexed by the highest set bit of the level, each entry resets the color first
+constexpr std::array<std::string_view, 6> LEVEL_COLORS = {
+    "\033[0m\033[45m",          // None of the above - Purple background
+    "\033[0m\033[1m",           // INFO - Highlighted
+    "\033[0m",                  // DEBUG - Default
+    "\033[0m\033[33m",          // WARNING - Yellow
+    "\033[0m\033[31m",          // ERROR - Red
+    "\033[0m\033[41m\033[1m" };  // CRITICAL - Red highlighted Background
+
+}  // namespace
+
+TerminalSink::TerminalSink( int levels, size_t batchSize ) : Sink( levels, batchSize ) {}
+
+void TerminalSink::write( const LogRecord &record, std::string_view line ) {
+  std::cout << terminal_color_view( record.level ) << line << '\n';
+}
+
+void TerminalSink::flush() { std::cout.flush(); }
+
+std::shared_ptr<TerminalSink> get_terminal_sink() {
+  static std::shared_ptr<TerminalSink> sink =
+      std::make_shared<TerminalSink>( /* INFO | */ DEBUG | WARNING | ERROR_LOG | CRITICAL );
+  return sink;
+}
+
+void log_to_terminal( std::string_view message, LogLevel level ) {
+  submit_line( *get_terminal_sink(), level, message );
 }
 
+void set_term_log_vision( int levels ) { get_terminal_sink()->set_levels( levels ); }
+
+int get_term_log_vision() { return get_terminal_sink()->levels(); }
+
 std::string terminal_color_from_level( LogLevel level ) {
-  std::string color_code = "\033[0m";  // Default
-  if ( ( level & CRITICAL ) != 0 ) {
-    return color_code.append(
-        "\033[41m\033[1m" );  // Red highlighted Background
-  }
-  if ( ( level & ERROR_LOG ) != 0 ) {
-    return color_code.append( "\033[31m" );  // Red
-  }
-  if ( ( level & WARNING ) != 0 ) {
-    return color_code.append( "\033[33m" );  // Yellow
-  }
-  if ( ( level & INFO ) != 0 ) {
-    return color_code.append( "\033[1m" );  // Highlighted
-  }
-  if ( ( level & DEBUG ) != 0 ) {
-    return color_code;  // Default
+  return std::string( terminal_color_view( level ) );
+}
+
+std::string_view terminal_color_view( LogLevel level ) {
+  unsigned int bits = static_cast<unsigned int>( level & ALL );
+  if ( bits == 0 ) {
+    return LEVEL_COLORS[0];
   }
-  return color_code.append(
-      "\033[45m" );  // None of the above - Purple background
+  return LEVEL_COLORS[std::bit_width( bits ) - 1];
 }
 }  // namespace Logger
 }  // namespace Core
@@ -11,21 +11,58 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "logger_helper.hpp"
+#include "sink.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Logger {
 
+/**
+ * @brief Writes colored records to std::cout
+ *
+ */
+class TerminalSink : public Sink {
+ public:
+  explicit TerminalSink( int levels = ALL, size_t batchSize = 0 );
+
+ protected:
+  void write( const LogRecord &record, std::string_view line ) override;
+  void flush() override;
+};
+
+/**
+ * @brief Get the terminal sink, registered by default
+ *
+ * @return std::shared_ptr<TerminalSink>
+ */
+std::shared_ptr<TerminalSink> get_terminal_sink();
+
 /**
  * @brief log message to terminal
  *
  * @param message
  * @param level
  */
-void log_to_terminal( const std::string &message, LogLevel level );
+void log_to_terminal( std::string_view message, LogLevel level );
+
+/**
+ * @brief Set levels written to the terminal
+ *
+ * @param levels LogLevel mask
+ */
+void set_term_log_vision( int levels );
+
+/**
+ * @brief Get levels written to the terminal
+ *
+ * @return int LogLevel mask
+ */
+int get_term_log_vision();
 
 /**
  * @brief get color value string from log level
@@ -35,6 +72,14 @@ void log_to_terminal( const std::string &message, LogLevel level );
  */
 std::string terminal_color_from_level( LogLevel level );
 
+/**
+ * @brief get color escape sequence from a static table
+ *
+ * @param level
+ * @return std::string_view
+ */
+std::string_view terminal_color_view( LogLevel level );
+
 }  // namespace Logger
 
 }  // namespace Core
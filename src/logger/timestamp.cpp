@@ -0,0 +1,112 @@
+/**
+ * @file timestamp.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief timestamp cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "timestamp.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+namespace {
+
+std::atomic<TimestampPrecision> timestampPrecision{ MILLISECONDS };
+
+// Formatted "DAY-MONTH-YEAR HOUR:MIN:SECOND" for the last second seen by this thread
+struct SecondCache {
+  int64_t second = INT64_MIN;
+  char prefix[32];
+  size_t length = 0;
+};
+
+thread_local SecondCache secondCache;
+
+void rebuild_prefix( SecondCache &cache, int64_t second ) {
+  std::time_t seconds = static_cast<std::time_t>( second );
+  std::tm local{};
+#ifdef _WIN32
+  localtime_s( &local, &seconds );
+#else
+  localtime_r( &seconds, &local );
+#endif
+  // Format: 02-12-2024 20:20:00
+  cache.length = std::strftime( cache.prefix, sizeof( cache.prefix ), "%d-%m-%Y %H:%M:%S", &local );
+  cache.second = second;
+}
+
+// Write value as exactly `digits` zero padded digits
+void write_digits( char *buffer, uint32_t value, size_t digits ) {
+  for ( size_t i = digits; i > 0; i-- ) {
+    buffer[i - 1] = static_cast<char>( '0' + value % 10 );
+    value /= 10;
+  }
+}
+
+}  // namespace
+
+void set_timestamp_precision( TimestampPrecision precision ) {
+  timestampPrecision.store( precision, std::memory_order_relaxed );
+}
+
+TimestampPrecision get_timestamp_precision() {
+  return timestampPrecision.load( std::memory_order_relaxed );
+}
+
+size_t write_timestamp( char *buffer, size_t capacity, std::chrono::system_clock::time_point time ) {
+  return write_timestamp( buffer, capacity, time, get_timestamp_precision() );
+}
+
+size_t write_timestamp( char *buffer, size_t capacity, std::chrono::system_clock::time_point time,
+                        TimestampPrecision precision ) {
+  auto sinceEpoch = time.time_since_epoch();
+  auto seconds = std::chrono::floor<std::chrono::seconds>( sinceEpoch );
+  uint32_t micros = static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>( sinceEpoch - seconds ).count() );
+
+  // Only touch the C time functions when the second changes
+  if ( secondCache.second != seconds.count() ) {
+    rebuild_prefix( secondCache, seconds.count() );
+  }
+
+  char fraction[8];
+  size_t fractionLength = 0;
+  switch ( precision ) {
+    case MILLISECONDS:
+      fraction[0] = '.';
+      write_digits( fraction + 1, micros / 1000, 3 );
+      fractionLength = 4;
+      break;
+    case MICROSECONDS:
+      fraction[0] = '.';
+      write_digits( fraction + 1, micros, 6 );
+      fractionLength = 7;
+      break;
+    case SECONDS:
+    default:
+      break;
+  }
+
+  size_t length = std::min( secondCache.length, capacity );
+  std::memcpy( buffer, secondCache.prefix, length );
+  size_t count = std::min( fractionLength, capacity - length );
+  std::memcpy( buffer + length, fraction, count );
+  return length + count;
+}
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,62 @@
+/**
+ * @file timestamp.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Cached timestamp formatting for log lines
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace Thumpy {
+namespace Core {
+namespace Logger {
+
+enum TimestampPrecision { SECONDS, MILLISECONDS, MICROSECONDS };
+
+/**
+ * @brief Set the sub-second digits appended to every timestamp
+ *
+ * @param precision
+ */
+void set_timestamp_precision( TimestampPrecision precision );
+
+/**
+ * @brief Get the sub-second digits appended to every timestamp
+ *
+ * @return TimestampPrecision
+ */
+TimestampPrecision get_timestamp_precision();
+
+/**
+ * @brief Write timestamp into buffer using the global precision
+ * Format: DAY-MONTH-YEAR HOUR:MIN:SECOND.FRACTION
+ * @param buffer
+ * @param capacity
+ * @param time
+ * @return size_t characters written
+ */
+size_t write_timestamp( char *buffer, size_t capacity, std::chrono::system_clock::time_point time );
+
+/**
+ * @brief Write timestamp into buffer
+ * The date / time prefix is cached per thread and only rebuilt when the second changes,
+ * the fraction is appended digit by digit.
+ * @param buffer
+ * @param capacity
+ * @param time
+ * @param precision
+ * @return size_t characters written
+ */
+size_t write_timestamp( char *buffer, size_t capacity, std::chrono::system_clock::time_point time,
+                        TimestampPrecision precision );
+
+}  // namespace Logger
+}  // namespace Core
+}  // namespace Thumpy
@@ -1,5 +1,7 @@
 
 
+#include <channel.hpp>
+#include <flight_recorder.hpp>
 #include <input_manager.hpp>
 #include <logger.hpp>
 #include <window_manager.hpp>
@@ -11,7 +13,14 @@ bool APPLICATION_RUNNING = true;
 Thumpy::Core::Windows::WindowManager *window_manager;
 
 int main() {
-  Thumpy::Core::Logger::init();
+  // Write log records from a background thread so the render loop never waits on I/O
+  Thumpy::Core::Logger::init( Thumpy::Core::Logger::AsyncOptions() );
+  // Keep recent records & frame stats in memory, dumped on CRITICAL / crash / SIGINT
+  Thumpy::Core::Logger::enable_flight_recorder();
+  // Channel levels can be changed at runtime by editing log_channels.cfg next to the executable
+  Thumpy::Core::Logger::watch_channel_config(
+      Thumpy::Core::Logger::get_executable_directory() + "/" +
+      Thumpy::Core::Logger::channel_config_path );
   Thumpy::Core::Logger::log( "Starting Engine...", Thumpy::Core::Logger::INFO );
 
   Thumpy::Core::IO::init();
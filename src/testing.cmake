@@ -9,6 +9,7 @@ find_package(GTest CONFIG REQUIRED)
 enable_testing()
 
 set(TEST_SOURCES
+  testing/alloc_counter.cc
   testing/logger_test.cc
   testing/window_manager_test.cc
 )
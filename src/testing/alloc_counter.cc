@@ -0,0 +1,135 @@
+/**
+ * @file alloc_counter.cc
+ * @author Thumpy (◕‿◕✿)
+ * @brief Replaces the global allocation functions to count allocations per thread
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+
+#include "alloc_counter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+thread_local size_t threadAllocations = 0;
+}  // namespace
+
+namespace Thumpy {
+namespace Testing {
+
+size_t allocation_count() { return threadAllocations; }
+
+}  // namespace Testing
+}  // namespace Thumpy
+
+namespace {
+
+void *allocate( size_t size ) {
+  threadAllocations++;
+  if ( size == 0 ) {
+    size = 1;
+  }
+  return std::malloc( size );
+}
+
+void *allocate_aligned( size_t size, std::align_val_t alignment ) {
+  threadAllocations++;
+  if ( size == 0 ) {
+    size = 1;
+  }
+#ifdef _WIN32
+  return _aligned_malloc( size, static_cast<size_t>( alignment ) );
+#else
+  void *pointer = nullptr;
+  size_t align = std::max( static_cast<size_t>( alignment ), sizeof( void * ) );
+  if ( posix_memalign( &pointer, align, size ) != 0 ) {
+    return nullptr;
+  }
+  return pointer;
+#endif
+}
+
+void free_aligned( void *pointer ) {
+#ifdef _WIN32
+  _aligned_free( pointer );
+#else
+  std::free( pointer );
+#endif
+}
+
+}  // namespace
+
+// Replace the global allocation functions so every form of operator new is counted
+void *operator new( size_t size ) {
+  if ( void *pointer = allocate( size ) ) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[]( size_t size ) { return operator new( size ); }
+
+void *operator new( size_t size, const std::nothrow_t & ) noexcept { return allocate( size ); }
+
+void *operator new[]( size_t size, const std::nothrow_t & ) noexcept { return allocate( size ); }
+
+void *operator new( size_t size, std::align_val_t alignment ) {
+  if ( void *pointer = allocate_aligned( size, alignment ) ) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[]( size_t size, std::align_val_t alignment ) {
+  return operator new( size, alignment );
+}
+
+void *operator new( size_t size, std::align_val_t alignment, const std::nothrow_t & ) noexcept {
+  return allocate_aligned( size, alignment );
+}
+
+void *operator new[]( size_t size, std::align_val_t alignment, const std::nothrow_t & ) noexcept {
+  return allocate_aligned( size, alignment );
+}
+
+void operator delete( void *pointer ) noexcept { std::free( pointer ); }
+
+void operator delete[]( void *pointer ) noexcept { std::free( pointer ); }
+
+void operator delete( void *pointer, size_t ) noexcept { std::free( pointer ); }
+
+void operator delete[]( void *pointer, size_t ) noexcept { std::free( pointer ); }
+
+void operator delete( void *pointer, const std::nothrow_t & ) noexcept { std::free( pointer ); }
+
+void operator delete[]( void *pointer, const std::nothrow_t & ) noexcept { std::free( pointer ); }
+
+void operator delete( void *pointer, std::align_val_t ) noexcept { free_aligned( pointer ); }
+
+void operator delete[]( void *pointer, std::align_val_t ) noexcept { free_aligned( pointer ); }
+
+void operator delete( void *pointer, size_t, std::align_val_t ) noexcept {
+  free_aligned( pointer );
+}
+
+void operator delete[]( void *pointer, size_t, std::align_val_t ) noexcept {
+  free_aligned( pointer );
+}
+
+void operator delete( void *pointer, std::align_val_t, const std::nothrow_t & ) noexcept {
+  free_aligned( pointer );
+}
+
+void operator delete[]( void *pointer, std::align_val_t, const std::nothrow_t & ) noexcept {
+  free_aligned( pointer );
+}
@@ -0,0 +1,42 @@
+/**
+ * @file alloc_counter.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Counts heap allocations made by the calling thread
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace Thumpy {
+namespace Testing {
+
+/**
+ * @brief Number of operator new calls made by this thread, every form: plain, array, aligned &
+ * nothrow. malloc isn't replaced, so allocations made inside drivers & C libraries aren't counted
+ *
+ * @return size_t
+ */
+size_t allocation_count();
+
+/**
+ * @brief Counts allocations made by this thread while in scope
+ *
+ */
+class AllocationScope {
+ public:
+  AllocationScope() : start_( allocation_count() ) {}
+
+  size_t allocations() const { return allocation_count() - start_; }
+
+ private:
+  size_t start_;
+};
+
+}  // namespace Testing
+}  // namespace Thumpy
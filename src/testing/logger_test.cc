@@ -1,14 +1,32 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <ios>
 #include <logger.hpp>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 #include <string>
+#include <vector>
 
+#include "alloc_counter.hpp"
+#include "async_logger.hpp"
+#include "binary_logger.hpp"
+#include "channel.hpp"
 #include "file_logger.hpp"
+#include "flight_recorder.hpp"
+#include "log_rotation.hpp"
 #include "logger_helper.hpp"
+#include "ring_sink.hpp"
+#include "sink.hpp"
 #include "term_logger.hpp"
+#include "timestamp.hpp"
 
 namespace Thumpy {
 namespace Core {
@@ -37,7 +55,7 @@ TEST( logger, test_file_logger_write ) {
   EXPECT_FALSE( Logger::get_log_file()->is_open() );
 
   // Open File
-  std::ifstream file_stream( Logger::log_path, std::ios::in );
+  std::ifstream file_stream( Logger::get_log_file_path(), std::ios::in );
   EXPECT_TRUE( file_stream.is_open() );
 
   // Read file
@@ -47,6 +65,617 @@ TEST( logger, test_file_logger_write ) {
   // Validate equal
   EXPECT_EQ( line, test_string );
 }
+
+TEST( logger, test_format_message ) {
+  std::string test_string = "test_message";
+  auto time = std::chrono::system_clock::now();
+  std::string line( Logger::format_message_view( test_string, Logger::WARNING, time ) );
+
+  EXPECT_EQ( line, "[WARNING] [" + Logger::get_time_as_string( time ) + "]: test_message" );
+  EXPECT_EQ( line, Logger::format_message( &test_string, Logger::WARNING, time ) );
+  EXPECT_EQ( Logger::log_level_name( Logger::ERROR_LOG ), "ERROR" );
+  EXPECT_EQ( Logger::log_level_name( Logger::NONE ), "UNKNOWN" );
+}
+
+TEST( logger, test_format_message_does_not_allocate ) {
+  std::string message( 200, 'x' );
+  auto time = std::chrono::system_clock::now();
+
+  // Warm up, first call may load time zone data
+  Logger::format_message_view( message, Logger::INFO, time );
+
+  // Make sure the counter sees this thread's allocations
+  {
+    Testing::AllocationScope sanity;
+    std::string copy( message );
+    EXPECT_EQ( sanity.allocations(), 1 );
+
+    // Aligned & nothrow forms too, volatile so the pairs can't be elided
+    struct alignas( 64 ) Aligned {
+      char data[64];
+    };
+    Aligned *volatile aligned = new Aligned;
+    delete aligned;
+    int *volatile nothrow = new ( std::nothrow ) int( 0 );
+    delete nothrow;
+    EXPECT_EQ( sanity.allocations(), 3 );
+  }
+
+  Testing::AllocationScope scope;
+  size_t total = 0;
+  for ( int i = 0; i < 1000; i++ ) {
+    total += Logger::format_message_view( message, Logger::DEBUG, time ).size();
+    total += Logger::log_level_name( Logger::CRITICAL ).size();
+  }
+  EXPECT_EQ( scope.allocations(), 0 );
+  EXPECT_GT( total, 0 );
+}
+
+TEST( logger, test_sync_log_does_not_allocate ) {
+  std::string message( 200, 'y' );
+
+  Logger::init();
+  // Warm up file stream buffers
+  Logger::log( message, Logger::INFO );
+
+  Testing::AllocationScope scope;
+  for ( int i = 0; i < 100; i++ ) {
+    Logger::log( message, Logger::INFO );
+  }
+  EXPECT_EQ( scope.allocations(), 0 );
+
+  Logger::close_logger();
+}
+
+TEST( logger, test_timestamp_precision ) {
+  using namespace std::chrono;
+  auto second = floor<seconds>( system_clock::now() );
+  auto time = second + microseconds( 123456 );
+
+  // Prefix matches strftime
+  std::time_t seconds_since_epoch = system_clock::to_time_t( second );
+  char expected[32];
+  std::strftime( expected, sizeof( expected ), "%d-%m-%Y %H:%M:%S",
+                 std::localtime( &seconds_since_epoch ) );
+
+  char buffer[64];
+  size_t length = Logger::write_timestamp( buffer, sizeof( buffer ), time, Logger::SECONDS );
+  EXPECT_EQ( std::string( buffer, length ), expected );
+
+  length = Logger::write_timestamp( buffer, sizeof( buffer ), time, Logger::MILLISECONDS );
+  EXPECT_EQ( std::string( buffer, length ), std::string( expected ) + ".123" );
+
+  length = Logger::write_timestamp( buffer, sizeof( buffer ), time, Logger::MICROSECONDS );
+  EXPECT_EQ( std::string( buffer, length ), std::string( expected ) + ".123456" );
+
+  // Cached prefix is rebuilt when the second changes
+  length = Logger::write_timestamp( buffer, sizeof( buffer ), time + seconds( 1 ),
+                                    Logger::SECONDS );
+  EXPECT_NE( std::string( buffer, length ), expected );
+
+  // Truncates instead of overflowing
+  length = Logger::write_timestamp( buffer, 5, time, Logger::MICROSECONDS );
+  EXPECT_EQ( length, 5 );
+}
+
+TEST( logger, test_record_queue_bounds ) {
+  Logger::RecordQueue queue( 4 );
+  EXPECT_EQ( queue.capacity(), 4 );
+
+  // Fill queue
+  for ( int i = 0; i < 4; i++ ) {
+    Logger::LogRecord record;
+    record.set_message( std::to_string( i ) );
+    EXPECT_TRUE( queue.try_push( record ) );
+  }
+
+  // Queue is full
+  Logger::LogRecord overflow;
+  overflow.set_message( "overflow" );
+  EXPECT_FALSE( queue.try_push( overflow ) );
+
+  // Pop in order
+  Logger::LogRecord record;
+  for ( int i = 0; i < 4; i++ ) {
+    EXPECT_TRUE( queue.try_pop( record ) );
+    EXPECT_EQ( record.message(), std::to_string( i ) );
+  }
+  EXPECT_FALSE( queue.try_pop( record ) );
+  EXPECT_TRUE( queue.empty() );
+}
+
+TEST( logger, test_async_logger_drains_on_close ) {
+  const int record_count = 1000;
+
+  // Small queue so producers have to wait on the writer
+  Logger::AsyncOptions options;
+  options.capacity = 16;
+  options.batchSize = 8;
+  options.overflow = Logger::BLOCK;
+  Logger::init( options );
+  EXPECT_TRUE( Logger::is_async() );
+
+  for ( int i = 0; i < record_count; i++ ) {
+    Logger::log( "async_message_" + std::to_string( i ), Logger::INFO );
+  }
+
+  // Close logger, everything queued has to reach the file
+  Logger::close_logger();
+  EXPECT_FALSE( Logger::is_async() );
+
+  std::ifstream file_stream( Logger::get_log_file_path(), std::ios::in );
+  EXPECT_TRUE( file_stream.is_open() );
+
+  int found = 0;
+  std::string line;
+  while ( std::getline( file_stream, line ) ) {
+    if ( line.ends_with( "]: async_message_" + std::to_string( found ) ) ) {
+      found++;
+    }
+  }
+  EXPECT_EQ( found, record_count );
+}
+
+TEST( logger, test_async_logger_stops_while_logging ) {
+  const int thread_count = 4;
+  const int record_count = 2000;
+
+  Logger::AsyncOptions options;
+  options.capacity = 64;
+  options.overflow = Logger::BLOCK;
+  Logger::init( options );
+
+  // Producers keep logging through stop_async, nothing may be lost either side of it
+  std::vector<std::thread> producers;
+  for ( int t = 0; t < thread_count; t++ ) {
+    producers.emplace_back( [t] {
+      for ( int i = 0; i < record_count; i++ ) {
+        Logger::log( "stop_message_" + std::to_string( t ) + "_" + std::to_string( i ),
+                     Logger::INFO );
+      }
+    } );
+  }
+  std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  Logger::stop_async();
+  EXPECT_FALSE( Logger::is_async() );
+  for ( std::thread &producer : producers ) {
+    producer.join();
+  }
+  Logger::close_logger();
+
+  std::ifstream file_stream( Logger::get_log_file_path(), std::ios::in );
+  EXPECT_TRUE( file_stream.is_open() );
+
+  int found = 0;
+  std::string line;
+  while ( std::getline( file_stream, line ) ) {
+    if ( line.find( "]: stop_message_" ) != std::string::npos ) {
+      found++;
+    }
+  }
+  EXPECT_EQ( found, thread_count * record_count );
+}
+
+static int count_evaluations( int *counter ) {
+  ( *counter )++;
+  return *counter;
+}
+
+TEST( logger, test_filtered_log_skips_arguments ) {
+  Logger::init();
+  int file_vision = Logger::get_file_log_vision();
+  int term_vision = Logger::get_term_log_vision();
+
+  // No sink wants DEBUG, its arguments must not be evaluated
+  Logger::set_file_log_vision( Logger::INFO );
+  Logger::set_term_log_vision( Logger::NONE );
+  int evaluations = 0;
+  THUMPY_LOG( Logger::DEBUG, "filtered_", count_evaluations( &evaluations ) );
+  EXPECT_EQ( evaluations, 0 );
+
+  THUMPY_LOG( Logger::INFO, "accepted_", count_evaluations( &evaluations ) );
+  EXPECT_EQ( evaluations, 1 );
+
+  Logger::set_file_log_vision( file_vision );
+  Logger::set_term_log_vision( term_vision );
+  Logger::close_logger();
+}
+
+TEST( logger, test_message_builder ) {
+  std::string name = "mesh";
+  Logger::MessageBuilder builder;
+  builder.append( "Loading " );
+  builder.append( name );
+  builder.append( ' ' );
+  builder.append( 42 );
+  builder.append( " / " );
+  builder.append( 1.5 );
+  builder.append( " " );
+  builder.append( true );
+  EXPECT_EQ( builder.view(), "Loading mesh 42 / 1.5 true" );
+
+  // A new builder starts empty, long messages spill over without truncating
+  Logger::MessageBuilder long_builder;
+  std::string chunk( 300, 'x' );
+  for ( int i = 0; i < 5; i++ ) {
+    long_builder.append( chunk );
+  }
+  EXPECT_EQ( long_builder.view(), std::string( 1500, 'x' ) );
+
+  Logger::MessageBuilder short_builder;
+  short_builder.append( "short" );
+  EXPECT_EQ( short_builder.view(), "short" );
+}
+
+TEST( logger, test_binary_log_round_trip ) {
+  const std::string binary_path = "binary_log_test.bin";
+  ASSERT_TRUE( Logger::open_binary_log( binary_path, 64 * 1024, Logger::ALL & ~Logger::DEBUG ) );
+
+  std::string mesh = "viking_room.obj";
+  for ( int i = 0; i < 3; i++ ) {
+    THUMPY_BLOG( Logger::INFO, "Frame {} drew {} in {} ms", i, mesh, 1.5 );
+  }
+  THUMPY_BLOG( Logger::WARNING, "Frames in flight: {}", 2u );
+  // Not accepted by the binary sink
+  THUMPY_BLOG( Logger::DEBUG, "Filtered {}", 0 );
+  Logger::close_binary_log();
+  EXPECT_FALSE( Logger::is_binary_level_accepted( Logger::INFO ) );
+
+  std::stringstream decoded;
+  EXPECT_EQ( Logger::decode_binary_log( binary_path, decoded ), 4 );
+
+  std::string line;
+  for ( int i = 0; i < 3; i++ ) {
+    ASSERT_TRUE( std::getline( decoded, line ) );
+    EXPECT_TRUE( line.starts_with( "[INFO] [" ) );
+    EXPECT_TRUE(
+        line.ends_with( "]: Frame " + std::to_string( i ) + " drew viking_room.obj in 1.5 ms" ) );
+  }
+  ASSERT_TRUE( std::getline( decoded, line ) );
+  EXPECT_TRUE( line.starts_with( "[WARNING] [" ) );
+  EXPECT_TRUE( line.ends_with( "]: Frames in flight: 2" ) );
+  EXPECT_FALSE( std::getline( decoded, line ) );
+}
+
+TEST( logger, test_binary_log_full_drops ) {
+  const std::string binary_path = "binary_log_full_test.bin";
+  ASSERT_TRUE( Logger::open_binary_log( binary_path, 256 ) );
+
+  for ( int i = 0; i < 100; i++ ) {
+    THUMPY_BLOG( Logger::INFO, "Record {}", i );
+  }
+  EXPECT_GT( Logger::binary_dropped_count(), 0 );
+  Logger::close_binary_log();
+
+  // Everything that fit is still readable
+  std::stringstream decoded;
+  size_t records = Logger::decode_binary_log( binary_path, decoded );
+  EXPECT_GT( records, 0 );
+  EXPECT_EQ( records + Logger::binary_dropped_count(), 100 );
+}
+
+TEST( logger, test_binary_log_empty_is_valid ) {
+  const std::string binary_path = "binary_log_empty_test.bin";
+  ASSERT_TRUE( Logger::open_binary_log( binary_path, 4096 ) );
+  Logger::close_binary_log();
+
+  std::stringstream decoded;
+  bool valid = false;
+  EXPECT_EQ( Logger::decode_binary_log( binary_path, decoded, &valid ), 0 );
+  EXPECT_TRUE( valid );
+
+  EXPECT_EQ( Logger::decode_binary_log( "binary_log_missing.bin", decoded, &valid ), 0 );
+  EXPECT_FALSE( valid );
+}
+
+TEST( logger, test_binary_log_close_while_writing ) {
+  const std::string binary_path = "binary_log_close_test.bin";
+  ASSERT_TRUE( Logger::open_binary_log( binary_path, 1024 * 1024 ) );
+
+  // Writers keep going after the log is closed, their records are dropped instead of written
+  // to unmapped memory
+  std::vector<std::thread> writers;
+  for ( int t = 0; t < 4; t++ ) {
+    writers.emplace_back( [] {
+      for ( int i = 0; i < 5000; i++ ) {
+        THUMPY_BLOG( Logger::INFO, "Closing {}", i );
+      }
+    } );
+  }
+  std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  Logger::close_binary_log();
+  for ( std::thread &writer : writers ) {
+    writer.join();
+  }
+
+  std::stringstream decoded;
+  size_t records = Logger::decode_binary_log( binary_path, decoded );
+  EXPECT_GT( records, 0 );
+  // Records logged after the level mask was cleared never reach the log
+  EXPECT_LE( records + Logger::binary_dropped_count(), 4 * 5000 );
+}
+
+class CountingSink : public Logger::Sink {
+ public:
+  CountingSink( int levels, size_t batch_size ) : Logger::Sink( levels, batch_size ) {}
+
+  int writes = 0;
+  int flushes = 0;
+
+ protected:
+  void write( const Logger::LogRecord &, std::string_view ) override { writes++; }
+  void flush() override { flushes++; }
+};
+
+TEST( logger, test_sink_levels_and_batching ) {
+  auto sink = std::make_shared<CountingSink>( Logger::WARNING, 4 );
+  Logger::add_sink( sink );
+  EXPECT_NE( Logger::registered_sink_levels() & Logger::WARNING, 0 );
+
+  for ( int i = 0; i < 10; i++ ) {
+    Logger::log( "sink_warning", Logger::WARNING );
+    Logger::log( "sink_info", Logger::INFO );
+  }
+  // Only warnings reach the sink, flushed once per full batch of 4
+  EXPECT_EQ( sink->writes, 10 );
+  EXPECT_EQ( sink->flushes, 2 );
+
+  // Removing flushes the partial batch
+  Logger::remove_sink( sink );
+  EXPECT_EQ( sink->flushes, 3 );
+  Logger::log( "sink_warning", Logger::WARNING );
+  EXPECT_EQ( sink->writes, 10 );
+}
+
+TEST( logger, test_ring_sink_dumps_on_critical ) {
+  auto ring = std::make_shared<Logger::RingSink>( 4 );
+  Logger::add_sink( ring );
+  int term_vision = Logger::get_term_log_vision();
+  Logger::set_term_log_vision( Logger::NONE );
+
+  for ( int i = 0; i < 10; i++ ) {
+    Logger::log( "ring_" + std::to_string( i ), Logger::DEBUG );
+  }
+  EXPECT_EQ( ring->size(), 4 );
+  EXPECT_THROW( Logger::log( "ring_critical", Logger::CRITICAL ), std::runtime_error );
+
+  Logger::remove_sink( ring );
+  Logger::set_term_log_vision( term_vision );
+
+  // Oldest kept record first, ending with the critical one
+  std::ifstream file_stream( Logger::ring_dump_path, std::ios::in );
+  ASSERT_TRUE( file_stream.is_open() );
+  std::vector<std::string> lines;
+  std::string line;
+  while ( std::getline( file_stream, line ) ) {
+    lines.push_back( line );
+  }
+  ASSERT_EQ( lines.size(), 4 );
+  EXPECT_TRUE( lines[0].ends_with( "]: ring_7" ) );
+  EXPECT_TRUE( lines[2].ends_with( "]: ring_9" ) );
+  EXPECT_TRUE( lines[3].starts_with( "[CRITICAL]" ) );
+  EXPECT_TRUE( lines[3].ends_with( "]: ring_critical" ) );
+}
+
+static std::vector<std::string> read_lines( const std::string &path ) {
+  std::ifstream file_stream( path, std::ios::in );
+  std::vector<std::string> lines;
+  std::string line;
+  while ( std::getline( file_stream, line ) ) {
+    lines.push_back( line );
+  }
+  return lines;
+}
+
+TEST( logger, test_flight_recorder_dump ) {
+  const std::string dump_path = "flight_test.dump";
+  std::remove( dump_path.c_str() );
+  int term_vision = Logger::get_term_log_vision();
+  Logger::set_term_log_vision( Logger::NONE );
+
+  Logger::enable_flight_recorder( dump_path );
+  for ( size_t i = 0; i < Logger::FLIGHT_RECORD_CAPACITY + 10; i++ ) {
+    Logger::log( "flight_" + std::to_string( i ), Logger::DEBUG );
+  }
+  Logger::record_frame_stats( 1.25f );
+  Logger::record_frame_stats( 2.5f );
+
+  // CRITICAL dumps the recorder before throwing
+  EXPECT_THROW( Logger::log( "flight_critical", Logger::CRITICAL ), std::runtime_error );
+  Logger::disable_flight_recorder();
+  Logger::set_term_log_vision( term_vision );
+  EXPECT_FALSE( Logger::dump_flight_recorder() );
+
+  std::vector<std::string> lines = read_lines( dump_path );
+  ASSERT_GE( lines.size(), Logger::FLIGHT_RECORD_CAPACITY );
+  // Oldest records were overwritten
+  EXPECT_TRUE( lines[0].starts_with( "[DEBUG] [" ) );
+  EXPECT_TRUE( lines[0].ends_with( " UTC]: flight_11" ) );
+  EXPECT_TRUE( lines[Logger::FLIGHT_RECORD_CAPACITY - 1].starts_with( "[CRITICAL]" ) );
+  EXPECT_TRUE( lines[Logger::FLIGHT_RECORD_CAPACITY - 1].ends_with( "]: flight_critical" ) );
+
+  std::string last_frame = lines.back();
+  EXPECT_TRUE( last_frame.starts_with( "[FRAME] [" ) );
+  EXPECT_TRUE( last_frame.ends_with( " ms, cpu 2.500 ms" ) );
+}
+
+#ifdef __unix__
+TEST( logger, test_flight_recorder_dumps_on_crash ) {
+  const std::string dump_path = "flight_crash_test.dump";
+  std::remove( dump_path.c_str() );
+
+  EXPECT_EXIT(
+      {
+        Logger::enable_flight_recorder( dump_path );
+        Logger::log( "before_crash", Logger::INFO );
+        std::raise( SIGSEGV );
+      },
+      testing::KilledBySignal( SIGSEGV ), "" );
+
+  bool found = false;
+  for ( const std::string &line : read_lines( dump_path ) ) {
+    found |= line.ends_with( "]: before_crash" );
+  }
+  EXPECT_TRUE( found );
+}
+#endif
+
+static std::vector<std::string> rotated_logs( const std::string &directory ) {
+  std::vector<std::string> names;
+  for ( const auto &entry : std::filesystem::directory_iterator( directory ) ) {
+    std::string name = entry.path().filename().string();
+    if ( name.starts_with( "rotation.2" ) ) {
+      names.push_back( name );
+    }
+  }
+  return names;
+}
+
+TEST( logger, test_log_rotation_by_size ) {
+  const std::string directory = "rotation_test";
+  std::filesystem::remove_all( directory );
+  std::filesystem::create_directory( directory );
+  const std::string path = directory + "/rotation.dump";
+
+  std::ofstream file;
+  Logger::FileSink sink( &file );
+  Logger::RotationOptions options;
+  options.maxBytes = 256;
+  options.retainedFiles = 3;
+  options.compress = true;
+  sink.set_rotation( options );
+  ASSERT_TRUE( sink.open( path ) );
+
+  // ~64 byte lines, rotates every 4 lines
+  std::string line( 63, 'r' );
+  for ( int i = 0; i < 40; i++ ) {
+    sink.write_line( line, std::chrono::system_clock::now() );
+  }
+  sink.close();
+  Logger::wait_for_rotations();
+
+  // Only the newest rotated logs are kept, all compressed
+  std::vector<std::string> rotated = rotated_logs( directory );
+  EXPECT_EQ( rotated.size(), 3 );
+  for ( const std::string &name : rotated ) {
+    EXPECT_TRUE( name.ends_with( ".dump.gz" ) );
+  }
+  EXPECT_LE( std::filesystem::file_size( path ), 256 );
+
+  // Reopening keeps the previous session's log
+  ASSERT_TRUE( sink.open( path ) );
+  sink.close();
+  Logger::wait_for_rotations();
+  EXPECT_EQ( rotated_logs( directory ).size(), 3 );
+  EXPECT_EQ( std::filesystem::file_size( path ), 0 );
+  Logger::stop_rotation_worker();
+}
+
+TEST( logger, test_log_rotation_by_time ) {
+  const std::string directory = "rotation_time_test";
+  std::filesystem::remove_all( directory );
+  std::filesystem::create_directory( directory );
+  const std::string path = directory + "/rotation.dump";
+
+  std::ofstream file;
+  Logger::FileSink sink( &file );
+  Logger::RotationOptions options;
+  options.interval = std::chrono::seconds( 60 );
+  options.compress = false;
+  sink.set_rotation( options );
+  ASSERT_TRUE( sink.open( path ) );
+
+  auto now = std::chrono::system_clock::now();
+  sink.write_line( "before", now );
+  EXPECT_TRUE( rotated_logs( directory ).empty() );
+  // A record past the interval rotates the file first
+  sink.write_line( "after", now + std::chrono::seconds( 61 ) );
+  sink.close();
+  Logger::wait_for_rotations();
+
+  std::vector<std::string> rotated = rotated_logs( directory );
+  ASSERT_EQ( rotated.size(), 1 );
+  EXPECT_TRUE( rotated[0].ends_with( ".dump" ) );
+  std::ifstream rotated_stream( directory + "/" + rotated[0] );
+  std::string line;
+  ASSERT_TRUE( std::getline( rotated_stream, line ) );
+  EXPECT_EQ( line, "before" );
+  Logger::stop_rotation_worker();
+}
+
+TEST( logger, test_prune_rotated_logs_order ) {
+  const std::string directory = "rotation_prune_test";
+  std::filesystem::remove_all( directory );
+  std::filesystem::create_directory( directory );
+  const std::string path = directory + "/rotation.dump";
+
+  // More than 1000 rotations within one second
+  for ( const char *name :
+        { "rotation.20261016-204620-000.dump", "rotation.20261016-204621-999.dump",
+          "rotation.20261016-204621-1000.dump" } ) {
+    std::ofstream( directory + "/" + name ) << name;
+  }
+  EXPECT_EQ( Logger::prune_rotated_logs( path, 1 ), 2 );
+
+  std::vector<std::string> rotated = rotated_logs( directory );
+  ASSERT_EQ( rotated.size(), 1 );
+  EXPECT_EQ( rotated[0], "rotation.20261016-204621-1000.dump" );
+}
+
+TEST( logger, test_channel_levels ) {
+  Logger::Channel &channel = Logger::get_channel( "Test::Channel" );
+  EXPECT_EQ( &channel, &Logger::get_channel( "Test::Channel" ) );
+  EXPECT_EQ( channel.levels(), Logger::ALL );
+
+  int evaluations = 0;
+  channel.set_levels( Logger::WARNING );
+  THUMPY_LOG_CHANNEL( channel, Logger::DEBUG, "channel_", count_evaluations( &evaluations ) );
+  EXPECT_EQ( evaluations, 0 );
+  EXPECT_TRUE( channel.enabled( Logger::WARNING ) );
+  // CRITICAL can not be turned off
+  EXPECT_TRUE( channel.enabled( Logger::CRITICAL ) );
+
+  Logger::set_channel_levels( "*", Logger::ALL );
+  EXPECT_TRUE( channel.enabled( Logger::DEBUG ) );
+
+  int levels = 0;
+  EXPECT_TRUE( Logger::parse_levels( " DEBUG | ERROR ", &levels ) );
+  EXPECT_EQ( levels, Logger::DEBUG | Logger::ERROR_LOG );
+  EXPECT_TRUE( Logger::parse_levels( "NONE", &levels ) );
+  EXPECT_EQ( levels, Logger::NONE );
+  EXPECT_FALSE( Logger::parse_levels( "LOUD", &levels ) );
+}
+
+TEST( logger, test_channel_config_watch ) {
+  const std::string config_path = "channel_test.cfg";
+  Logger::Channel &image = Logger::get_channel( "Test::Image" );
+  Logger::Channel &device = Logger::get_channel( "Test::Device" );
+  {
+    std::ofstream config( config_path, std::ios::out | std::ios::trunc );
+    config << "# comment\n"
+           << "Test::Image = DEBUG | WARNING\n"
+           << "Test::Device = NONE\n"
+           << "Test::Bad = LOUD\n";
+  }
+  EXPECT_TRUE( Logger::load_channel_config( config_path ) );
+  EXPECT_EQ( image.levels(), Logger::DEBUG | Logger::WARNING );
+  EXPECT_EQ( device.levels(), Logger::NONE );
+
+  // The watcher picks up edits while running
+  Logger::watch_channel_config( config_path, std::chrono::milliseconds( 5 ) );
+  std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+  {
+    std::ofstream config( config_path, std::ios::out | std::ios::trunc );
+    config << "Test::Image = ALL\n";
+  }
+  std::filesystem::last_write_time(
+      config_path, std::filesystem::file_time_type::clock::now() + std::chrono::seconds( 1 ) );
+  for ( int i = 0; i < 200 && image.levels() != Logger::ALL; i++ ) {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+  }
+  Logger::stop_channel_config_watch();
+  EXPECT_EQ( image.levels(), Logger::ALL );
+}
 }  // namespace Core
 
 }  // namespace Thumpy
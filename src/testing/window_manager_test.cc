@@ -3,9 +3,17 @@
 
 #include <gtest/gtest.h>
 
+#include <glm/gtc/matrix_transform.hpp>
+
 #include <logger.hpp>
 
+#include "alloc_counter.hpp"
+#include "vulkan/vulkan_draw_list.hpp"
+#include "vulkan/vulkan_frame_allocator.hpp"
 #include "vulkan/vulkan_helper.hpp"
+#include "vulkan/vulkan_memory.hpp"
+#include "vulkan/vulkan_upload.hpp"
+#include "vulkan/vulkan_window.hpp"
 
 bool APPLICATION_RUNNING = true;
 
@@ -108,10 +116,12 @@ class WindowManagerVulkanTest : public testing::Test {
     // Code here will be called immediately after each test (right
     // before the destructor).
     // Terminate systems
-    window_manager->terminate();
+    if ( window_manager != nullptr ) {
+      window_manager->terminate();
+    }
   }
 
-  Thumpy::Core::Windows::WindowManager *window_manager;
+  Thumpy::Core::Windows::WindowManager *window_manager = nullptr;
 
   // Class members declared here can be used by all tests in the test suite
   // for Foo.
@@ -128,6 +138,307 @@ TEST_F( WindowManagerVulkanTest, loop_100 ) {
     i--;
   }
 }
+
+// Drives a window directly, so a test can fill the draw list and time just the frame
+class VulkanWindowTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    try {
+      window = new Vulkan::VulkanWindow( "Vulkan window test" );
+    } catch ( Vulkan::VulkanNotCompatible &ex ) {
+      GTEST_SKIP() << "No Vulkan device";
+    }
+  }
+
+  void TearDown() override {
+    if ( window != nullptr ) {
+      window->deconstruct_window();
+    }
+    glfwTerminate();
+  }
+
+  Vulkan::VulkanWindow *window = nullptr;
+};
+
+TEST_F( VulkanWindowTest, draw_frame_does_not_allocate ) {
+  if ( Vulkan::enableValidationLayers ) {
+    GTEST_SKIP() << "Validation layers allocate on every call";
+  }
+
+  Vulkan::DrawList &drawList = window->draw_list();
+  drawList.clear();
+  drawList.add_instance( window->mesh_id(), glm::mat4( 1.0f ) );
+  drawList.build();
+
+  // Warm up, fills every frame in flight slot
+  for ( int i = 0; i < 10; i++ ) {
+    window->draw_frame();
+  }
+
+  // Only the frame itself, input polling & the pacing log are outside
+  Testing::AllocationScope scope;
+  for ( int i = 0; i < 100; i++ ) {
+    window->draw_frame();
+  }
+  EXPECT_EQ( scope.allocations(), 0 );
+}
+
+TEST_F( VulkanWindowTest, culls_off_screen_and_hidden_instances ) {
+  if ( !window->culling_enabled() ) {
+    GTEST_SKIP() << "No GPU culling on this device";
+  }
+
+  auto place = []( glm::vec3 position, float scale ) {
+    return glm::scale( glm::translate( glm::mat4( 1.0f ), position ), glm::vec3( scale ) );
+  };
+
+  // The camera looks down from (2, 2, 2) at the origin, see VulkanRender::update_camera
+  Vulkan::DrawList &drawList = window->draw_list();
+  drawList.clear();
+
+  // A scaled up room whose floor fills the lower half of the screen
+  drawList.add_instance( window->mesh_id(), place( glm::vec3( 0.0f ), 3.0f ) );
+
+  // In front of the floor
+  const glm::vec3 shown[] = { { 0.0f, 0.0f, 1.0f }, { 0.3f, 0.3f, 1.2f },
+                              { 0.5f, -0.5f, 1.0f }, { 1.0f, 1.0f, 0.5f } };
+  // Below the floor
+  const glm::vec3 hidden[] = { { 0.0f, 0.0f, -1.0f }, { 0.5f, -0.5f, -1.0f },
+                               { -0.5f, 0.5f, -1.0f }, { 0.0f, 0.0f, -2.0f } };
+  // Above & beside the camera, past the far plane
+  const glm::vec3 offScreen[] = { { 0.0f, 0.0f, 30.0f }, { 10.0f, -10.0f, 2.0f },
+                                  { -10.0f, 10.0f, 2.0f }, { -30.0f, -30.0f, -30.0f } };
+  for ( const glm::vec3 &position : shown ) {
+    drawList.add_instance( window->mesh_id(), place( position, 0.05f ) );
+  }
+  for ( const glm::vec3 &position : hidden ) {
+    drawList.add_instance( window->mesh_id(), place( position, 0.05f ) );
+  }
+  for ( const glm::vec3 &position : offScreen ) {
+    drawList.add_instance( window->mesh_id(), place( position, 0.05f ) );
+  }
+  drawList.build();
+
+  // Occlusion tests against the previous frame's depth, the stats come back frames later
+  window->set_occlusion_culling( true );
+  for ( int i = 0; i < 10; i++ ) {
+    window->draw_frame();
+  }
+
+  const Vulkan::CullingStats &stats = window->culling_stats();
+  EXPECT_EQ( stats.tested, 13u );
+  EXPECT_EQ( stats.frustumCulled, 4u );
+  EXPECT_EQ( stats.occlusionCulled, window->occlusion_supported() ? 4u : 0u );
+
+  // Hidden instances are drawn again once occlusion culling is off
+  window->set_occlusion_culling( false );
+  for ( int i = 0; i < 10; i++ ) {
+    window->draw_frame();
+  }
+  EXPECT_EQ( window->culling_stats().frustumCulled, 4u );
+  EXPECT_EQ( window->culling_stats().occlusionCulled, 0u );
+}
+#pragma endregion
+
+#pragma region Draw list
+
+TEST( DrawListTest, batches_instances_by_material_and_mesh ) {
+  Vulkan::DrawList drawList;
+  uint32_t cube = drawList.add_mesh( Vulkan::MeshRange{ 0, 36, 0 } );
+  uint32_t quad = drawList.add_mesh( Vulkan::MeshRange{ 36, 6, 24 } );
+  uint32_t red = drawList.add_material( glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f ) );
+
+  for ( int i = 0; i < 10000; i++ ) {
+    EXPECT_TRUE( drawList.add_instance( i % 2 ? cube : quad, glm::mat4( 1.0f ),
+                                          i % 3 == 0 ? red : 0u ) );
+  }
+  drawList.build();
+
+  // One command per mesh per material, one batch per material
+  ASSERT_EQ( drawList.instances().size(), 10000u );
+  ASSERT_EQ( drawList.commands().size(), 4u );
+  ASSERT_EQ( drawList.batches().size(), 2u );
+
+  uint32_t firstInstance = 0;
+  for ( const VkDrawIndexedIndirectCommand &command : drawList.commands() ) {
+    EXPECT_EQ( command.firstInstance, firstInstance );
+    firstInstance += command.instanceCount;
+  }
+  EXPECT_EQ( firstInstance, 10000u );
+  EXPECT_EQ( drawList.batches()[0].commandCount + drawList.batches()[1].commandCount, 4u );
+
+  // Each batch carries its material index for the push constants, unknown ids draw white
+  EXPECT_EQ( drawList.batches()[0].material, 0u );
+  EXPECT_EQ( drawList.batches()[1].material, red );
+  EXPECT_EQ( drawList.material_color( red ), glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f ) );
+  EXPECT_EQ( drawList.material_color( 42 ), glm::vec4( 1.0f ) );
+
+  // The material table in the camera uniform has a fixed size
+  while ( drawList.materials().size() < Vulkan::MAX_DRAW_MATERIALS ) {
+    EXPECT_NE( drawList.add_material( glm::vec4( 0.5f ) ), 0u );
+  }
+  EXPECT_EQ( drawList.add_material( glm::vec4( 0.5f ) ), 0u );
+}
+
+TEST( DrawListTest, rebuild_does_not_allocate ) {
+  Vulkan::DrawList drawList;
+  uint32_t cube = drawList.add_mesh( Vulkan::MeshRange{ 0, 36, 0 } );
+  for ( int i = 0; i < 1000; i++ ) {
+    drawList.add_instance( cube, glm::mat4( 1.0f ) );
+  }
+  drawList.build();
+
+  Testing::AllocationScope scope;
+  drawList.clear();
+  for ( int i = 0; i < 1000; i++ ) {
+    drawList.add_instance( cube, glm::mat4( 1.0f ) );
+  }
+  drawList.build();
+  EXPECT_EQ( scope.allocations(), 0 );
+}
+
+TEST( DrawListTest, bounds_follow_sorted_instances ) {
+  std::vector<Vulkan::Vertex> vertices( 2 );
+  vertices[0].pos = glm::vec3( -1.0f, 0.0f, 0.0f );
+  vertices[1].pos = glm::vec3( 3.0f, 0.0f, 0.0f );
+  glm::vec4 sphere = Vulkan::bounding_sphere( vertices );
+  EXPECT_FLOAT_EQ( sphere.x, 1.0f );
+  EXPECT_FLOAT_EQ( sphere.w, 2.0f );
+
+  Vulkan::DrawList drawList;
+  uint32_t cube = drawList.add_mesh( Vulkan::MeshRange{ 0, 36, 0, sphere } );
+  uint32_t quad = drawList.add_mesh( Vulkan::MeshRange{ 36, 6, 24 } );
+  drawList.add_instance( quad, glm::mat4( 1.0f ) );
+  drawList.add_instance( cube, glm::mat4( 1.0f ) );
+  drawList.add_instance( quad, glm::mat4( 1.0f ) );
+  drawList.build();
+
+  // One bounds entry per sorted instance, pointing at the command that draws it
+  ASSERT_EQ( drawList.bounds().size(), 3u );
+  for ( size_t i = 0; i < drawList.bounds().size(); i++ ) {
+    const Vulkan::InstanceBounds &bounds = drawList.bounds()[i];
+    const VkDrawIndexedIndirectCommand &command = drawList.commands()[bounds.command];
+    EXPECT_GE( i, command.firstInstance );
+    EXPECT_LT( i, command.firstInstance + command.instanceCount );
+    EXPECT_EQ( bounds.sphere.w, command.indexCount == 36 ? 2.0f : 0.0f );
+  }
+}
+
+TEST( DrawListTest, split_draws_covers_commands_in_order ) {
+  for ( uint32_t rangeCount = 1; rangeCount <= 8; rangeCount++ ) {
+    uint32_t nextCommand = 0;
+    for ( uint32_t range = 0; range < rangeCount; range++ ) {
+      Vulkan::DrawRange drawRange = Vulkan::split_draws( 1003, rangeCount, range );
+      EXPECT_EQ( drawRange.firstCommand, nextCommand );
+      EXPECT_LE( drawRange.commandCount, 1003 / rangeCount + 1 );
+      nextCommand += drawRange.commandCount;
+    }
+    EXPECT_EQ( nextCommand, 1003u );
+  }
+}
+
+#pragma endregion
+
+#pragma region Frame allocator
+
+TEST( LinearAllocatorTest, aligns_and_fills_up ) {
+  Vulkan::LinearAllocator allocator( 1024 );
+  VkDeviceSize offset;
+
+  ASSERT_TRUE( allocator.allocate( 10, 256, &offset ) );
+  EXPECT_EQ( offset, 0u );
+  ASSERT_TRUE( allocator.allocate( 10, 256, &offset ) );
+  EXPECT_EQ( offset, 256u );
+  ASSERT_TRUE( allocator.allocate( 4, 4, &offset ) );
+  EXPECT_EQ( offset, 268u );
+
+  // 512 + 600 is past the end, a failed allocation leaves the head alone
+  EXPECT_FALSE( allocator.allocate( 600, 512, &offset ) );
+  EXPECT_EQ( allocator.used(), 272u );
+  ASSERT_TRUE( allocator.allocate( 512, 512, &offset ) );
+  EXPECT_EQ( offset, 512u );
+  EXPECT_FALSE( allocator.allocate( 1, 1, &offset ) );
+
+  allocator.reset();
+  ASSERT_TRUE( allocator.allocate( 1024, 1, &offset ) );
+  EXPECT_EQ( offset, 0u );
+}
+
+#pragma endregion
+
+#pragma region Memory
+
+TEST( TlsfAllocatorTest, aligns_and_reuses_padding ) {
+  Vulkan::TlsfAllocator allocator( 1024 );
+  VkDeviceSize offset;
+  uint32_t first, aligned, small;
+
+  ASSERT_TRUE( allocator.allocate( 100, 1, &offset, &first ) );
+  EXPECT_EQ( offset, 0u );
+  ASSERT_TRUE( allocator.allocate( 10, 256, &offset, &aligned ) );
+  EXPECT_EQ( offset, 256u );
+
+  // The padding in front of the aligned allocation is free again
+  ASSERT_TRUE( allocator.allocate( 4, 4, &offset, &small ) );
+  EXPECT_EQ( offset, 100u );
+  EXPECT_EQ( allocator.used(), 114u );
+  EXPECT_EQ( allocator.allocation_count(), 3u );
+
+  allocator.free( first );
+  allocator.free( aligned );
+  allocator.free( small );
+  EXPECT_TRUE( allocator.empty() );
+  EXPECT_EQ( allocator.used(), 0u );
+}
+
+TEST( TlsfAllocatorTest, merges_free_neighbours ) {
+  Vulkan::TlsfAllocator allocator( 1024 );
+  VkDeviceSize offset;
+  uint32_t a, b, c;
+
+  ASSERT_TRUE( allocator.allocate( 256, 1, &offset, &a ) );
+  ASSERT_TRUE( allocator.allocate( 256, 1, &offset, &b ) );
+  ASSERT_TRUE( allocator.allocate( 256, 1, &offset, &c ) );
+  EXPECT_EQ( offset, 512u );
+
+  // 512 bytes are free, but not in one piece
+  allocator.free( a );
+  allocator.free( c );
+  EXPECT_FALSE( allocator.allocate( 768, 1, &offset, &a ) );
+
+  allocator.free( b );
+  ASSERT_TRUE( allocator.allocate( 1024, 1, &offset, &a ) );
+  EXPECT_EQ( offset, 0u );
+  EXPECT_FALSE( allocator.allocate( 1, 1, &offset, &b ) );
+}
+
+#pragma endregion
+
+#pragma region Upload
+
+TEST( StagingRingTest, wraps_and_waits_for_release ) {
+  Vulkan::StagingRing ring( 1024 );
+  VkDeviceSize offset;
+
+  ASSERT_TRUE( ring.allocate( 600, 16, &offset ) );
+  EXPECT_EQ( offset, 0u );
+  ASSERT_TRUE( ring.allocate( 300, 16, &offset ) );
+  EXPECT_EQ( offset, 608u );
+
+  // Doesn't fit before the end & the start is still in use
+  EXPECT_FALSE( ring.allocate( 200, 16, &offset ) );
+
+  ring.release( 608 );
+  ASSERT_TRUE( ring.allocate( 200, 16, &offset ) );
+  EXPECT_EQ( offset, 0u );
+  EXPECT_FALSE( ring.allocate( 500, 16, &offset ) );
+
+  ring.release( 908 );
+  ASSERT_TRUE( ring.allocate( 500, 16, &offset ) );
+  EXPECT_EQ( offset, 208u );
+  EXPECT_EQ( ring.used(), 824u );
+}
+
 #pragma endregion
 
 }  // namespace Windows
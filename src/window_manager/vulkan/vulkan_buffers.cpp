@@ -13,13 +13,16 @@
 
 #include <vulkan/vulkan_core.h>
 
-#include <cstring>
 #include <string>
+#include <utility>
 
 #include "logger_helper.hpp"
+#include "vulkan_deletion_queue.hpp"
 #include "vulkan_device.hpp"
 #include "vulkan_helper.hpp"
 #include "vulkan_initializers.hpp"
+#include "vulkan_memory.hpp"
+#include "vulkan_upload.hpp"
 
 namespace Thumpy {
 namespace Core {
@@ -27,48 +30,56 @@ namespace Windows {
 namespace Vulkan {
 namespace Buffer {
 
+Buffer::Buffer( Buffer &&other ) noexcept
+    : buffer( std::exchange( other.buffer, VK_NULL_HANDLE ) ),
+      allocation( std::exchange( other.allocation, MemoryAllocation() ) ),
+      vulkanDevice( other.vulkanDevice ) {}
+
+Buffer &Buffer::operator=( Buffer &&other ) noexcept {
+  if ( this != &other ) {
+    reset();
+    buffer = std::exchange( other.buffer, VK_NULL_HANDLE );
+    allocation = std::exchange( other.allocation, MemoryAllocation() );
+    vulkanDevice = other.vulkanDevice;
+  }
+  return *this;
+}
+
+void Buffer::reset( uint64_t timelineValue ) {
+  if ( buffer == VK_NULL_HANDLE ) {
+    return;
+  }
+  vulkanDevice->deletionQueue->push( buffer, allocation, timelineValue );
+  buffer = VK_NULL_HANDLE;
+}
+
 void create_buffer( VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-                    VkBuffer &buffer, VkDeviceMemory &bufferMemory, VulkanDevice *vulkanDevice ) {
+                    Buffer &buffer, VulkanDevice *vulkanDevice ) {
+  buffer.reset();
+
   VkBufferCreateInfo bufferInfo{};
   bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
   bufferInfo.size = size;
   bufferInfo.usage = usage;
   bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-  if ( vkCreateBuffer( vulkanDevice->device, &bufferInfo, nullptr, &buffer ) != VK_SUCCESS ) {
-    Logger::log( "Failed to create buffer!" );
-  }
-
-  VkMemoryRequirements memRequirements;
-  vkGetBufferMemoryRequirements( vulkanDevice->device, buffer, &memRequirements );
-
-  VkMemoryAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex =
-      find_memory_type( vulkanDevice->physicalDevice, memRequirements.memoryTypeBits, properties );
-
-  if ( vkAllocateMemory( vulkanDevice->device, &allocInfo, nullptr, &bufferMemory ) !=
+  if ( vkCreateBuffer( vulkanDevice->device, &bufferInfo, nullptr, &buffer.buffer ) !=
        VK_SUCCESS ) {
-    Logger::log( "Failed to allocate buffer memory!" );
+    Logger::log( "Failed to create buffer!" );
   }
 
-  vkBindBufferMemory( vulkanDevice->device, buffer, bufferMemory, 0 );
-}
-
-void copy_buffer( VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size,
-                  VulkanDevice *vulkanDevice, VkCommandPool &commandPool ) {
-  VkCommandBuffer commandBuffer = begin_single_time_commands( vulkanDevice->device, commandPool );
-
-  VkBufferCopy copyRegion{};
-  copyRegion.size = size;
-  vkCmdCopyBuffer( commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion );
-
-  end_single_time_commands( vulkanDevice, commandBuffer, commandPool );
+  buffer.allocation = vulkanDevice->allocator->allocate_buffer( buffer.buffer, properties );
+  buffer.vulkanDevice = vulkanDevice;
 }
 
 void create_framebuffers( VulkanSwapChain *swapChain, VkImageView depthImageView,
                           VkImageView colorImageView, VkDevice device ) {
+  // Dynamic rendering binds the image views directly when rendering begins
+  if ( swapChain->renderPass == VK_NULL_HANDLE ) {
+    swapChain->swapChainFramebuffers.clear();
+    return;
+  }
+
   swapChain->swapChainFramebuffers.resize( swapChain->swapChainImageViews.size() );
 
   for ( size_t i = 0; i < swapChain->swapChainImageViews.size(); i++ ) {
@@ -86,87 +97,26 @@ void create_framebuffers( VulkanSwapChain *swapChain, VkImageView depthImageView
 }
 
 void create_vertex_buffer( std::vector<Vertex> vertices, VulkanDevice *vulkanDevice,
-                           Buffer *vertexBuffer, VkCommandPool &commandPool ) {
+                           Buffer *vertexBuffer, UploadQueue *uploadQueue ) {
   VkDeviceSize bufferSize = sizeof( vertices[0] ) * vertices.size();
 
-  VkBuffer stagingBuffer;
-  VkDeviceMemory stagingBufferMemory;
-  create_buffer( bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingBufferMemory, vulkanDevice );
-
-  void *data;
-  vkMapMemory( vulkanDevice->device, stagingBufferMemory, 0, bufferSize, 0, &data );
-  memcpy( data, vertices.data(), (size_t)bufferSize );
-  vkUnmapMemory( vulkanDevice->device, stagingBufferMemory );
-
   create_buffer( bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer->buffer, vertexBuffer->memory,
-                 vulkanDevice );
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, *vertexBuffer, vulkanDevice );
 
-  copy_buffer( stagingBuffer, vertexBuffer->buffer, bufferSize, vulkanDevice, commandPool );
-
-  vkDestroyBuffer( vulkanDevice->device, stagingBuffer, nullptr );
-  vkFreeMemory( vulkanDevice->device, stagingBufferMemory, nullptr );
+  uploadQueue->upload_buffer( vertexBuffer->buffer, 0, vertices.data(), bufferSize,
+                              VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                              VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT );
 }
 
 void create_index_buffer( std::vector<uint16_t> indices, VulkanDevice *vulkanDevice,
-                          Buffer *indexBuffer, VkCommandPool &commandPool ) {
+                          Buffer *indexBuffer, UploadQueue *uploadQueue ) {
   VkDeviceSize bufferSize = sizeof( indices[0] ) * indices.size();
 
-  VkBuffer stagingBuffer;
-  VkDeviceMemory stagingBufferMemory;
-  create_buffer( bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingBufferMemory, vulkanDevice );
-
-  void *data;
-  vkMapMemory( vulkanDevice->device, stagingBufferMemory, 0, bufferSize, 0, &data );
-  memcpy( data, indices.data(), (size_t)bufferSize );
-  vkUnmapMemory( vulkanDevice->device, stagingBufferMemory );
-
   create_buffer( bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer->buffer, indexBuffer->memory,
-                 vulkanDevice );
-
-  copy_buffer( stagingBuffer, indexBuffer->buffer, bufferSize, vulkanDevice, commandPool );
-
-  vkDestroyBuffer( vulkanDevice->device, stagingBuffer, nullptr );
-  vkFreeMemory( vulkanDevice->device, stagingBufferMemory, nullptr );
-}
-
-VkCommandBuffer begin_single_time_commands( VkDevice device, VkCommandPool commandPool ) {
-  VkCommandBufferAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  allocInfo.commandPool = commandPool;
-  allocInfo.commandBufferCount = 1;
-
-  VkCommandBuffer commandBuffer;
-  vkAllocateCommandBuffers( device, &allocInfo, &commandBuffer );
-
-  VkCommandBufferBeginInfo beginInfo{};
-  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-  vkBeginCommandBuffer( commandBuffer, &beginInfo );
-
-  return commandBuffer;
-}
-
-void end_single_time_commands( VulkanDevice *vulkanDevice, VkCommandBuffer commandBuffer,
-                               VkCommandPool commandPool ) {
-  vkEndCommandBuffer( commandBuffer );
-
-  VkSubmitInfo submitInfo{};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffer;
-
-  vkQueueSubmit( vulkanDevice->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE );
-  vkQueueWaitIdle( vulkanDevice->graphicsQueue );
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, *indexBuffer, vulkanDevice );
 
-  vkFreeCommandBuffers( vulkanDevice->device, commandPool, 1, &commandBuffer );
+  uploadQueue->upload_buffer( indexBuffer->buffer, 0, indices.data(), bufferSize,
+                              VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT );
 }
 
 }  // namespace Buffer
@@ -12,43 +12,66 @@
 
 #include "vulkan_device.hpp"
 #include "vulkan_helper.hpp"
+#include "vulkan_memory.hpp"
 #include "vulkan_swap_chain.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Windows {
 namespace Vulkan {
+
+class UploadQueue;
+
 namespace Buffer {
 
+/**
+ * @brief Owns a buffer & its memory. Move only, both go to the device's deletion queue when
+ * it's reset or destroyed
+ */
 struct Buffer {
-  VkBuffer buffer;
-  VkDeviceMemory memory;
+  Buffer() = default;
+  Buffer( Buffer &&other ) noexcept;
+  Buffer &operator=( Buffer &&other ) noexcept;
+  Buffer( const Buffer & ) = delete;
+  Buffer &operator=( const Buffer & ) = delete;
+  ~Buffer() { reset(); }
 
-  void destroy( VkDevice device ) {
-    vkDestroyBuffer( device, buffer, nullptr );
-    vkFreeMemory( device, memory, nullptr );
-  }
+  /**
+   * @brief Queue the buffer & its memory for deletion, leaves this empty
+   *
+   * @param timelineValue last submission that may use it
+   */
+  void reset( uint64_t timelineValue = LAST_SUBMISSION );
+
+  VkBuffer buffer = VK_NULL_HANDLE;
+  MemoryAllocation allocation;
+  // Set on creation, owns the deletion queue the handles go to
+  VulkanDevice *vulkanDevice = nullptr;
 };
 
+/**
+ * @brief Create a buffer & bind memory to it, host visible memory stays mapped
+ * A buffer already in it is reset first
+ */
 void create_buffer( VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-                    VkBuffer &buffer, VkDeviceMemory &bufferMemory, VulkanDevice *vulkanDevice );
-
-void copy_buffer( VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size,
-                  VulkanDevice *vulkanDevice, VkCommandPool &commandPool );
+                    Buffer &buffer, VulkanDevice *vulkanDevice );
 
 void create_framebuffers( VulkanSwapChain *swapChain, VkImageView depthImageView,
                           VkImageView colorImageView, VkDevice device );
 
+/**
+ * @brief Create a device local vertex buffer & queue its upload, usable once the upload queue's
+ * next flush completes
+ */
 void create_vertex_buffer( std::vector<Vertex> vertices, VulkanDevice *vulkanDevice,
-                           Buffer *vertexBuffer, VkCommandPool &commandPool );
+                           Buffer *vertexBuffer, UploadQueue *uploadQueue );
 
+/**
+ * @brief Create a device local index buffer & queue its upload, like create_vertex_buffer
+ *
+ */
 void create_index_buffer( std::vector<uint16_t> indices, VulkanDevice *vulkanDevice,
-                          Buffer *indexBuffer, VkCommandPool &commandPool );
-
-VkCommandBuffer begin_single_time_commands( VkDevice device, VkCommandPool commandPool );
-
-void end_single_time_commands( VulkanDevice *vulkanDevice, VkCommandBuffer commandBuffer,
-                               VkCommandPool commandPool );
+                          Buffer *indexBuffer, UploadQueue *uploadQueue );
 
 }  // namespace Buffer
 }  // namespace Vulkan
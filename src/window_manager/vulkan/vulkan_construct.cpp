@@ -13,11 +13,15 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <utility>
+
 #include "logger.hpp"
 #include "logger_helper.hpp"
 #include "vulkan_buffers.hpp"
 #include "vulkan_debug.hpp"
+#include "vulkan_deletion_queue.hpp"
 #include "vulkan_device.hpp"
+#include "vulkan_draw_list.hpp"
 #include "vulkan_helper.hpp"
 #include "vulkan_initializers.hpp"
 
@@ -60,36 +64,74 @@ void instance( VkInstance &instance ) {
   }
 }
 
-void uniform_buffers( VulkanDevice *vulkanDevice, UniformBuffers *uniformBuffers,
-                      int maxFramesInFlight ) {
-  VkDeviceSize bufferSize = sizeof( UniformBufferObject );
+void draw_buffers( VulkanDevice *vulkanDevice, DrawBuffers *drawBuffers, int maxFramesInFlight ) {
+  VkDeviceSize indirectSize = sizeof( VkDrawIndexedIndirectCommand ) * MAX_DRAW_COMMANDS;
+  VkDeviceSize visibleSize = sizeof( uint32_t ) * MAX_DRAW_INSTANCES;
 
-  uniformBuffers->buffers.resize( maxFramesInFlight );
-  uniformBuffers->memory.resize( maxFramesInFlight );
-  uniformBuffers->mapped.resize( maxFramesInFlight );
+  drawBuffers->indirectBuffers.resize( maxFramesInFlight );
+  drawBuffers->indirectMapped.resize( maxFramesInFlight );
+  drawBuffers->visibleBuffers.resize( maxFramesInFlight );
 
+  // Commands are copied in by the CPU every frame, so host visible
   for ( size_t i = 0; i < maxFramesInFlight; i++ ) {
+    // The culling pass counts visible instances straight into the indirect commands
+    Buffer::create_buffer(
+        indirectSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        drawBuffers->indirectBuffers[i], vulkanDevice );
+    drawBuffers->indirectMapped[i] = drawBuffers->indirectBuffers[i].allocation.mapped;
+
     Buffer::create_buffer(
-        bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        visibleSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        uniformBuffers->buffers[i], uniformBuffers->memory[i], vulkanDevice );
+        drawBuffers->visibleBuffers[i], vulkanDevice );
+
+    // Without culling every instance is visible
+    uint32_t *visible = static_cast<uint32_t *>( drawBuffers->visibleBuffers[i].allocation.mapped );
+    for ( uint32_t instance = 0; instance < MAX_DRAW_INSTANCES; instance++ ) {
+      visible[instance] = instance;
+    }
+  }
+}
 
-    vkMapMemory( vulkanDevice->device, uniformBuffers->memory[i], 0, bufferSize, 0,
-                 &uniformBuffers->mapped[i] );
+CommandPool::CommandPool( CommandPool &&other ) noexcept
+    : pool( std::exchange( other.pool, VK_NULL_HANDLE ) ),
+      buffers( std::move( other.buffers ) ),
+      vulkanDevice( other.vulkanDevice ) {}
+
+CommandPool &CommandPool::operator=( CommandPool &&other ) noexcept {
+  if ( this != &other ) {
+    reset();
+    pool = std::exchange( other.pool, VK_NULL_HANDLE );
+    buffers = std::move( other.buffers );
+    vulkanDevice = other.vulkanDevice;
   }
+  return *this;
 }
 
-void command_pool( VulkanDevice *vulkanDevice, VkCommandPool &commandPool ) {
+void CommandPool::reset( uint64_t timelineValue ) {
+  if ( pool == VK_NULL_HANDLE ) {
+    return;
+  }
+  vulkanDevice->deletionQueue->push( pool, timelineValue );
+  pool = VK_NULL_HANDLE;
+  buffers.clear();
+}
+
+void command_pool( VulkanDevice *vulkanDevice, CommandPool &commandPool ) {
+  commandPool.reset();
+
   QueueFamilyIndices queueFamilyIndices =
       vulkanDevice->find_queue_families( vulkanDevice->physicalDevice );
 
   VkCommandPoolCreateInfo poolInfo =
       Initializer::pool_info( queueFamilyIndices.graphicsFamily.value() );
 
-  if ( vkCreateCommandPool( vulkanDevice->device, &poolInfo, nullptr, &commandPool ) !=
+  if ( vkCreateCommandPool( vulkanDevice->device, &poolInfo, nullptr, &commandPool.pool ) !=
        VK_SUCCESS ) {
     Logger::log( "Failed to create command pool!", Logger::CRITICAL );
   }
+  commandPool.vulkanDevice = vulkanDevice;
 }
 
 void command_buffer( std::vector<VkCommandBuffer> &commandBuffers, VkCommandPool commandPool,
@@ -105,11 +147,50 @@ void command_buffer( std::vector<VkCommandBuffer> &commandBuffers, VkCommandPool
 
 #pragma region Descriptor
 
-void descriptor_set_layout( VulkanDevice *vulkanDevice,
-                            VkDescriptorSetLayout &descriptorSetLayout ) {
+}  // namespace Construct
+
+Descriptors::Descriptors( Descriptors &&other ) noexcept
+    : setLayout( std::exchange( other.setLayout, VK_NULL_HANDLE ) ),
+      pool( std::exchange( other.pool, VK_NULL_HANDLE ) ),
+      sets( std::move( other.sets ) ),
+      vulkanDevice( other.vulkanDevice ) {}
+
+Descriptors &Descriptors::operator=( Descriptors &&other ) noexcept {
+  if ( this != &other ) {
+    reset();
+    setLayout = std::exchange( other.setLayout, VK_NULL_HANDLE );
+    pool = std::exchange( other.pool, VK_NULL_HANDLE );
+    sets = std::move( other.sets );
+    vulkanDevice = other.vulkanDevice;
+  }
+  return *this;
+}
+
+void Descriptors::reset_pool( uint64_t timelineValue ) {
+  if ( pool == VK_NULL_HANDLE ) {
+    return;
+  }
+  vulkanDevice->deletionQueue->push( pool, timelineValue );
+  pool = VK_NULL_HANDLE;
+  sets.clear();
+}
+
+void Descriptors::reset( uint64_t timelineValue ) {
+  reset_pool( timelineValue );
+  if ( setLayout != VK_NULL_HANDLE ) {
+    vulkanDevice->deletionQueue->push( setLayout, timelineValue );
+    setLayout = VK_NULL_HANDLE;
+  }
+}
+
+namespace Construct {
+
+void descriptor_set_layout( VulkanDevice *vulkanDevice, Descriptors &descriptors ) {
+  descriptors.reset();
+
   VkDescriptorSetLayoutBinding uboLayoutBinding{};
   uboLayoutBinding.binding = 0;
-  uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
   uboLayoutBinding.descriptorCount = 1;
 
   uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
@@ -122,25 +203,49 @@ void descriptor_set_layout( VulkanDevice *vulkanDevice,
   samplerLayoutBinding.pImmutableSamplers = nullptr;
   samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-  std::array<VkDescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding, samplerLayoutBinding };
+  // Per instance transforms
+  VkDescriptorSetLayoutBinding instanceLayoutBinding{};
+  instanceLayoutBinding.binding = 2;
+  instanceLayoutBinding.descriptorCount = 1;
+  instanceLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+  instanceLayoutBinding.pImmutableSamplers = nullptr;
+  instanceLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+  // Indices of the instances that survived culling
+  VkDescriptorSetLayoutBinding visibleLayoutBinding{};
+  visibleLayoutBinding.binding = 3;
+  visibleLayoutBinding.descriptorCount = 1;
+  visibleLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  visibleLayoutBinding.pImmutableSamplers = nullptr;
+  visibleLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+  std::array<VkDescriptorSetLayoutBinding, 4> bindings = {
+      uboLayoutBinding, samplerLayoutBinding, instanceLayoutBinding, visibleLayoutBinding };
   VkDescriptorSetLayoutCreateInfo layoutInfo{};
   layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
   layoutInfo.bindingCount = static_cast<uint32_t>( bindings.size() );
   layoutInfo.pBindings = bindings.data();
 
   if ( vkCreateDescriptorSetLayout( vulkanDevice->device, &layoutInfo, nullptr,
-                                    &descriptorSetLayout ) != VK_SUCCESS ) {
+                                    &descriptors.setLayout ) != VK_SUCCESS ) {
     Logger::log( "Failed to create descriptor set layout!", Logger::CRITICAL );
   }
+  descriptors.vulkanDevice = vulkanDevice;
 }
 
-void descriptor_pool( VulkanDevice *vulkanDevice, VkDescriptorPool &descriptorPool,
+void descriptor_pool( VulkanDevice *vulkanDevice, Descriptors &descriptors,
                       int maxFramesInFlight ) {
-  std::array<VkDescriptorPoolSize, 2> poolSizes{};
-  poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  descriptors.reset_pool();
+
+  std::array<VkDescriptorPoolSize, 4> poolSizes{};
+  poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
   poolSizes[0].descriptorCount = static_cast<uint32_t>( maxFramesInFlight );
   poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
   poolSizes[1].descriptorCount = static_cast<uint32_t>( maxFramesInFlight );
+  poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+  poolSizes[2].descriptorCount = static_cast<uint32_t>( maxFramesInFlight );
+  poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  poolSizes[3].descriptorCount = static_cast<uint32_t>( maxFramesInFlight );
 
   VkDescriptorPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -148,15 +253,16 @@ void descriptor_pool( VulkanDevice *vulkanDevice, VkDescriptorPool &descriptorPo
   poolInfo.pPoolSizes = poolSizes.data();
   poolInfo.maxSets = static_cast<uint32_t>( maxFramesInFlight );
 
-  if ( vkCreateDescriptorPool( vulkanDevice->device, &poolInfo, nullptr, &descriptorPool ) !=
+  if ( vkCreateDescriptorPool( vulkanDevice->device, &poolInfo, nullptr, &descriptors.pool ) !=
        VK_SUCCESS ) {
     Logger::log( "Failed to create descriptor pool!", Logger::CRITICAL );
   }
+  descriptors.vulkanDevice = vulkanDevice;
 }
 
 void descriptor_sets( VulkanDevice *vulkanDevice, Descriptors *descriptors,
-                      std::vector<VkBuffer> &uniformBuffers, VulkanTextureImage *textureImage,
-                      int maxFramesInFlight ) {
+                      FrameAllocator *frameAllocator, DrawBuffers *drawBuffers,
+                      VulkanTextureImage *textureImage, int maxFramesInFlight ) {
   std::vector<VkDescriptorSetLayout> layouts( maxFramesInFlight, descriptors->setLayout );
   VkDescriptorSetAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -172,22 +278,32 @@ void descriptor_sets( VulkanDevice *vulkanDevice, Descriptors *descriptors,
 
   for ( size_t i = 0; i < maxFramesInFlight; i++ ) {
     VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = uniformBuffers[i];
+    bufferInfo.buffer = frameAllocator->buffer();
     bufferInfo.offset = 0;
-    bufferInfo.range = sizeof( UniformBufferObject );
+    bufferInfo.range = sizeof( CameraData );
 
     VkDescriptorImageInfo imageInfo{};
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     imageInfo.imageView = textureImage->imageView;
     imageInfo.sampler = textureImage->sampler;
 
-    std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+    VkDescriptorBufferInfo instanceInfo{};
+    instanceInfo.buffer = frameAllocator->buffer();
+    instanceInfo.offset = 0;
+    instanceInfo.range = sizeof( InstanceData ) * MAX_DRAW_INSTANCES;
+
+    VkDescriptorBufferInfo visibleInfo{};
+    visibleInfo.buffer = drawBuffers->visibleBuffers[i].buffer;
+    visibleInfo.offset = 0;
+    visibleInfo.range = VK_WHOLE_SIZE;
+
+    std::array<VkWriteDescriptorSet, 4> descriptorWrites{};
 
     descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     descriptorWrites[0].dstSet = descriptors->sets[i];
     descriptorWrites[0].dstBinding = 0;
     descriptorWrites[0].dstArrayElement = 0;
-    descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descriptorWrites[0].descriptorCount = 1;
     descriptorWrites[0].pBufferInfo = &bufferInfo;
 
@@ -199,6 +315,22 @@ void descriptor_sets( VulkanDevice *vulkanDevice, Descriptors *descriptors,
     descriptorWrites[1].descriptorCount = 1;
     descriptorWrites[1].pImageInfo = &imageInfo;
 
+    descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[2].dstSet = descriptors->sets[i];
+    descriptorWrites[2].dstBinding = 2;
+    descriptorWrites[2].dstArrayElement = 0;
+    descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptorWrites[2].descriptorCount = 1;
+    descriptorWrites[2].pBufferInfo = &instanceInfo;
+
+    descriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[3].dstSet = descriptors->sets[i];
+    descriptorWrites[3].dstBinding = 3;
+    descriptorWrites[3].dstArrayElement = 0;
+    descriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrites[3].descriptorCount = 1;
+    descriptorWrites[3].pBufferInfo = &visibleInfo;
+
     vkUpdateDescriptorSets( vulkanDevice->device, static_cast<uint32_t>( descriptorWrites.size() ),
                             descriptorWrites.data(), 0, nullptr );
   }
@@ -15,7 +15,9 @@
 #include <vulkan/vulkan_core.h>
 
 #include "vulkan/vulkan_helper.hpp"
+#include "vulkan_buffers.hpp"
 #include "vulkan_device.hpp"
+#include "vulkan_frame_allocator.hpp"
 
 namespace Thumpy {
 namespace Core {
@@ -29,44 +31,84 @@ void surface( VkInstance instance, GLFWwindow *window, VkSurfaceKHR &surface );
 
 #pragma region Command pool
 
+/**
+ * @brief Owns a command pool. Move only, the pool goes to the device's deletion queue when it's
+ * reset or destroyed & takes its command buffers with it
+ */
 struct CommandPool {
-  VkCommandPool pool;
+  CommandPool() = default;
+  CommandPool( CommandPool &&other ) noexcept;
+  CommandPool &operator=( CommandPool &&other ) noexcept;
+  CommandPool( const CommandPool & ) = delete;
+  CommandPool &operator=( const CommandPool & ) = delete;
+  ~CommandPool() { reset(); }
+
+  /**
+   * @brief Queue the pool for deletion, leaves this empty
+   *
+   * @param timelineValue last submission that may use its command buffers
+   */
+  void reset( uint64_t timelineValue = LAST_SUBMISSION );
+
+  VkCommandPool pool = VK_NULL_HANDLE;
   std::vector<VkCommandBuffer> buffers;
-
-  void destroy( VkDevice device ) { vkDestroyCommandPool( device, pool, nullptr ); }
+  // Set on creation, owns the deletion queue the pool goes to
+  VulkanDevice *vulkanDevice = nullptr;
 };
 
-void command_pool( VulkanDevice *vulkanDevice, VkCommandPool &commandPool );
+void command_pool( VulkanDevice *vulkanDevice, CommandPool &commandPool );
 
 void command_buffer( std::vector<VkCommandBuffer> &commandBuffers, VkCommandPool commandPool,
                      VkDevice device, int maxFramesInFlight );
 
 #pragma region Command pool
 
-#pragma region Uniform buffers
+#pragma region Draw buffers
 
-struct UniformBuffers {
-  std::vector<VkBuffer> buffers;
-  std::vector<VkDeviceMemory> memory;
-  std::vector<void *> mapped;
+/**
+ * @brief Per frame visible index & indirect command buffers, the ones the GPU writes.
+ * Visible indices start out as 0, 1, 2... and are only rewritten by the culling pass.
+ * Instances & bounds come from the FrameAllocator.
+ */
+struct DrawBuffers {
+  std::vector<Buffer::Buffer> indirectBuffers;
+  std::vector<void *> indirectMapped;
+
+  std::vector<Buffer::Buffer> visibleBuffers;
+
+  /**
+   * @brief Queue every buffer for deletion
+   *
+   */
+  void reset() {
+    indirectBuffers.clear();
+    indirectMapped.clear();
+    visibleBuffers.clear();
+  }
 };
 
-void uniform_buffers( VulkanDevice *vulkanDevice, UniformBuffers *uniformBuffers,
-                      int maxFramesInFlight );
+void draw_buffers( VulkanDevice *vulkanDevice, DrawBuffers *drawBuffers, int maxFramesInFlight );
 
-#pragma endregion Uniform buffers
+#pragma endregion Draw buffers
 
 #pragma region Descriptor
 
-void descriptor_set_layout( VulkanDevice *vulkanDevice,
-                            VkDescriptorSetLayout &descriptorSetLayout );
+void descriptor_set_layout( VulkanDevice *vulkanDevice, Descriptors &descriptors );
 
-void descriptor_pool( VulkanDevice *vulkanDevice, VkDescriptorPool &descriptorPool,
+/**
+ * @brief Create the pool the frames' descriptor sets come from, a pool already in descriptors
+ * is reset first
+ */
+void descriptor_pool( VulkanDevice *vulkanDevice, Descriptors &descriptors,
                       int maxFramesInFlight );
 
+/**
+ * @brief Write each frame's descriptor set. The camera & instances are dynamic bindings into
+ * the frame allocator, the offsets are given when the set is bound.
+ */
 void descriptor_sets( VulkanDevice *vulkanDevice, Descriptors *descriptors,
-                      std::vector<VkBuffer> &uniformBuffers, VulkanTextureImage *textureImage,
-                      int maxFramesInFlight );
+                      FrameAllocator *frameAllocator, DrawBuffers *drawBuffers,
+                      VulkanTextureImage *textureImage, int maxFramesInFlight );
 
 #pragma endregion Descriptor
 
@@ -0,0 +1,591 @@
+/**
+ * @file vulkan_culling.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_culling cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_culling.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_access.hpp>
+
+#include "channel.hpp"
+#include "logger.hpp"
+#include "vulkan_buffers.hpp"
+#include "vulkan_deletion_queue.hpp"
+#include "vulkan_draw_list.hpp"
+#include "vulkan_image.hpp"
+#include "vulkan_initializers.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+Logger::Channel &cullingChannel = Logger::get_channel( "Vulkan::Culling" );
+
+uint32_t previous_power_of_two( uint32_t value ) {
+  uint32_t result = 1;
+  while ( result * 2 <= value ) {
+    result *= 2;
+  }
+  return result;
+}
+
+uint32_t group_count( uint32_t size, uint32_t groupSize ) {
+  return ( size + groupSize - 1 ) / groupSize;
+}
+
+glm::vec4 normalize_plane( const glm::vec4 &plane ) {
+  return plane / glm::length( glm::vec3( plane ) );
+}
+
+VkWriteDescriptorSet buffer_write( VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+                                   const VkDescriptorBufferInfo *bufferInfo ) {
+  VkWriteDescriptorSet write{};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = set;
+  write.dstBinding = binding;
+  write.dstArrayElement = 0;
+  write.descriptorType = type;
+  write.descriptorCount = 1;
+  write.pBufferInfo = bufferInfo;
+  return write;
+}
+
+VkWriteDescriptorSet image_write( VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+                                  const VkDescriptorImageInfo *imageInfo ) {
+  VkWriteDescriptorSet write{};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = set;
+  write.dstBinding = binding;
+  write.dstArrayElement = 0;
+  write.descriptorType = type;
+  write.descriptorCount = 1;
+  write.pImageInfo = imageInfo;
+  return write;
+}
+
+VkDescriptorSetLayoutBinding layout_binding( uint32_t binding, VkDescriptorType type ) {
+  VkDescriptorSetLayoutBinding layoutBinding{};
+  layoutBinding.binding = binding;
+  layoutBinding.descriptorCount = 1;
+  layoutBinding.descriptorType = type;
+  layoutBinding.pImmutableSamplers = nullptr;
+  layoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  return layoutBinding;
+}
+
+}  // namespace
+
+VulkanCulling::VulkanCulling( VulkanDevice *vulkanDevice, int maxFramesInFlight,
+                              FrameAllocator *frameAllocator,
+                              const Construct::DrawBuffers &drawBuffers,
+                              VulkanImage *depthImage ) {
+  vulkanDevice_ = vulkanDevice;
+  maxFramesInFlight_ = maxFramesInFlight;
+  frameAllocator_ = frameAllocator;
+  depthImage_ = depthImage;
+
+  VkFormat depthFormat = Image::find_depth_format( vulkanDevice_->physicalDevice );
+  depthAspect_ = VK_IMAGE_ASPECT_DEPTH_BIT;
+  if ( Image::has_stencil_component( depthFormat ) ) {
+    depthAspect_ |= VK_IMAGE_ASPECT_STENCIL_BIT;
+  }
+
+  create_descriptor_layouts();
+
+  // Culled commands still need firstInstance to find their slice of the visible buffer
+  if ( vulkanDevice_->drawIndirectFirstInstance ) {
+    cullPipeline_ = create_compute_pipeline( vulkanDevice_, "cull.comp.spv", cullSetLayout_, 0 );
+  }
+  if ( cullPipeline_ == nullptr ) {
+    THUMPY_LOG_CHANNEL( cullingChannel, Logger::WARNING,
+                        "GPU culling disabled, every instance is drawn" );
+  }
+
+  if ( cullPipeline_ != nullptr && Image::depth_pyramid_supported( vulkanDevice_ ) ) {
+    seedPipeline_ =
+        create_compute_pipeline( vulkanDevice_, "depth_pyramid_seed.comp.spv", pyramidSetLayout_,
+                                 sizeof( DepthPyramidReduce ) );
+    pyramidPipeline_ = create_compute_pipeline( vulkanDevice_, "depth_pyramid.comp.spv",
+                                                pyramidSetLayout_, sizeof( DepthPyramidReduce ) );
+    if ( seedPipeline_ == nullptr || pyramidPipeline_ == nullptr ) {
+      if ( seedPipeline_ != nullptr ) {
+        destroy_compute_pipeline( vulkanDevice_->device, seedPipeline_ );
+        delete seedPipeline_;
+        seedPipeline_ = nullptr;
+      }
+      if ( pyramidPipeline_ != nullptr ) {
+        destroy_compute_pipeline( vulkanDevice_->device, pyramidPipeline_ );
+        delete pyramidPipeline_;
+        pyramidPipeline_ = nullptr;
+      }
+    }
+  }
+  if ( cullPipeline_ != nullptr && seedPipeline_ == nullptr ) {
+    THUMPY_LOG_CHANNEL( cullingChannel, Logger::WARNING,
+                        "Occlusion culling disabled, only culling against the frustum" );
+  }
+
+  VkSamplerCreateInfo samplerInfo{};
+  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  samplerInfo.magFilter = VK_FILTER_NEAREST;
+  samplerInfo.minFilter = VK_FILTER_NEAREST;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.minLod = 0.0f;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+  if ( vkCreateSampler( vulkanDevice_->device, &samplerInfo, nullptr, &pyramidSampler_ ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to create depth pyramid sampler!", Logger::CRITICAL );
+  }
+
+  create_frame_resources( drawBuffers );
+}
+
+void VulkanCulling::destroy() {
+  VkDevice device = vulkanDevice_->device;
+  // Destroyed with the rest of the deletion queue
+  retire_depth_pyramid( 0 );
+  vkDestroySampler( device, pyramidSampler_, nullptr );
+
+  statsBuffers_.clear();
+
+  vkDestroyDescriptorPool( device, cullPool_, nullptr );
+  vkDestroyDescriptorSetLayout( device, cullSetLayout_, nullptr );
+  vkDestroyDescriptorSetLayout( device, pyramidSetLayout_, nullptr );
+
+  for ( VulkanComputePipeline *pipeline : { cullPipeline_, seedPipeline_, pyramidPipeline_ } ) {
+    if ( pipeline != nullptr ) {
+      destroy_compute_pipeline( device, pipeline );
+      delete pipeline;
+    }
+  }
+}
+
+void VulkanCulling::resize( VkExtent2D extent, uint64_t timelineValue ) {
+  retire_depth_pyramid( timelineValue );
+  create_depth_pyramid( extent );
+}
+
+#pragma region Setup
+
+void VulkanCulling::create_descriptor_layouts() {
+  std::array<VkDescriptorSetLayoutBinding, 7> cullBindings = {
+      layout_binding( 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ),
+      layout_binding( 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC ),  // instances
+      layout_binding( 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC ),  // bounds
+      layout_binding( 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ),  // indirect commands
+      layout_binding( 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ),  // visible
+      layout_binding( 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ),  // stats
+      layout_binding( 6, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ) };
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.bindingCount = static_cast<uint32_t>( cullBindings.size() );
+  layoutInfo.pBindings = cullBindings.data();
+  if ( vkCreateDescriptorSetLayout( vulkanDevice_->device, &layoutInfo, nullptr,
+                                    &cullSetLayout_ ) != VK_SUCCESS ) {
+    Logger::log( "Failed to create culling descriptor set layout!", Logger::CRITICAL );
+  }
+
+  std::array<VkDescriptorSetLayoutBinding, 2> pyramidBindings = {
+      layout_binding( 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ),
+      layout_binding( 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ) };
+
+  layoutInfo.bindingCount = static_cast<uint32_t>( pyramidBindings.size() );
+  layoutInfo.pBindings = pyramidBindings.data();
+  if ( vkCreateDescriptorSetLayout( vulkanDevice_->device, &layoutInfo, nullptr,
+                                    &pyramidSetLayout_ ) != VK_SUCCESS ) {
+    Logger::log( "Failed to create depth pyramid descriptor set layout!", Logger::CRITICAL );
+  }
+}
+
+void VulkanCulling::create_frame_resources( const Construct::DrawBuffers &drawBuffers ) {
+  uint32_t frames = static_cast<uint32_t>( maxFramesInFlight_ );
+
+  std::array<VkDescriptorPoolSize, 4> poolSizes{};
+  poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  poolSizes[0].descriptorCount = frames;
+  poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+  poolSizes[1].descriptorCount = 2 * frames;
+  poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  poolSizes[2].descriptorCount = 3 * frames;
+  poolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  poolSizes[3].descriptorCount = frames;
+
+  VkDescriptorPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.poolSizeCount = static_cast<uint32_t>( poolSizes.size() );
+  poolInfo.pPoolSizes = poolSizes.data();
+  poolInfo.maxSets = frames;
+  if ( vkCreateDescriptorPool( vulkanDevice_->device, &poolInfo, nullptr, &cullPool_ ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to create culling descriptor pool!", Logger::CRITICAL );
+  }
+
+  std::vector<VkDescriptorSetLayout> layouts( frames, cullSetLayout_ );
+  VkDescriptorSetAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorPool = cullPool_;
+  allocInfo.descriptorSetCount = frames;
+  allocInfo.pSetLayouts = layouts.data();
+
+  cullSets_.resize( frames );
+  if ( vkAllocateDescriptorSets( vulkanDevice_->device, &allocInfo, cullSets_.data() ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to allocate culling descriptor sets!", Logger::CRITICAL );
+  }
+
+  dynamicOffsets_.assign( frames, { 0, 0, 0 } );
+  statsBuffers_.resize( frames );
+  statsMapped_.resize( frames );
+
+  for ( uint32_t i = 0; i < frames; i++ ) {
+    // Cleared on the GPU before each dispatch, read by the CPU once the frame is done
+    Buffer::create_buffer(
+        sizeof( CullingStats ),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        statsBuffers_[i], vulkanDevice_ );
+    statsMapped_[i] = statsBuffers_[i].allocation.mapped;
+    std::memset( statsMapped_[i], 0, sizeof( CullingStats ) );
+
+    // Uniforms, instances & bounds are bound at this frame's allocations
+    VkBuffer frameBuffer = frameAllocator_->buffer();
+    std::array<VkDescriptorBufferInfo, 6> bufferInfos{};
+    bufferInfos[0] = { frameBuffer, 0, sizeof( CullData ) };
+    bufferInfos[1] = { frameBuffer, 0, sizeof( InstanceData ) * MAX_DRAW_INSTANCES };
+    bufferInfos[2] = { frameBuffer, 0, sizeof( InstanceBounds ) * MAX_DRAW_INSTANCES };
+    bufferInfos[3] = { drawBuffers.indirectBuffers[i].buffer, 0, VK_WHOLE_SIZE };
+    bufferInfos[4] = { drawBuffers.visibleBuffers[i].buffer, 0, VK_WHOLE_SIZE };
+    bufferInfos[5] = { statsBuffers_[i].buffer, 0, sizeof( CullingStats ) };
+
+    std::array<VkWriteDescriptorSet, 6> writes{};
+    writes[0] = buffer_write( cullSets_[i], 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                              &bufferInfos[0] );
+    for ( uint32_t binding = 1; binding < writes.size(); binding++ ) {
+      VkDescriptorType type = binding <= 2 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
+                                           : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      writes[binding] = buffer_write( cullSets_[i], binding, type, &bufferInfos[binding] );
+    }
+    vkUpdateDescriptorSets( vulkanDevice_->device, static_cast<uint32_t>( writes.size() ),
+                            writes.data(), 0, nullptr );
+  }
+}
+
+void VulkanCulling::create_depth_pyramid( VkExtent2D extent ) {
+  depthExtent_ = extent;
+
+  // Power of two so every level halves exactly, level 0 covers the whole depth buffer
+  pyramidExtent_.width = previous_power_of_two( extent.width );
+  pyramidExtent_.height = previous_power_of_two( extent.height );
+  uint32_t levels = 1;
+  while ( levels < MAX_DEPTH_PYRAMID_LEVELS &&
+          ( pyramidExtent_.width >> levels | pyramidExtent_.height >> levels ) != 0 ) {
+    levels++;
+  }
+
+  // Created even without occlusion culling, cull.comp always binds it
+  Image::create_image( pyramidExtent_.width, pyramidExtent_.height, levels, VK_SAMPLE_COUNT_1_BIT,
+                       VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+                       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &pyramid_, vulkanDevice_ );
+  pyramid_.imageView = Image::create_image_view( vulkanDevice_->device, pyramid_.image,
+                                                 VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT,
+                                                 levels );
+
+  pyramidLevels_.resize( levels );
+  for ( uint32_t level = 0; level < levels; level++ ) {
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = pyramid_.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = level;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+    if ( vkCreateImageView( vulkanDevice_->device, &viewInfo, nullptr, &pyramidLevels_[level] ) !=
+         VK_SUCCESS ) {
+      Logger::log( "Failed to create depth pyramid level view!", Logger::CRITICAL );
+    }
+  }
+
+  // Cull sets may be in use by frames in flight, each is repointed once its frame comes around
+  pyramidStale_.assign( cullSets_.size(), true );
+
+  pyramidInitialized_ = false;
+  pyramidBuilt_ = false;
+  if ( !occlusion_supported() ) {
+    return;
+  }
+
+  // One set per level, reading the level below, level 0 reads the depth buffer
+  std::array<VkDescriptorPoolSize, 2> poolSizes{};
+  poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  poolSizes[0].descriptorCount = levels;
+  poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  poolSizes[1].descriptorCount = levels;
+
+  VkDescriptorPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.poolSizeCount = static_cast<uint32_t>( poolSizes.size() );
+  poolInfo.pPoolSizes = poolSizes.data();
+  poolInfo.maxSets = levels;
+  if ( vkCreateDescriptorPool( vulkanDevice_->device, &poolInfo, nullptr, &pyramidPool_ ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to create depth pyramid descriptor pool!", Logger::CRITICAL );
+  }
+
+  std::vector<VkDescriptorSetLayout> layouts( levels, pyramidSetLayout_ );
+  VkDescriptorSetAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorPool = pyramidPool_;
+  allocInfo.descriptorSetCount = levels;
+  allocInfo.pSetLayouts = layouts.data();
+
+  pyramidSets_.resize( levels );
+  if ( vkAllocateDescriptorSets( vulkanDevice_->device, &allocInfo, pyramidSets_.data() ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to allocate depth pyramid descriptor sets!", Logger::CRITICAL );
+  }
+
+  for ( uint32_t level = 0; level < levels; level++ ) {
+    VkDescriptorImageInfo sourceInfo{};
+    sourceInfo.sampler = pyramidSampler_;
+    if ( level == 0 ) {
+      sourceInfo.imageView = depthImage_->imageView;
+      sourceInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    } else {
+      sourceInfo.imageView = pyramidLevels_[level - 1];
+      sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+    VkDescriptorImageInfo levelInfo{ VK_NULL_HANDLE, pyramidLevels_[level],
+                                     VK_IMAGE_LAYOUT_GENERAL };
+
+    std::array<VkWriteDescriptorSet, 2> writes = {
+        image_write( pyramidSets_[level], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                     &sourceInfo ),
+        image_write( pyramidSets_[level], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &levelInfo ) };
+    vkUpdateDescriptorSets( vulkanDevice_->device, static_cast<uint32_t>( writes.size() ),
+                            writes.data(), 0, nullptr );
+  }
+
+  THUMPY_LOG_CHANNEL( cullingChannel, Logger::DEBUG, "Depth pyramid: ", pyramidExtent_.width, "x",
+                      pyramidExtent_.height, ", ", levels, " levels" );
+}
+
+void VulkanCulling::retire_depth_pyramid( uint64_t timelineValue ) {
+  // Frames in flight may still build or sample the old pyramid
+  DeletionQueue *deletionQueue = vulkanDevice_->deletionQueue;
+  if ( pyramidPool_ != VK_NULL_HANDLE ) {
+    deletionQueue->push( pyramidPool_, timelineValue );
+  }
+  for ( VkImageView view : pyramidLevels_ ) {
+    deletionQueue->push( view, timelineValue );
+  }
+  pyramid_.reset( timelineValue );
+  pyramidLevels_.clear();
+  pyramidPool_ = VK_NULL_HANDLE;
+  // Freed with their pool
+  pyramidSets_.clear();
+}
+
+#pragma endregion Setup
+
+#pragma region Frame
+
+void VulkanCulling::update( uint32_t frame, const glm::mat4 &view, const glm::mat4 &proj,
+                            uint32_t instanceCount, VkDeviceSize instanceOffset,
+                            VkDeviceSize boundsOffset ) {
+  // The frame's previous submission has finished, so its cull set can be rewritten
+  if ( pyramidStale_[frame] ) {
+    VkDescriptorImageInfo pyramidInfo{ pyramidSampler_, pyramid_.imageView,
+                                       VK_IMAGE_LAYOUT_GENERAL };
+    VkWriteDescriptorSet write =
+        image_write( cullSets_[frame], 6, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &pyramidInfo );
+    vkUpdateDescriptorSets( vulkanDevice_->device, 1, &write, 0, nullptr );
+    pyramidStale_[frame] = false;
+  }
+
+  glm::mat4 viewProj = proj * view;
+  glm::vec4 x = glm::row( viewProj, 0 );
+  glm::vec4 y = glm::row( viewProj, 1 );
+  glm::vec4 z = glm::row( viewProj, 2 );
+  glm::vec4 w = glm::row( viewProj, 3 );
+
+  CullData data{};
+  data.view = view;
+  data.frustum[0] = normalize_plane( w + x );
+  data.frustum[1] = normalize_plane( w - x );
+  data.frustum[2] = normalize_plane( w + y );
+  data.frustum[3] = normalize_plane( w - y );
+  data.frustum[4] = normalize_plane( z );  // Depth is 0 to 1
+  data.frustum[5] = normalize_plane( w - z );
+  data.projection = glm::vec4( proj[0][0], proj[1][1], proj[2][2], proj[3][2] );
+  data.pyramidSize = glm::vec2( static_cast<float>( pyramidExtent_.width ),
+                                static_cast<float>( pyramidExtent_.height ) );
+  data.instanceCount = instanceCount;
+  data.occlusion = occlusionEnabled_ && occlusion_supported() && pyramidBuilt_ ? 1 : 0;
+
+  FrameAllocation allocation = frameAllocator_->allocate_uniform( frame, sizeof( data ) );
+  std::memcpy( allocation.mapped, &data, sizeof( data ) );
+  dynamicOffsets_[frame] = { static_cast<uint32_t>( allocation.offset ),
+                             static_cast<uint32_t>( instanceOffset ),
+                             static_cast<uint32_t>( boundsOffset ) };
+}
+
+void VulkanCulling::record_cull( VkCommandBuffer commandBuffer, uint32_t frame,
+                                 uint32_t instanceCount ) {
+  if ( !pyramidInitialized_ ) {
+    VkImageMemoryBarrier toGeneral =
+        Initializer::image_memory_barrier( pyramid_.image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                           VK_IMAGE_LAYOUT_GENERAL,
+                                           static_cast<uint32_t>( pyramidLevels_.size() ) );
+    toGeneral.srcAccessMask = 0;
+    toGeneral.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                          &toGeneral );
+    pyramidInitialized_ = true;
+  }
+
+  vkCmdFillBuffer( commandBuffer, statsBuffers_[frame].buffer, 0, sizeof( CullingStats ), 0 );
+
+  // Stats cleared & the previous frame's depth pyramid written
+  VkMemoryBarrier before{};
+  before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  before.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  before.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier( commandBuffer,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &before, 0, nullptr, 0,
+                        nullptr );
+
+  if ( instanceCount > 0 ) {
+    vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                       cullPipeline_->computePipeline );
+    vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                             cullPipeline_->pipelineLayout, 0, 1, &cullSets_[frame],
+                             static_cast<uint32_t>( dynamicOffsets_[frame].size() ),
+                             dynamicOffsets_[frame].data() );
+    vkCmdDispatch( commandBuffer, group_count( instanceCount, CULL_GROUP_SIZE ), 1, 1 );
+  }
+
+  // Counts & visible indices feed the indirect draws, stats go back to the CPU
+  VkMemoryBarrier after{};
+  after.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  after.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  after.dstAccessMask =
+      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                            VK_PIPELINE_STAGE_HOST_BIT,
+                        0, 1, &after, 0, nullptr, 0, nullptr );
+}
+
+void VulkanCulling::record_depth_pyramid( VkCommandBuffer commandBuffer ) {
+  if ( !occlusion_supported() ) {
+    return;
+  }
+
+  // Depth written by the render pass, and this frame's cull is done reading the pyramid
+  VkImageMemoryBarrier depthRead{};
+  depthRead.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  depthRead.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  depthRead.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  depthRead.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  depthRead.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  depthRead.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  depthRead.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  depthRead.image = depthImage_->image;
+  depthRead.subresourceRange = { depthAspect_, 0, 1, 0, 1 };
+  vkCmdPipelineBarrier( commandBuffer,
+                        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                        &depthRead );
+
+  DepthPyramidReduce reduce{};
+  reduce.sourceSize[0] = static_cast<int32_t>( depthExtent_.width );
+  reduce.sourceSize[1] = static_cast<int32_t>( depthExtent_.height );
+  reduce.samples = static_cast<int32_t>( vulkanDevice_->msaaSamples );
+
+  for ( uint32_t level = 0; level < pyramidLevels_.size(); level++ ) {
+    VulkanComputePipeline *pipeline = level == 0 ? seedPipeline_ : pyramidPipeline_;
+    if ( level <= 1 ) {
+      vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                         pipeline->computePipeline );
+    }
+
+    if ( level > 0 ) {
+      // Wait for the level below
+      VkImageMemoryBarrier levelBarrier = Initializer::image_memory_barrier(
+          pyramid_.image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, 1 );
+      levelBarrier.subresourceRange.baseMipLevel = level - 1;
+      levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+      levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+      vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                            &levelBarrier );
+    }
+
+    uint32_t width = std::max( pyramidExtent_.width >> level, 1u );
+    uint32_t height = std::max( pyramidExtent_.height >> level, 1u );
+    reduce.levelSize[0] = static_cast<int32_t>( width );
+    reduce.levelSize[1] = static_cast<int32_t>( height );
+
+    vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                             pipeline->pipelineLayout, 0, 1, &pyramidSets_[level], 0, nullptr );
+    vkCmdPushConstants( commandBuffer, pipeline->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                        sizeof( reduce ), &reduce );
+    vkCmdDispatch( commandBuffer, group_count( width, DEPTH_PYRAMID_GROUP_SIZE ),
+                   group_count( height, DEPTH_PYRAMID_GROUP_SIZE ), 1 );
+
+    reduce.sourceSize[0] = reduce.levelSize[0];
+    reduce.sourceSize[1] = reduce.levelSize[1];
+  }
+
+  // Hand the depth buffer back to the next render pass
+  VkImageMemoryBarrier depthWrite = depthRead;
+  depthWrite.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  depthWrite.dstAccessMask =
+      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  depthWrite.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  depthWrite.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        0, 0, nullptr, 0, nullptr, 1, &depthWrite );
+
+  pyramidBuilt_ = true;
+}
+
+void VulkanCulling::read_stats( uint32_t frame ) {
+  std::memcpy( &stats_, statsMapped_[frame], sizeof( stats_ ) );
+}
+
+#pragma endregion Frame
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,210 @@
+/**
+ * @file vulkan_culling.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief GPU frustum & occlusion culling of draw list instances
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "vulkan_buffers.hpp"
+#include "vulkan_construct.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_frame_allocator.hpp"
+#include "vulkan_helper.hpp"
+#include "vulkan_pipeline.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+// Must match local_size in cull.comp & depth_pyramid*.comp
+const uint32_t CULL_GROUP_SIZE = 64;
+const uint32_t DEPTH_PYRAMID_GROUP_SIZE = 8;
+const uint32_t MAX_DEPTH_PYRAMID_LEVELS = 16;
+
+/**
+ * @brief Instances the culling pass looked at in a frame, read back once the frame finishes
+ *
+ */
+struct CullingStats {
+  uint32_t tested = 0;
+  uint32_t frustumCulled = 0;
+  uint32_t occlusionCulled = 0;
+};
+
+/**
+ * @brief Matches the CullData uniform in cull.comp
+ *
+ */
+struct CullData {
+  glm::mat4 view;
+  glm::vec4 frustum[6];  // World space planes: left, right, bottom, top, near, far
+  glm::vec4 projection;  // proj[0][0], proj[1][1], proj[2][2], proj[3][2]
+  glm::vec2 pyramidSize;
+  uint32_t instanceCount;
+  uint32_t occlusion;
+};
+
+/**
+ * @brief Matches the push constants in depth_pyramid*.comp
+ *
+ */
+struct DepthPyramidReduce {
+  int32_t sourceSize[2];
+  int32_t levelSize[2];
+  int32_t samples;
+};
+
+/**
+ * @brief Compute pre-pass that tests each draw list instance's bounding sphere against the
+ * frustum and a depth pyramid built from the previous frame's depth buffer. Survivors are
+ * counted into the frame's indirect commands and listed in its visible buffer.
+ *
+ * Disabled when cull.comp has not been compiled or the device can't offset instances in indirect
+ * draws. Occlusion is skipped, leaving frustum culling, when the depth buffer can't be sampled.
+ */
+class VulkanCulling {
+ public:
+  /**
+   * @brief Create the culling pipelines & per frame buffers. The depth buffer is created after,
+   * stored only if occlusion_supported(), then create_depth_pyramid builds the pyramid over it
+   *
+   * @param vulkanDevice
+   * @param maxFramesInFlight
+   * @param frameAllocator cull uniforms, instances & bounds are allocated from it each frame
+   * @param drawBuffers indirect & visible buffers per frame
+   * @param depthImage depth buffer of the render pass, rebuilt in place by the swap chain
+   */
+  VulkanCulling( VulkanDevice *vulkanDevice, int maxFramesInFlight,
+                 FrameAllocator *frameAllocator, const Construct::DrawBuffers &drawBuffers,
+                 VulkanImage *depthImage );
+
+  /**
+   * @brief Destroy everything, the device has to be idle
+   *
+   */
+  void destroy();
+
+  /**
+   * @brief Create the depth pyramid over the depth buffer, before the first frame. cull.comp
+   * binds it even without occlusion culling
+   * @param extent depth buffer size
+   */
+  void create_depth_pyramid( VkExtent2D extent );
+
+  /**
+   * @brief Rebuild the depth pyramid after the depth buffer was recreated. The old pyramid is
+   * destroyed once the GPU passed timelineValue & each frame's cull set is repointed the next
+   * time that frame is updated, so frames in flight are left alone.
+   * @param extent new depth buffer size
+   * @param timelineValue last submission that may use the old pyramid
+   */
+  void resize( VkExtent2D extent, uint64_t timelineValue );
+
+  bool enabled() const { return cullPipeline_ != nullptr; }
+
+  bool occlusion_supported() const { return seedPipeline_ != nullptr; }
+
+  void set_occlusion_culling( bool enabled ) { occlusionEnabled_ = enabled; }
+
+  /**
+   * @brief Allocate & write the frame's cull uniforms
+   *
+   * @param frame frame in flight index
+   * @param view
+   * @param proj
+   * @param instanceCount
+   * @param instanceOffset frame allocator offset of the frame's instances
+   * @param boundsOffset frame allocator offset of the frame's bounds
+   */
+  void update( uint32_t frame, const glm::mat4 &view, const glm::mat4 &proj,
+               uint32_t instanceCount, VkDeviceSize instanceOffset, VkDeviceSize boundsOffset );
+
+  /**
+   * @brief Record the culling dispatch, before the render pass that draws indirect
+   *
+   * @param commandBuffer
+   * @param frame frame in flight index
+   * @param instanceCount
+   */
+  void record_cull( VkCommandBuffer commandBuffer, uint32_t frame, uint32_t instanceCount );
+
+  /**
+   * @brief Record the depth pyramid build, after the render pass wrote the depth buffer
+   *
+   * @param commandBuffer
+   */
+  void record_depth_pyramid( VkCommandBuffer commandBuffer );
+
+  /**
+   * @brief Copy a finished frame's stats out of its mapped buffer
+   *
+   * @param frame frame in flight index, its last submission must have completed
+   */
+  void read_stats( uint32_t frame );
+
+  /**
+   * @brief Stats of the most recently read back frame
+   *
+   * @return const CullingStats&
+   */
+  const CullingStats &stats() const { return stats_; }
+
+ private:
+  void create_descriptor_layouts();
+  void create_frame_resources( const Construct::DrawBuffers &drawBuffers );
+  void retire_depth_pyramid( uint64_t timelineValue );
+
+  VulkanDevice *vulkanDevice_;
+  int maxFramesInFlight_;
+  FrameAllocator *frameAllocator_;
+  VulkanImage *depthImage_;
+  VkExtent2D depthExtent_;
+  VkImageAspectFlags depthAspect_;
+
+  VulkanComputePipeline *cullPipeline_ = nullptr;
+  VulkanComputePipeline *seedPipeline_ = nullptr;
+  VulkanComputePipeline *pyramidPipeline_ = nullptr;
+
+  VkDescriptorSetLayout cullSetLayout_;
+  VkDescriptorSetLayout pyramidSetLayout_;
+  VkDescriptorPool cullPool_;
+  VkDescriptorPool pyramidPool_ = VK_NULL_HANDLE;
+  std::vector<VkDescriptorSet> cullSets_;
+  std::vector<VkDescriptorSet> pyramidSets_;
+
+  // Per frame in flight
+  std::vector<std::array<uint32_t, 3>> dynamicOffsets_;  // Cull uniforms, instances, bounds
+  std::vector<Buffer::Buffer> statsBuffers_;
+  std::vector<void *> statsMapped_;
+
+  // Max depth pyramid, power of two sized
+  VulkanImage pyramid_{};
+  VkSampler pyramidSampler_;
+  std::vector<VkImageView> pyramidLevels_;
+  VkExtent2D pyramidExtent_;
+  bool pyramidInitialized_ = false;  // In VK_IMAGE_LAYOUT_GENERAL
+  bool pyramidBuilt_ = false;        // Holds a previous frame's depth
+  std::vector<bool> pyramidStale_;   // Per frame, cull set still points at a retired pyramid
+
+  bool occlusionEnabled_ = true;
+  CullingStats stats_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -37,9 +37,7 @@ debug_callback( VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                 VkDebugUtilsMessageTypeFlagsEXT messageType,
                 const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData,
                 void *pUserData ) {
-  std::string message = "validation layer: ";
-  message.append( pCallbackData->pMessage );
-  Logger::log( message, Logger::DEBUG );
+  THUMPY_LOG( Logger::DEBUG, "validation layer: ", pCallbackData->pMessage );
 
   return VK_FALSE;
 }
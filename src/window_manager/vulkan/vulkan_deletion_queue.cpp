@@ -0,0 +1,181 @@
+/**
+ * @file vulkan_deletion_queue.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_deletion_queue cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_deletion_queue.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "channel.hpp"
+#include "logger.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_memory.hpp"
+#include "vulkan_timeline.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+Logger::Channel &deletionChannel = Logger::get_channel( "Vulkan::Deletion" );
+
+}  // namespace
+
+DeletionQueue::DeletionQueue( VulkanDevice *vulkanDevice ) : vulkanDevice_( vulkanDevice ) {}
+
+void DeletionQueue::destroy() {
+  THUMPY_LOG_CHANNEL( deletionChannel, Logger::DEBUG, "Destroying ", pending(),
+                      " queued objects" );
+  for ( ; head_ < deletions_.size(); head_++ ) {
+    destroy_object( deletions_[head_] );
+  }
+  deletions_.clear();
+  head_ = 0;
+}
+
+void DeletionQueue::process() {
+  if ( head_ == deletions_.size() ) {
+    return;
+  }
+
+  uint32_t destroyed = 0;
+  for ( ; head_ < deletions_.size() && destroyed < MAX_DELETIONS_PER_FRAME; destroyed++ ) {
+    Deletion &deletion = deletions_[head_];
+    if ( !vulkanDevice_->timeline->is_complete( deletion.timelineValue ) ) {
+      break;
+    }
+    destroy_object( deletion );
+    head_++;
+  }
+
+  if ( head_ == deletions_.size() ) {
+    deletions_.clear();
+    head_ = 0;
+  } else if ( head_ > deletions_.size() / 2 ) {
+    // Never empties while objects keep coming, drop the processed half instead
+    deletions_.erase( deletions_.begin(), deletions_.begin() + head_ );
+    head_ = 0;
+  }
+
+  if ( destroyed > 0 ) {
+    THUMPY_LOG_CHANNEL( deletionChannel, Logger::DEBUG, "Destroyed ", destroyed, " objects, ",
+                        pending(), " pending" );
+  }
+}
+
+void DeletionQueue::push( VkBuffer buffer, MemoryAllocation &allocation,
+                          uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_BUFFER, buffer, timelineValue, allocation );
+  allocation = MemoryAllocation();
+}
+
+void DeletionQueue::push( VkImage image, MemoryAllocation &allocation, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_IMAGE, image, timelineValue, allocation );
+  allocation = MemoryAllocation();
+}
+
+void DeletionQueue::push( VkImageView imageView, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_IMAGE_VIEW, imageView, timelineValue );
+}
+
+void DeletionQueue::push( VkFramebuffer framebuffer, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_FRAMEBUFFER, framebuffer, timelineValue );
+}
+
+void DeletionQueue::push( VkSwapchainKHR swapChain, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_SWAPCHAIN_KHR, swapChain, timelineValue );
+}
+
+void DeletionQueue::push( VkDescriptorPool pool, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_DESCRIPTOR_POOL, pool, timelineValue );
+}
+
+void DeletionQueue::push( VkDescriptorSetLayout setLayout, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, setLayout, timelineValue );
+}
+
+void DeletionQueue::push( VkSampler sampler, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_SAMPLER, sampler, timelineValue );
+}
+
+void DeletionQueue::push( VkPipeline pipeline, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_PIPELINE, pipeline, timelineValue );
+}
+
+void DeletionQueue::push( VkCommandPool pool, uint64_t timelineValue ) {
+  enqueue( VK_OBJECT_TYPE_COMMAND_POOL, pool, timelineValue );
+}
+
+template <typename Handle>
+void DeletionQueue::enqueue( VkObjectType type, Handle handle, uint64_t timelineValue,
+                             MemoryAllocation allocation ) {
+  if ( timelineValue == LAST_SUBMISSION ) {
+    timelineValue = vulkanDevice_->timeline->submitted_value();
+  }
+  // Keeps the queue sorted, an object is never destroyed before one queued ahead of it
+  newestValue_ = std::max( newestValue_, timelineValue );
+  deletions_.push_back(
+      Deletion{ newestValue_, type, reinterpret_cast<uint64_t>( handle ), allocation } );
+}
+
+void DeletionQueue::destroy_object( Deletion &deletion ) {
+  VkDevice device = vulkanDevice_->device;
+  switch ( deletion.type ) {
+    case VK_OBJECT_TYPE_BUFFER:
+      vkDestroyBuffer( device, reinterpret_cast<VkBuffer>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_IMAGE:
+      vkDestroyImage( device, reinterpret_cast<VkImage>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_IMAGE_VIEW:
+      vkDestroyImageView( device, reinterpret_cast<VkImageView>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_FRAMEBUFFER:
+      vkDestroyFramebuffer( device, reinterpret_cast<VkFramebuffer>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+      vkDestroySwapchainKHR( device, reinterpret_cast<VkSwapchainKHR>( deletion.handle ),
+                             nullptr );
+      break;
+    case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+      vkDestroyDescriptorPool( device, reinterpret_cast<VkDescriptorPool>( deletion.handle ),
+                               nullptr );
+      break;
+    case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+      vkDestroyDescriptorSetLayout(
+          device, reinterpret_cast<VkDescriptorSetLayout>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_SAMPLER:
+      vkDestroySampler( device, reinterpret_cast<VkSampler>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_PIPELINE:
+      vkDestroyPipeline( device, reinterpret_cast<VkPipeline>( deletion.handle ), nullptr );
+      break;
+    case VK_OBJECT_TYPE_COMMAND_POOL:
+      vkDestroyCommandPool( device, reinterpret_cast<VkCommandPool>( deletion.handle ), nullptr );
+      break;
+    default:
+      Logger::log( "Unknown object type in deletion queue!", Logger::CRITICAL );
+      break;
+  }
+
+  // Memory is freed after the object bound to it
+  vulkanDevice_->allocator->free( deletion.allocation );
+}
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,115 @@
+/**
+ * @file vulkan_deletion_queue.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Destroys Vulkan objects once the GPU timeline is past their last use
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "vulkan_memory.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+class VulkanDevice;
+
+// Most objects destroyed by one process(), the rest wait for the next frame
+const uint32_t MAX_DELETIONS_PER_FRAME = 64;
+
+// Pass as the timeline value when the object may be used by anything submitted so far
+const uint64_t LAST_SUBMISSION = UINT64_MAX;
+
+/**
+ * @brief Objects & memory waiting for the GPU to finish with them, oldest first.
+ * Values are raised to the newest one queued so far, so the queue stays sorted and process()
+ * stops at the first object still in use. Not thread safe, queue from the render thread.
+ */
+class DeletionQueue {
+ public:
+  DeletionQueue( VulkanDevice *vulkanDevice );
+
+  /**
+   * @brief Destroy everything still queued, the device has to be idle
+   *
+   */
+  void destroy();
+
+  /**
+   * @brief Destroy up to MAX_DELETIONS_PER_FRAME objects the GPU has finished with, never blocks.
+   * Called once per frame
+   */
+  void process();
+
+  /**
+   * @brief Queue a buffer & its memory
+   *
+   * @param buffer
+   * @param allocation reset, the queue owns it now
+   * @param timelineValue last submission that may use it
+   */
+  void push( VkBuffer buffer, MemoryAllocation &allocation, uint64_t timelineValue );
+
+  /**
+   * @brief Queue an image & its memory
+   *
+   * @param image
+   * @param allocation reset, the queue owns it now
+   * @param timelineValue last submission that may use it
+   */
+  void push( VkImage image, MemoryAllocation &allocation, uint64_t timelineValue );
+
+  void push( VkImageView imageView, uint64_t timelineValue );
+  void push( VkFramebuffer framebuffer, uint64_t timelineValue );
+  void push( VkSwapchainKHR swapChain, uint64_t timelineValue );
+  void push( VkDescriptorPool pool, uint64_t timelineValue );
+  void push( VkDescriptorSetLayout setLayout, uint64_t timelineValue );
+  void push( VkSampler sampler, uint64_t timelineValue );
+  void push( VkPipeline pipeline, uint64_t timelineValue );
+  void push( VkCommandPool pool, uint64_t timelineValue );
+
+  /**
+   * @brief Objects still waiting
+   *
+   * @return size_t
+   */
+  size_t pending() const { return deletions_.size() - head_; }
+
+ private:
+  struct Deletion {
+    uint64_t timelineValue;
+    VkObjectType type;
+    uint64_t handle;
+    MemoryAllocation allocation;
+  };
+
+  template <typename Handle>
+  void enqueue( VkObjectType type, Handle handle, uint64_t timelineValue,
+                MemoryAllocation allocation = MemoryAllocation() );
+
+  void destroy_object( Deletion &deletion );
+
+  VulkanDevice *vulkanDevice_;
+
+  // Processed entries before head_ are dropped once the rest is empty, so pushing only
+  // allocates while the queue grows past its largest size
+  std::vector<Deletion> deletions_;
+  size_t head_ = 0;
+  uint64_t newestValue_ = 0;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
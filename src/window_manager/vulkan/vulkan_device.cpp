@@ -14,15 +14,39 @@
 #include <vulkan/vulkan_core.h>
 
 #include <set>
+#include <string>
 #include <vector>
 
 #include "vulkan/vulkan_helper.hpp"
+#include "vulkan_deletion_queue.hpp"
+#include "vulkan_memory.hpp"
+#include "vulkan_timeline.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+namespace {
+
+bool has_device_extension( VkPhysicalDevice device, const char *name ) {
+  uint32_t extensionCount;
+  vkEnumerateDeviceExtensionProperties( device, nullptr, &extensionCount, nullptr );
+
+  std::vector<VkExtensionProperties> availableExtensions( extensionCount );
+  vkEnumerateDeviceExtensionProperties( device, nullptr, &extensionCount,
+                                        availableExtensions.data() );
+
+  for ( const auto &extension : availableExtensions ) {
+    if ( std::string( extension.extensionName ) == name ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 VulkanDevice::VulkanDevice( VkInstance instance, VkSurfaceKHR surface ) {
   surface_ = surface;
   setup_device( instance );
@@ -60,9 +84,16 @@ void VulkanDevice::pick_physical_device( VkInstance instance ) {
 void VulkanDevice::create_logical_device() {
   QueueFamilyIndices indices = find_queue_families( physicalDevice );
 
+  // Waiting on the transfer queue from the graphics queue needs timeline semaphores
+  timelineSemaphores = check_timeline_semaphore_support( physicalDevice );
+  dedicatedTransfer = timelineSemaphores && indices.transferFamily.has_value();
+
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
   std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(),
                                              indices.presentFamily.value() };
+  if ( dedicatedTransfer ) {
+    uniqueQueueFamilies.insert( indices.transferFamily.value() );
+  }
 
   float queuePriority = 1.0f;
   for ( uint32_t queueFamily : uniqueQueueFamilies ) {
@@ -74,9 +105,17 @@ void VulkanDevice::create_logical_device() {
     queueCreateInfos.push_back( queueCreateInfo );
   }
 
+  VkPhysicalDeviceFeatures supportedFeatures;
+  vkGetPhysicalDeviceFeatures( physicalDevice, &supportedFeatures );
+
   VkPhysicalDeviceFeatures deviceFeatures{};
   deviceFeatures.samplerAnisotropy = VK_TRUE;
   deviceFeatures.sampleRateShading = VK_FALSE;
+  // Optional, the renderer falls back to fewer indirect calls per draw without them
+  deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+  deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+  multiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+  drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
 
   VkDeviceCreateInfo createInfo{};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -86,8 +125,47 @@ void VulkanDevice::create_logical_device() {
 
   createInfo.pEnabledFeatures = &deviceFeatures;
 
-  createInfo.enabledExtensionCount = static_cast<uint32_t>( deviceExtensions.size() );
-  createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+  std::vector<const char *> extensions = deviceExtensions;
+  // Optional feature structs are chained onto createInfo
+  void *featureChain = nullptr;
+
+  VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+  timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+  timelineFeatures.timelineSemaphore = VK_TRUE;
+  if ( timelineSemaphores ) {
+    timelineFeatures.pNext = featureChain;
+    featureChain = &timelineFeatures;
+  }
+
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+  dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+  dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+  dynamicRendering = check_dynamic_rendering_support( physicalDevice );
+  if ( dynamicRendering ) {
+    dynamicRenderingFeatures.pNext = featureChain;
+    featureChain = &dynamicRenderingFeatures;
+    extensions.push_back( VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME );
+  }
+
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+  presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+  presentIdFeatures.presentId = VK_TRUE;
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+  presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+  presentWaitFeatures.presentWait = VK_TRUE;
+  presentWait = check_present_wait_support( physicalDevice );
+  if ( presentWait ) {
+    presentIdFeatures.pNext = featureChain;
+    presentWaitFeatures.pNext = &presentIdFeatures;
+    featureChain = &presentWaitFeatures;
+    extensions.push_back( VK_KHR_PRESENT_ID_EXTENSION_NAME );
+    extensions.push_back( VK_KHR_PRESENT_WAIT_EXTENSION_NAME );
+  }
+
+  createInfo.pNext = featureChain;
+
+  createInfo.enabledExtensionCount = static_cast<uint32_t>( extensions.size() );
+  createInfo.ppEnabledExtensionNames = extensions.data();
 
   if ( enableValidationLayers ) {
     createInfo.enabledLayerCount = static_cast<uint32_t>( validationLayers.size() );
@@ -102,6 +180,93 @@ void VulkanDevice::create_logical_device() {
 
   vkGetDeviceQueue( device, indices.graphicsFamily.value(), 0, &graphicsQueue );
   vkGetDeviceQueue( device, indices.presentFamily.value(), 0, &presentQueue );
+  if ( dedicatedTransfer ) {
+    vkGetDeviceQueue( device, indices.transferFamily.value(), 0, &transferQueue );
+  }
+
+  if ( dynamicRendering ) {
+    cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+        vkGetDeviceProcAddr( device, "vkCmdBeginRenderingKHR" ) );
+    cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+        vkGetDeviceProcAddr( device, "vkCmdEndRenderingKHR" ) );
+    dynamicRendering = cmdBeginRendering != nullptr && cmdEndRendering != nullptr;
+  }
+
+  if ( presentWait ) {
+    waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+        vkGetDeviceProcAddr( device, "vkWaitForPresentKHR" ) );
+    presentWait = waitForPresent != nullptr;
+  }
+
+  timeline = new VulkanTimeline( this );
+  allocator = new MemoryAllocator( this );
+  deletionQueue = new DeletionQueue( this );
+}
+
+bool VulkanDevice::check_timeline_semaphore_support( VkPhysicalDevice device ) {
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( device, &properties );
+  if ( properties.apiVersion < VK_API_VERSION_1_2 ) {
+    return false;
+  }
+
+  VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+  timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &timelineFeatures;
+  vkGetPhysicalDeviceFeatures2( device, &features );
+
+  return timelineFeatures.timelineSemaphore == VK_TRUE;
+}
+
+bool VulkanDevice::check_dynamic_rendering_support( VkPhysicalDevice device ) {
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( device, &properties );
+  if ( properties.apiVersion < VK_API_VERSION_1_2 ) {
+    return false;
+  }
+
+  if ( !has_device_extension( device, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME ) ) {
+    return false;
+  }
+
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+  dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &dynamicRenderingFeatures;
+  vkGetPhysicalDeviceFeatures2( device, &features );
+
+  return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+}
+
+bool VulkanDevice::check_present_wait_support( VkPhysicalDevice device ) {
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( device, &properties );
+  if ( properties.apiVersion < VK_API_VERSION_1_2 ) {
+    return false;
+  }
+
+  if ( !has_device_extension( device, VK_KHR_PRESENT_ID_EXTENSION_NAME ) ||
+       !has_device_extension( device, VK_KHR_PRESENT_WAIT_EXTENSION_NAME ) ) {
+    return false;
+  }
+
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+  presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+  presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+  presentWaitFeatures.pNext = &presentIdFeatures;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &presentWaitFeatures;
+  vkGetPhysicalDeviceFeatures2( device, &features );
+
+  return presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
 }
 
 bool VulkanDevice::is_device_suitable( VkPhysicalDevice device ) {
@@ -151,6 +316,21 @@ QueueFamilyIndices VulkanDevice::find_queue_families( VkPhysicalDevice device )
     i++;
   }
 
+  // Prefer a transfer only family, then one that can also compute but not draw
+  for ( uint32_t family = 0; family < queueFamilyCount; family++ ) {
+    VkQueueFlags flags = queueFamilies[family].queueFlags;
+    if ( !( flags & VK_QUEUE_TRANSFER_BIT ) || ( flags & VK_QUEUE_GRAPHICS_BIT ) ) {
+      continue;
+    }
+    if ( !( flags & VK_QUEUE_COMPUTE_BIT ) ) {
+      indices.transferFamily = family;
+      break;
+    }
+    if ( !indices.transferFamily.has_value() ) {
+      indices.transferFamily = family;
+    }
+  }
+
   return indices;
 }
 
@@ -24,6 +24,10 @@ namespace Vulkan {
 
 const std::vector<const char *> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
+class VulkanTimeline;
+class MemoryAllocator;
+class DeletionQueue;
+
 class VulkanDevice {
  public:
   VulkanDevice( VkInstance instance, VkSurfaceKHR surface );
@@ -38,6 +42,30 @@ class VulkanDevice {
   void pick_physical_device( VkInstance instance );
   void create_logical_device();
 
+  /**
+   * @brief Check for Vulkan 1.2 timeline semaphore support
+   *
+   * @param device
+   * @return bool
+   */
+  bool check_timeline_semaphore_support( VkPhysicalDevice device );
+
+  /**
+   * @brief Check for VK_KHR_dynamic_rendering and its feature
+   *
+   * @param device
+   * @return bool
+   */
+  bool check_dynamic_rendering_support( VkPhysicalDevice device );
+
+  /**
+   * @brief Check for VK_KHR_present_id & VK_KHR_present_wait and their features
+   *
+   * @param device
+   * @return bool
+   */
+  bool check_present_wait_support( VkPhysicalDevice device );
+
   /**
    * @brief Checks if device is compatible with vulkan
    *
@@ -56,9 +84,29 @@ class VulkanDevice {
 
   VkQueue graphicsQueue;
   VkQueue presentQueue;
+  // Only set when dedicatedTransfer, uploads go through the graphics queue otherwise
+  VkQueue transferQueue = VK_NULL_HANDLE;
 
   VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
 
+  bool timelineSemaphores = false;
+  bool dedicatedTransfer = false;
+  bool multiDrawIndirect = false;
+  bool drawIndirectFirstInstance = false;
+  // Render without VkRenderPass & VkFramebuffer objects, the render pass path is the fallback
+  bool dynamicRendering = false;
+  PFN_vkCmdBeginRenderingKHR cmdBeginRendering = nullptr;
+  PFN_vkCmdEndRenderingKHR cmdEndRendering = nullptr;
+  // Wait for a present id to reach the screen, frame latency is timed up to present with it
+  bool presentWait = false;
+  PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+  // GPU progress for every submission on this device
+  VulkanTimeline *timeline = nullptr;
+  // Every device memory allocation goes through this
+  MemoryAllocator *allocator = nullptr;
+  // Objects waiting for the GPU to finish with them
+  DeletionQueue *deletionQueue = nullptr;
+
  private:
   VkSurfaceKHR surface_;
 };
@@ -0,0 +1,166 @@
+/**
+ * @file vulkan_draw_list.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_draw_list cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_draw_list.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+#include "logger.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+glm::vec4 bounding_sphere( const std::vector<Vertex> &vertices ) {
+  if ( vertices.empty() ) {
+    return glm::vec4( 0.0f );
+  }
+
+  // Center of the bounding box, not the tightest sphere but close enough to cull with
+  glm::vec3 low = vertices[0].pos;
+  glm::vec3 high = vertices[0].pos;
+  for ( const Vertex &vertex : vertices ) {
+    low = glm::min( low, vertex.pos );
+    high = glm::max( high, vertex.pos );
+  }
+  glm::vec3 center = ( low + high ) * 0.5f;
+
+  float radius = 0.0f;
+  for ( const Vertex &vertex : vertices ) {
+    radius = std::max( radius, glm::length( vertex.pos - center ) );
+  }
+  return glm::vec4( center, radius );
+}
+
+DrawRange split_draws( uint32_t commandCount, uint32_t rangeCount, uint32_t range ) {
+  // The first commandCount % rangeCount ranges take one extra command
+  uint32_t size = commandCount / rangeCount;
+  uint32_t extra = commandCount % rangeCount;
+  return DrawRange{ range * size + std::min( range, extra ), size + ( range < extra ? 1 : 0 ) };
+}
+
+DrawList::DrawList() {
+  pending_.reserve( MAX_DRAW_INSTANCES );
+  models_.reserve( MAX_DRAW_INSTANCES );
+  instances_.reserve( MAX_DRAW_INSTANCES );
+  bounds_.reserve( MAX_DRAW_INSTANCES );
+  commands_.reserve( MAX_DRAW_COMMANDS );
+  batches_.reserve( MAX_DRAW_COMMANDS );
+  materials_.push_back( glm::vec4( 1.0f ) );
+}
+
+void DrawList::set_geometry( VkBuffer vertexBuffer, VkBuffer indexBuffer ) {
+  vertexBuffer_ = vertexBuffer;
+  indexBuffer_ = indexBuffer;
+}
+
+uint32_t DrawList::add_mesh( const MeshRange &mesh ) {
+  meshes_.push_back( mesh );
+  return static_cast<uint32_t>( meshes_.size() - 1 );
+}
+
+uint32_t DrawList::add_material( const glm::vec4 &color ) {
+  if ( materials_.size() >= MAX_DRAW_MATERIALS ) {
+    THUMPY_LOG( Logger::WARNING, "Draw list is out of materials, using the default one" );
+    return 0;
+  }
+  materials_.push_back( color );
+  return static_cast<uint32_t>( materials_.size() - 1 );
+}
+
+glm::vec4 DrawList::material_color( uint32_t material ) const {
+  return material < materials_.size() ? materials_[material] : glm::vec4( 1.0f );
+}
+
+bool DrawList::add_instance( uint32_t mesh, const glm::mat4 &model, uint32_t material,
+                             VulkanPipeline *pipeline ) {
+  if ( pending_.size() >= MAX_DRAW_INSTANCES || mesh >= meshes_.size() ) {
+    return false;
+  }
+  pending_.push_back(
+      PendingInstance{ pipeline, material, mesh, static_cast<uint32_t>( models_.size() ) } );
+  models_.push_back( model );
+  return true;
+}
+
+void DrawList::clear() {
+  pending_.clear();
+  models_.clear();
+  instances_.clear();
+  bounds_.clear();
+  commands_.clear();
+  batches_.clear();
+}
+
+void DrawList::build() {
+  instances_.clear();
+  bounds_.clear();
+  commands_.clear();
+  batches_.clear();
+
+  // Group by pipeline, then material, then mesh, so each group is one command
+  std::sort( pending_.begin(), pending_.end(),
+             []( const PendingInstance &a, const PendingInstance &b ) {
+               if ( a.pipeline != b.pipeline ) {
+                 return std::less<VulkanPipeline *>()( a.pipeline, b.pipeline );
+               }
+               if ( a.material != b.material ) {
+                 return a.material < b.material;
+               }
+               return a.mesh < b.mesh;
+             } );
+
+  const PendingInstance *previous = nullptr;
+  for ( const PendingInstance &instance : pending_ ) {
+    bool newBatch = previous == nullptr || instance.pipeline != previous->pipeline ||
+                    instance.material != previous->material;
+    bool newCommand = newBatch || instance.mesh != previous->mesh;
+
+    if ( newCommand ) {
+      if ( commands_.size() == MAX_DRAW_COMMANDS ) {
+        THUMPY_LOG( Logger::WARNING, "Draw list is out of indirect commands, dropped ",
+                    pending_.size() - instances_.size(), " instances" );
+        break;
+      }
+
+      const MeshRange &mesh = meshes_[instance.mesh];
+      VkDrawIndexedIndirectCommand command{};
+      command.indexCount = mesh.indexCount;
+      command.instanceCount = 0;
+      command.firstIndex = mesh.firstIndex;
+      command.vertexOffset = mesh.vertexOffset;
+      command.firstInstance = static_cast<uint32_t>( instances_.size() );
+      commands_.push_back( command );
+
+      if ( newBatch ) {
+        batches_.push_back( DrawBatch{ instance.pipeline, instance.material,
+                                       static_cast<uint32_t>( commands_.size() - 1 ), 0 } );
+      }
+      batches_.back().commandCount++;
+    }
+
+    instances_.push_back( InstanceData{ models_[instance.model] } );
+    bounds_.push_back( InstanceBounds{ meshes_[instance.mesh].bounds,
+                                       static_cast<uint32_t>( commands_.size() - 1 ) } );
+    commands_.back().instanceCount++;
+    previous = &instance;
+  }
+}
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
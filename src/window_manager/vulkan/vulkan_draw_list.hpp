@@ -0,0 +1,203 @@
+/**
+ * @file vulkan_draw_list.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Mesh instances for a frame, batched into indirect draw commands
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "vulkan_helper.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+struct VulkanPipeline;
+
+// Per frame storage & indirect buffers are sized for these
+const uint32_t MAX_DRAW_INSTANCES = 16384;
+const uint32_t MAX_DRAW_COMMANDS = 1024;
+
+/**
+ * @brief Where a mesh lives in the shared vertex & index buffers
+ *
+ */
+struct MeshRange {
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  int32_t vertexOffset = 0;
+  // Object space bounding sphere, xyz center & w radius. A radius of 0 is never culled
+  glm::vec4 bounds{ 0.0f };
+};
+
+/**
+ * @brief Per instance data, matches the std430 InstanceBuffer in instanced.vert
+ *
+ */
+struct InstanceData {
+  glm::mat4 model;
+};
+
+/**
+ * @brief What the culling pass needs per instance, matches InstanceBounds in cull.comp
+ *
+ */
+struct InstanceBounds {
+  glm::vec4 sphere;  // Object space, from the instance's mesh
+  uint32_t command;  // Indirect command the instance is drawn by
+  uint32_t padding[3];
+};
+
+/**
+ * @brief Bounding sphere around every vertex of a mesh, for MeshRange::bounds
+ *
+ * @param vertices
+ * @return glm::vec4 xyz center & w radius
+ */
+glm::vec4 bounding_sphere( const std::vector<Vertex> &vertices );
+
+/**
+ * @brief A run of indirect commands that share a pipeline & material, one API call
+ * with multi-draw indirect
+ */
+struct DrawBatch {
+  VulkanPipeline *pipeline = nullptr;
+  uint32_t material = 0;  // Pushed before the batch's draws
+  uint32_t firstCommand = 0;
+  uint32_t commandCount = 0;
+};
+
+/**
+ * @brief A contiguous run of indirect commands, the share of one recording thread
+ *
+ */
+struct DrawRange {
+  uint32_t firstCommand = 0;
+  uint32_t commandCount = 0;
+};
+
+/**
+ * @brief Split commands into near equal contiguous ranges, in command order
+ *
+ * @param commandCount
+ * @param rangeCount
+ * @param range which range to get, below rangeCount
+ * @return DrawRange
+ */
+DrawRange split_draws( uint32_t commandCount, uint32_t rangeCount, uint32_t range );
+
+/**
+ * @brief Instances to draw this frame.
+ * Fill with add_instance, then build() sorts them by pipeline, material & mesh into one
+ * VkDrawIndexedIndirectCommand per mesh. Storage is kept between frames, so once warmed up
+ * clear / add_instance / build do not allocate.
+ */
+class DrawList {
+ public:
+  DrawList();
+
+  /**
+   * @brief Set the vertex & index buffers every mesh is drawn from
+   *
+   * @param vertexBuffer
+   * @param indexBuffer
+   */
+  void set_geometry( VkBuffer vertexBuffer, VkBuffer indexBuffer );
+
+  /**
+   * @brief Register a mesh in the shared geometry
+   *
+   * @param mesh
+   * @return uint32_t mesh id for add_instance
+   */
+  uint32_t add_mesh( const MeshRange &mesh );
+
+  /**
+   * @brief Register a material, its color tints every instance drawn with it
+   *
+   * @param color
+   * @return uint32_t material id for add_instance, 0 is the default white material and is also
+   * returned once MAX_DRAW_MATERIALS are registered
+   */
+  uint32_t add_material( const glm::vec4 &color );
+
+  /**
+   * @brief Color of a material, white for ids that were never registered
+   *
+   * @param material
+   * @return glm::vec4
+   */
+  glm::vec4 material_color( uint32_t material ) const;
+
+  /**
+   * @brief Queue an instance of a mesh
+   *
+   * @param mesh id from add_mesh
+   * @param model transform
+   * @param material
+   * @param pipeline nullptr for the render's default pipeline
+   * @return false if the list already holds MAX_DRAW_INSTANCES
+   */
+  bool add_instance( uint32_t mesh, const glm::mat4 &model, uint32_t material = 0,
+                     VulkanPipeline *pipeline = nullptr );
+
+  /**
+   * @brief Drop all instances, keeps meshes & geometry
+   *
+   */
+  void clear();
+
+  /**
+   * @brief Sort the instances and build the indirect commands & batches
+   *
+   */
+  void build();
+
+  VkBuffer vertex_buffer() const { return vertexBuffer_; }
+  VkBuffer index_buffer() const { return indexBuffer_; }
+
+  const std::vector<InstanceData> &instances() const { return instances_; }
+  const std::vector<InstanceBounds> &bounds() const { return bounds_; }
+  const std::vector<VkDrawIndexedIndirectCommand> &commands() const { return commands_; }
+  const std::vector<DrawBatch> &batches() const { return batches_; }
+  const std::vector<glm::vec4> &materials() const { return materials_; }
+
+ private:
+  struct PendingInstance {
+    VulkanPipeline *pipeline;
+    uint32_t material;
+    uint32_t mesh;
+    uint32_t model;  // index into models_
+  };
+
+  VkBuffer vertexBuffer_ = VK_NULL_HANDLE;
+  VkBuffer indexBuffer_ = VK_NULL_HANDLE;
+  std::vector<MeshRange> meshes_;
+  std::vector<glm::vec4> materials_;
+
+  std::vector<PendingInstance> pending_;
+  std::vector<glm::mat4> models_;
+
+  // Built, in the order the GPU sees them
+  std::vector<InstanceData> instances_;
+  std::vector<InstanceBounds> bounds_;
+  std::vector<VkDrawIndexedIndirectCommand> commands_;
+  std::vector<DrawBatch> batches_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,101 @@
+/**
+ * @file vulkan_frame_allocator.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_frame_allocator cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_frame_allocator.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "channel.hpp"
+#include "logger.hpp"
+#include "vulkan_buffers.hpp"
+#include "vulkan_memory.hpp"
+#include "vulkan_timeline.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+Logger::Channel &frameAllocatorChannel = Logger::get_channel( "Vulkan::FrameAllocator" );
+
+}  // namespace
+
+bool LinearAllocator::allocate( VkDeviceSize size, VkDeviceSize alignment,
+                                VkDeviceSize *offset ) {
+  VkDeviceSize start = ( head_ + alignment - 1 ) & ~( alignment - 1 );
+  if ( start > capacity_ || size > capacity_ - start ) {
+    return false;
+  }
+  *offset = start;
+  head_ = start + size;
+  return true;
+}
+
+FrameAllocator::FrameAllocator( VulkanDevice *vulkanDevice, int maxFramesInFlight,
+                                VkDeviceSize frameSize, VkDeviceSize maxBindingRange ) {
+  vulkanDevice_ = vulkanDevice;
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( vulkanDevice_->physicalDevice, &properties );
+  uniformAlignment_ = properties.limits.minUniformBufferOffsetAlignment;
+  storageAlignment_ = properties.limits.minStorageBufferOffsetAlignment;
+
+  // Regions start aligned for anything allocated from them
+  VkDeviceSize regionAlignment = std::max( uniformAlignment_, storageAlignment_ );
+  frameSize_ = ( frameSize + regionAlignment - 1 ) & ~( regionAlignment - 1 );
+
+  regions_.assign( maxFramesInFlight, LinearAllocator( frameSize_ ) );
+  timelineValues_.assign( maxFramesInFlight, 0 );
+
+  VkDeviceSize bufferSize = frameSize_ * maxFramesInFlight + maxBindingRange;
+  Buffer::create_buffer(
+      bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer_,
+      vulkanDevice_ );
+
+  mapped_ = static_cast<uint8_t *>( buffer_.allocation.mapped );
+
+  THUMPY_LOG_CHANNEL( frameAllocatorChannel, Logger::DEBUG, maxFramesInFlight, " regions of ",
+                      frameSize_, " bytes, uniform alignment ", uniformAlignment_,
+                      ", storage alignment ", storageAlignment_ );
+}
+
+void FrameAllocator::destroy() { buffer_.reset(); }
+
+void FrameAllocator::begin_frame( uint32_t frame ) {
+  vulkanDevice_->timeline->wait( timelineValues_[frame] );
+  regions_[frame].reset();
+}
+
+void FrameAllocator::end_frame( uint32_t frame, uint64_t timelineValue ) {
+  timelineValues_[frame] = timelineValue;
+}
+
+FrameAllocation FrameAllocator::allocate_aligned( uint32_t frame, VkDeviceSize size,
+                                                  VkDeviceSize alignment ) {
+  VkDeviceSize offset;
+  if ( !regions_[frame].allocate( size, alignment, &offset ) ) {
+    Logger::log( "Frame allocator region is full!", Logger::CRITICAL );
+  }
+
+  offset += frame * frameSize_;
+  return FrameAllocation{ buffer_.buffer, offset, mapped_ + offset };
+}
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
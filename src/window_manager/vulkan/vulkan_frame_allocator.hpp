@@ -0,0 +1,160 @@
+/**
+ * @file vulkan_frame_allocator.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Per frame ring allocator for data the CPU writes every frame
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "vulkan_buffers.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_memory.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+// Bytes each frame in flight can allocate before the allocator runs out
+const VkDeviceSize FRAME_ALLOCATOR_SIZE = 4 * 1024 * 1024;
+
+/**
+ * @brief Bump allocator over a fixed number of bytes, only hands out offsets
+ *
+ */
+class LinearAllocator {
+ public:
+  explicit LinearAllocator( VkDeviceSize capacity = 0 ) : capacity_( capacity ) {}
+
+  /**
+   * @brief Take size bytes starting at a multiple of alignment
+   *
+   * @param size
+   * @param alignment power of two
+   * @param offset set on success
+   * @return false if there isn't room left
+   */
+  bool allocate( VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset );
+
+  void reset() { head_ = 0; }
+
+  VkDeviceSize used() const { return head_; }
+  VkDeviceSize capacity() const { return capacity_; }
+
+ private:
+  VkDeviceSize capacity_;
+  VkDeviceSize head_ = 0;
+};
+
+/**
+ * @brief Where an allocation landed, offset is what gets passed as a dynamic offset
+ *
+ */
+struct FrameAllocation {
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  void *mapped = nullptr;
+};
+
+/**
+ * @brief One persistently mapped, host coherent buffer split into a region per frame in flight.
+ * Camera, instance & culling data are bump allocated from the frame's region and bound through
+ * dynamic offsets, so there is one buffer & memory allocation instead of several per frame.
+ * A region is reset by begin_frame once the timeline passed the frame that last used it.
+ */
+class FrameAllocator {
+ public:
+  /**
+   * @brief Create & map the buffer
+   *
+   * @param vulkanDevice
+   * @param maxFramesInFlight
+   * @param frameSize bytes per frame region
+   * @param maxBindingRange largest range a dynamic descriptor binds at an allocation, the buffer
+   * is padded so it stays in bounds from the end of the last region
+   */
+  FrameAllocator( VulkanDevice *vulkanDevice, int maxFramesInFlight, VkDeviceSize frameSize,
+                  VkDeviceSize maxBindingRange );
+
+  /**
+   * @brief Queue the buffer for deletion once the GPU is done with it
+   *
+   */
+  void destroy();
+
+  /**
+   * @brief Reset the frame's region, waits for the timeline to pass its last submission
+   *
+   * @param frame frame in flight index
+   */
+  void begin_frame( uint32_t frame );
+
+  /**
+   * @brief Remember which submission reads the frame's region
+   *
+   * @param frame frame in flight index
+   * @param timelineValue from VulkanTimeline::submit
+   */
+  void end_frame( uint32_t frame, uint64_t timelineValue );
+
+  /**
+   * @brief Allocate from the frame's region, logs CRITICAL when it is full
+   *
+   * @param frame frame in flight index
+   * @param size
+   * @param alignment power of two, raised so the offset works for any dynamic binding
+   * @return FrameAllocation
+   */
+  FrameAllocation allocate( uint32_t frame, VkDeviceSize size, VkDeviceSize alignment ) {
+    return allocate_aligned( frame, size,
+                             std::max( { alignment, uniformAlignment_, storageAlignment_ } ) );
+  }
+
+  FrameAllocation allocate_uniform( uint32_t frame, VkDeviceSize size ) {
+    return allocate_aligned( frame, size, uniformAlignment_ );
+  }
+
+  FrameAllocation allocate_storage( uint32_t frame, VkDeviceSize size ) {
+    return allocate_aligned( frame, size, storageAlignment_ );
+  }
+
+  VkBuffer buffer() const { return buffer_.buffer; }
+
+  /**
+   * @brief Bytes allocated from the frame's region since it was last reset
+   *
+   * @param frame
+   * @return VkDeviceSize
+   */
+  VkDeviceSize used( uint32_t frame ) const { return regions_[frame].used(); }
+
+ private:
+  FrameAllocation allocate_aligned( uint32_t frame, VkDeviceSize size, VkDeviceSize alignment );
+
+  VulkanDevice *vulkanDevice_;
+  VkDeviceSize frameSize_;
+  VkDeviceSize uniformAlignment_;
+  VkDeviceSize storageAlignment_;
+
+  Buffer::Buffer buffer_;
+  uint8_t *mapped_;
+
+  std::vector<LinearAllocator> regions_;
+  std::vector<uint64_t> timelineValues_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -21,6 +21,7 @@
 
 #include <cstring>
 
+#include "channel.hpp"
 #include "logger.hpp"
 #include "logger_helper.hpp"
 #include "vulkan_helper.hpp"
@@ -39,6 +40,11 @@ namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+namespace {
+Logger::Channel &deviceChannel = Logger::get_channel( "Vulkan::Device" );
+Logger::Channel &assetChannel = Logger::get_channel( "Vulkan::Assets" );
+}  // namespace
+
 bool check_validation_layer_support() {
   uint32_t layerCount;
   vkEnumerateInstanceLayerProperties( &layerCount, nullptr );
@@ -78,22 +84,6 @@ std::vector<const char *> get_required_extensions() {
   return extensions;
 }
 
-uint32_t find_memory_type( VkPhysicalDevice physicalDevice, uint32_t typeFilter,
-                           VkMemoryPropertyFlags properties ) {
-  VkPhysicalDeviceMemoryProperties memProperties;
-  vkGetPhysicalDeviceMemoryProperties( physicalDevice, &memProperties );
-
-  for ( uint32_t i = 0; i < memProperties.memoryTypeCount; i++ ) {
-    if ( ( typeFilter & ( 1 << i ) ) &&
-         ( memProperties.memoryTypes[i].propertyFlags & properties ) == properties ) {
-      return i;
-    }
-  }
-
-  Logger::log( "failed to find suitable memory type!", Logger::CRITICAL );
-  return 0;
-}
-
 VkSampleCountFlagBits get_max_usable_sample_count( VkPhysicalDevice physicalDevice ) {
   VkPhysicalDeviceProperties physicalDeviceProperties;
   vkGetPhysicalDeviceProperties( physicalDevice, &physicalDeviceProperties );
@@ -101,31 +91,31 @@ VkSampleCountFlagBits get_max_usable_sample_count( VkPhysicalDevice physicalDevi
   VkSampleCountFlags counts = physicalDeviceProperties.limits.framebufferColorSampleCounts &
                               physicalDeviceProperties.limits.framebufferDepthSampleCounts;
   if ( counts & VK_SAMPLE_COUNT_64_BIT ) {
-    Logger::log( "Sample count: 64 bits", Logger::DEBUG );
+    THUMPY_LOG_CHANNEL( deviceChannel, Logger::DEBUG, "Sample count: 64 bits" );
     return VK_SAMPLE_COUNT_64_BIT;
   }
   if ( counts & VK_SAMPLE_COUNT_32_BIT ) {
-    Logger::log( "Sample count: 32 bits", Logger::DEBUG );
+    THUMPY_LOG_CHANNEL( deviceChannel, Logger::DEBUG, "Sample count: 32 bits" );
     return VK_SAMPLE_COUNT_32_BIT;
   }
   if ( counts & VK_SAMPLE_COUNT_16_BIT ) {
-    Logger::log( "Sample count: 16 bits", Logger::DEBUG );
+    THUMPY_LOG_CHANNEL( deviceChannel, Logger::DEBUG, "Sample count: 16 bits" );
     return VK_SAMPLE_COUNT_16_BIT;
   }
   if ( counts & VK_SAMPLE_COUNT_8_BIT ) {
-    Logger::log( "Sample count: 8 bits", Logger::INFO );
+    THUMPY_LOG_CHANNEL( deviceChannel, Logger::INFO, "Sample count: 8 bits" );
     return VK_SAMPLE_COUNT_8_BIT;
   }
   if ( counts & VK_SAMPLE_COUNT_4_BIT ) {
-    Logger::log( "Sample count: 4 bits", Logger::INFO );
+    THUMPY_LOG_CHANNEL( deviceChannel, Logger::INFO, "Sample count: 4 bits" );
     return VK_SAMPLE_COUNT_4_BIT;
   }
   if ( counts & VK_SAMPLE_COUNT_2_BIT ) {
-    Logger::log( "Sample count: 2 bits", Logger::INFO );
+    THUMPY_LOG_CHANNEL( deviceChannel, Logger::INFO, "Sample count: 2 bits" );
     return VK_SAMPLE_COUNT_2_BIT;
   }
 
-  Logger::log( "Sample count: 1 bits", Logger::INFO );
+  THUMPY_LOG_CHANNEL( deviceChannel, Logger::INFO, "Sample count: 1 bits" );
   return VK_SAMPLE_COUNT_1_BIT;
 }
 
@@ -163,8 +153,7 @@ Mesh *generate_square() {
  * @return std::vector<Vertex> sierpinski triangles
  */
 Mesh *generate_sierpinski_triangle( Mesh *startingMesh, uint32_t recursions ) {
-  Logger::log( "Generating sierpinski - recursions left: " + std::to_string( recursions ) + "",
-               Logger::INFO );
+  THUMPY_LOG( Logger::INFO, "Generating sierpinski - recursions left: ", recursions );
 
   /**
    * For each index
@@ -244,7 +233,8 @@ Mesh *generate_sierpinski_triangle( Mesh *startingMesh, uint32_t recursions ) {
 #pragma region Asset loading
 
 Texture *load_texture( std::string filePath ) {
-  Logger::log( "Loading texture: " + get_texture_path() + filePath, Logger::DEBUG );
+  THUMPY_LOG_CHANNEL( assetChannel, Logger::DEBUG, "Loading texture: ", get_texture_path(),
+                      filePath );
   Texture *texture = new Texture();
 
   texture->pixels =
@@ -253,7 +243,7 @@ Texture *load_texture( std::string filePath ) {
   texture->imageSize = texture->width * texture->height * 4;
 
   if ( !texture->pixels ) {
-    Logger::log( "Failed to load texture image!", Logger::ERROR_LOG );
+    THUMPY_LOG_CHANNEL( assetChannel, Logger::ERROR_LOG, "Failed to load texture image!" );
   }
 
   return texture;
@@ -264,7 +254,7 @@ void free_texture( Texture *texture ) { stbi_image_free( texture->pixels ); }
 Mesh *load_mesh( std::string filePath ) {
   std::string modelPath = get_model_path() + filePath;
 
-  Logger::log( "Loading model: " + modelPath, Logger::DEBUG );
+  THUMPY_LOG_CHANNEL( assetChannel, Logger::DEBUG, "Loading model: ", modelPath );
 
   tinyobj::attrib_t attrib;
   std::vector<tinyobj::shape_t> shapes;
@@ -272,7 +262,7 @@ Mesh *load_mesh( std::string filePath ) {
   std::string err;
 
   if ( !tinyobj::LoadObj( &attrib, &shapes, &materials, &err, modelPath.c_str() ) ) {
-    Logger::log( err, Logger::ERROR_LOG );
+    THUMPY_LOG_CHANNEL( assetChannel, Logger::ERROR_LOG, err );
   }
 
   Mesh *mesh = new Mesh();
@@ -305,33 +295,8 @@ Mesh *load_mesh( std::string filePath ) {
 
 #pragma region Paths
 
-std::string exePath_;
-std::string get_exe_path() {
-  if ( exePath_.empty() ) {
-#ifdef __unix__
-    char result[PATH_MAX];
-    ssize_t count = readlink( "/proc/self/exe", result, PATH_MAX );
-    exePath_ = std::string( result, ( count > 0 ) ? count : 0 );
-    exePath_ = exePath_.substr( 0, exePath_.find_last_of( "\\/" ) );
-    return exePath_;
-#elif _WIN32
-    wchar_t modulePath[MAX_PATH] = { 0 };
-    GetModuleFileNameW( NULL, modulePath, MAX_PATH );
-
-    std::wstring ws = std::wstring( modulePath );
-    size_t len = wcstombs( nullptr, ws.c_str(), 0 ) + 1;
-    char *buffer = new char[len];
-
-    wcstombs( buffer, ws.c_str(), len );
-    exePath_ = std::string( buffer );
-    exePath_ = exePath_.substr( 0, exePath_.find_last_of( "\\/" ) );
-    return exePath_;
-#endif
-    Logger::log( "Error determining os for filepath.", Logger::CRITICAL );
-    return "";
-  }
-  return exePath_;
-}
+// Shared with the logger so log files land next to the executable too
+std::string get_exe_path() { return Logger::get_executable_directory(); }
 
 std::string assetsPath_;
 std::string get_assets_path() {
@@ -25,6 +25,8 @@
 #include <vector>
 
 #include "logger.hpp"
+#include "vulkan_deletion_queue.hpp"
+#include "vulkan_memory.hpp"
 
 namespace Thumpy {
 namespace Core {
@@ -42,6 +44,8 @@ const std::vector<const char *> validationLayers = { "VK_LAYER_KHRONOS_validatio
 struct QueueFamilyIndices {
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  // A family that can transfer but not draw, usually the GPU's copy engine
+  std::optional<uint32_t> transferFamily;
 
   bool is_complete() { return graphicsFamily.has_value() && presentFamily.has_value(); }
 };
@@ -52,10 +56,39 @@ struct SwapChainSupportDetails {
   std::vector<VkPresentModeKHR> presentModes;
 };
 
+class VulkanDevice;
+
+/**
+ * @brief Owns a set layout & the pool its sets come from. Move only, the handles go to the
+ * device's deletion queue when it's reset or destroyed
+ */
 struct Descriptors {
-  VkDescriptorSetLayout setLayout;
-  VkDescriptorPool pool;
+  Descriptors() = default;
+  Descriptors( Descriptors &&other ) noexcept;
+  Descriptors &operator=( Descriptors &&other ) noexcept;
+  Descriptors( const Descriptors & ) = delete;
+  Descriptors &operator=( const Descriptors & ) = delete;
+  ~Descriptors() { reset(); }
+
+  /**
+   * @brief Queue the pool for deletion, its sets go with it
+   *
+   * @param timelineValue last submission that may use the sets
+   */
+  void reset_pool( uint64_t timelineValue = LAST_SUBMISSION );
+
+  /**
+   * @brief Queue the pool & set layout for deletion
+   *
+   * @param timelineValue last submission that may use them
+   */
+  void reset( uint64_t timelineValue = LAST_SUBMISSION );
+
+  VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+  VkDescriptorPool pool = VK_NULL_HANDLE;
   std::vector<VkDescriptorSet> sets;
+  // Set on creation, owns the deletion queue the handles go to
+  VulkanDevice *vulkanDevice = nullptr;
 };
 
 struct Vertex {
@@ -106,41 +139,66 @@ struct Vertex {
   }
 };
 
-struct UniformBufferObject {
-  glm::mat4 model;
+// Size of the material table in CameraData, matches instanced.vert
+const uint32_t MAX_DRAW_MATERIALS = 64;
+
+/**
+ * @brief Camera uniform of instanced.vert, written once per frame. Per draw data goes in push
+ * constants instead, the pushed material index picks a color from materials
+ */
+struct CameraData {
   glm::mat4 view;
   glm::mat4 proj;
+  glm::vec4 materials[MAX_DRAW_MATERIALS];
 };
 
+/**
+ * @brief Owns an image, its memory & view. Move only, the handles go to the device's deletion
+ * queue when it's reset or destroyed, so frames in flight can keep using them
+ */
 struct VulkanImage {
-  VkImage image;
-  VkDeviceMemory imageMemory;
-  VkImageView imageView;
-
-  void destroy( VkDevice device ) {
-    vkDestroyImageView( device, imageView, nullptr );
-    vkDestroyImage( device, image, nullptr );
-    vkFreeMemory( device, imageMemory, nullptr );
-  }
+  VulkanImage() = default;
+  VulkanImage( VulkanImage &&other ) noexcept;
+  VulkanImage &operator=( VulkanImage &&other ) noexcept;
+  VulkanImage( const VulkanImage & ) = delete;
+  VulkanImage &operator=( const VulkanImage & ) = delete;
+  ~VulkanImage() { reset(); }
+
+  /**
+   * @brief Queue the view, image & memory for deletion, leaves this empty
+   *
+   * @param timelineValue last submission that may use them
+   */
+  void reset( uint64_t timelineValue = LAST_SUBMISSION );
+
+  VkImage image = VK_NULL_HANDLE;
+  MemoryAllocation allocation;
+  VkImageView imageView = VK_NULL_HANDLE;
+  // Set on creation, owns the deletion queue the handles go to
+  VulkanDevice *vulkanDevice = nullptr;
 };
 
 struct VulkanTextureImage : VulkanImage {
-  VkSampler sampler;
-  uint32_t mipLevels;
-
-  void destroy( VkDevice device ) {
-    vkDestroySampler( device, sampler, nullptr );
-    VulkanImage::destroy( device );
-  }
+  VulkanTextureImage() = default;
+  VulkanTextureImage( VulkanTextureImage &&other ) noexcept;
+  VulkanTextureImage &operator=( VulkanTextureImage &&other ) noexcept;
+  ~VulkanTextureImage() { reset(); }
+
+  /**
+   * @brief Queue the sampler for deletion along with the image
+   *
+   * @param timelineValue last submission that may use them
+   */
+  void reset( uint64_t timelineValue = LAST_SUBMISSION );
+
+  VkSampler sampler = VK_NULL_HANDLE;
+  uint32_t mipLevels = 1;
 };
 
 bool check_validation_layer_support();
 
 std::vector<const char *> get_required_extensions();
 
-uint32_t find_memory_type( VkPhysicalDevice physicalDevice, uint32_t typeFilter,
-                           VkMemoryPropertyFlags properties );
-
 VkSampleCountFlagBits get_max_usable_sample_count( VkPhysicalDevice physicalDevice );
 
 #pragma region Asset loading
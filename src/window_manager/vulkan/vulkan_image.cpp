@@ -19,23 +19,89 @@
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
+#include "channel.hpp"
 #include "logger.hpp"
-#include "vulkan_buffers.hpp"
+#include "vulkan_deletion_queue.hpp"
 #include "vulkan_initializers.hpp"
+#include "vulkan_memory.hpp"
 #include "vulkan_swap_chain.hpp"
+#include "vulkan_upload.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+VulkanImage::VulkanImage( VulkanImage &&other ) noexcept
+    : image( std::exchange( other.image, VK_NULL_HANDLE ) ),
+      allocation( std::exchange( other.allocation, MemoryAllocation() ) ),
+      imageView( std::exchange( other.imageView, VK_NULL_HANDLE ) ),
+      vulkanDevice( other.vulkanDevice ) {}
+
+VulkanImage &VulkanImage::operator=( VulkanImage &&other ) noexcept {
+  if ( this != &other ) {
+    reset();
+    image = std::exchange( other.image, VK_NULL_HANDLE );
+    allocation = std::exchange( other.allocation, MemoryAllocation() );
+    imageView = std::exchange( other.imageView, VK_NULL_HANDLE );
+    vulkanDevice = other.vulkanDevice;
+  }
+  return *this;
+}
+
+void VulkanImage::reset( uint64_t timelineValue ) {
+  if ( image == VK_NULL_HANDLE && imageView == VK_NULL_HANDLE ) {
+    return;
+  }
+  // The view is queued first, it can't outlive its image
+  if ( imageView != VK_NULL_HANDLE ) {
+    vulkanDevice->deletionQueue->push( imageView, timelineValue );
+    imageView = VK_NULL_HANDLE;
+  }
+  if ( image != VK_NULL_HANDLE ) {
+    vulkanDevice->deletionQueue->push( image, allocation, timelineValue );
+    image = VK_NULL_HANDLE;
+  }
+}
+
+VulkanTextureImage::VulkanTextureImage( VulkanTextureImage &&other ) noexcept
+    : VulkanImage( std::move( other ) ),
+      sampler( std::exchange( other.sampler, VK_NULL_HANDLE ) ),
+      mipLevels( other.mipLevels ) {}
+
+VulkanTextureImage &VulkanTextureImage::operator=( VulkanTextureImage &&other ) noexcept {
+  if ( this != &other ) {
+    reset();
+    VulkanImage::operator=( std::move( other ) );
+    sampler = std::exchange( other.sampler, VK_NULL_HANDLE );
+    mipLevels = other.mipLevels;
+  }
+  return *this;
+}
+
+void VulkanTextureImage::reset( uint64_t timelineValue ) {
+  if ( sampler != VK_NULL_HANDLE ) {
+    vulkanDevice->deletionQueue->push( sampler, timelineValue );
+    sampler = VK_NULL_HANDLE;
+  }
+  VulkanImage::reset( timelineValue );
+}
+
 namespace Image {
 
+namespace {
+Logger::Channel &imageChannel = Logger::get_channel( "Vulkan::Image" );
+}  // namespace
+
 void create_image( uint32_t width, uint32_t height, uint32_t mipLevels,
                    VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling,
                    VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
                    VulkanImage *textureImage, VulkanDevice *vulkanDevice ) {
+  // Replacing an image, the old one goes once the GPU is done with it
+  textureImage->reset();
+
   VkImageCreateInfo imageInfo =
       Initializer::image_info( width, height, format, tiling, usage, mipLevels, numSamples );
 
@@ -44,43 +110,19 @@ void create_image( uint32_t width, uint32_t height, uint32_t mipLevels,
     Logger::log( "Failed to create image!", Logger::CRITICAL );
   }
 
-  VkMemoryRequirements memRequirements;
-  vkGetImageMemoryRequirements( vulkanDevice->device, textureImage->image, &memRequirements );
-
-  VkMemoryAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex =
-      find_memory_type( vulkanDevice->physicalDevice, memRequirements.memoryTypeBits, properties );
-
-  if ( vkAllocateMemory( vulkanDevice->device, &allocInfo, nullptr, &textureImage->imageMemory ) !=
-       VK_SUCCESS ) {
-    Logger::log( "failed to allocate image memory!", Logger::CRITICAL );
-  }
-
-  vkBindImageMemory( vulkanDevice->device, textureImage->image, textureImage->imageMemory, 0 );
+  textureImage->allocation =
+      vulkanDevice->allocator->allocate_image( textureImage->image, properties, tiling );
+  textureImage->vulkanDevice = vulkanDevice;
 }
 
 void create_texture_image( VulkanDevice *vulkanDevice, VulkanTextureImage *textureImage,
-                           VkCommandPool commandPool, std::string filePath ) {
+                           UploadQueue *uploadQueue, std::string filePath ) {
   Texture *texture = load_texture( filePath );
   textureImage->mipLevels = static_cast<uint32_t>( std::floor(
                                 std::log2( std::max( texture->height, texture->width ) ) ) ) +
                             1;
-
-  VkBuffer stagingBuffer;
-  VkDeviceMemory stagingBufferMemory;
-
-  Buffer::create_buffer( texture->imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                         stagingBuffer, stagingBufferMemory, vulkanDevice );
-
-  void *data;
-  vkMapMemory( vulkanDevice->device, stagingBufferMemory, 0, texture->imageSize, 0, &data );
-  memcpy( data, texture->pixels, static_cast<size_t>( texture->imageSize ) );
-  vkUnmapMemory( vulkanDevice->device, stagingBufferMemory );
-
-  free_texture( texture );
+  THUMPY_LOG_CHANNEL( imageChannel, Logger::DEBUG, "Creating texture image ", texture->width, "x",
+                      texture->height, ", ", textureImage->mipLevels, " mip levels" );
 
   create_image( texture->width, texture->height, textureImage->mipLevels, VK_SAMPLE_COUNT_1_BIT,
                 VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
@@ -88,32 +130,18 @@ void create_texture_image( VulkanDevice *vulkanDevice, VulkanTextureImage *textu
                     VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, vulkanDevice );
 
-  transition_image_layout( textureImage->image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, vulkanDevice, commandPool,
-                           textureImage->mipLevels );
-
-  copy_buffer_to_image( stagingBuffer, textureImage->image, static_cast<uint32_t>( texture->width ),
-                        static_cast<uint32_t>( texture->height ), vulkanDevice, commandPool );
+  // Pixels are copied into staging right away, the mip chain is generated on the GPU
+  uploadQueue->upload_image( textureImage->image, VK_FORMAT_R8G8B8A8_SRGB,
+                             { static_cast<uint32_t>( texture->width ),
+                               static_cast<uint32_t>( texture->height ) },
+                             textureImage->mipLevels, texture->pixels, texture->imageSize );
 
-  // transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-  //  transition_image_layout( textureImage->image, VK_FORMAT_R8G8B8A8_SRGB,
-  //                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-  //                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, vulkanDevice, commandPool,
-  //                           1 );
-
-  vkDestroyBuffer( vulkanDevice->device, stagingBuffer, nullptr );
-  vkFreeMemory( vulkanDevice->device, stagingBufferMemory, nullptr );
-
-  generate_mipmaps( textureImage->image, VK_FORMAT_R8G8B8A8_SRGB, texture->width, texture->height,
-                    textureImage->mipLevels, vulkanDevice, commandPool );
+  free_texture( texture );
 }
 
-void transition_image_layout( VkImage image, VkFormat format, VkImageLayout oldLayout,
-                              VkImageLayout newLayout, VulkanDevice *vulkanDevice,
-                              VkCommandPool commandPool, uint32_t mipLevels ) {
-  VkCommandBuffer commandBuffer =
-      Buffer::begin_single_time_commands( vulkanDevice->device, commandPool );
-
+void transition_image_layout( VkCommandBuffer commandBuffer, VkImage image,
+                              VkImageLayout oldLayout, VkImageLayout newLayout,
+                              uint32_t mipLevels ) {
   VkImageMemoryBarrier barrier =
       Initializer::image_memory_barrier( image, oldLayout, newLayout, mipLevels );
 
@@ -140,17 +168,13 @@ void transition_image_layout( VkImage image, VkFormat format, VkImageLayout oldL
 
   vkCmdPipelineBarrier( commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1,
                         &barrier );
-
-  Buffer::end_single_time_commands( vulkanDevice, commandBuffer, commandPool );
 }
 
-void copy_buffer_to_image( VkBuffer buffer, VkImage image, uint32_t width, uint32_t height,
-                           VulkanDevice *vulkanDevice, VkCommandPool commandPool ) {
-  VkCommandBuffer commandBuffer =
-      Buffer::begin_single_time_commands( vulkanDevice->device, commandPool );
-
+void copy_buffer_to_image( VkCommandBuffer commandBuffer, VkBuffer buffer,
+                           VkDeviceSize bufferOffset, VkImage image, uint32_t width,
+                           uint32_t height ) {
   VkBufferImageCopy region{};
-  region.bufferOffset = 0;
+  region.bufferOffset = bufferOffset;
   region.bufferRowLength = 0;
   region.bufferImageHeight = 0;
 
@@ -164,8 +188,6 @@ void copy_buffer_to_image( VkBuffer buffer, VkImage image, uint32_t width, uint3
 
   vkCmdCopyBufferToImage( commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
                           &region );
-
-  Buffer::end_single_time_commands( vulkanDevice, commandBuffer, commandPool );
 }
 
 VkImageView create_image_view( VkDevice device, VkImage image, VkFormat format,
@@ -229,17 +251,46 @@ void create_texture_sampler( VulkanDevice *vulkanDevice, VulkanTextureImage *tex
 }
 
 void create_depth_resources( VulkanImage *depthBuffer, VulkanDevice *vulkanDevice,
-                             VkExtent2D swapChainExtent ) {
+                             VkExtent2D swapChainExtent, bool stored ) {
   VkFormat depthFormat = find_depth_format( vulkanDevice->physicalDevice );
 
+  // Transient attachments can't be sampled, so only a depth buffer nothing reads stays in tile
+  // memory
+  VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  if ( stored ) {
+    usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+  } else {
+    usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    properties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  }
+
   create_image( swapChainExtent.width, swapChainExtent.height, 1, vulkanDevice->msaaSamples,
-                depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthBuffer, vulkanDevice );
+                depthFormat, VK_IMAGE_TILING_OPTIMAL, usage, properties, depthBuffer,
+                vulkanDevice );
 
   depthBuffer->imageView = create_image_view( vulkanDevice->device, depthBuffer->image, depthFormat,
                                               VK_IMAGE_ASPECT_DEPTH_BIT, 1 );
 }
 
+bool depth_sampling_supported( VulkanDevice *vulkanDevice ) {
+  VkFormatProperties formatProperties;
+  vkGetPhysicalDeviceFormatProperties( vulkanDevice->physicalDevice,
+                                       find_depth_format( vulkanDevice->physicalDevice ),
+                                       &formatProperties );
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( vulkanDevice->physicalDevice, &properties );
+
+  return ( formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT ) &&
+         ( properties.limits.sampledImageDepthSampleCounts & vulkanDevice->msaaSamples );
+}
+
+bool depth_pyramid_supported( VulkanDevice *vulkanDevice ) {
+  // The seed shader reads every sample of the multisampled depth buffer
+  return vulkanDevice->msaaSamples != VK_SAMPLE_COUNT_1_BIT &&
+         depth_sampling_supported( vulkanDevice );
+}
+
 VkFormat find_supported_format( const std::vector<VkFormat> &candidates, VkImageTiling tiling,
                                 VkFormatFeatureFlags features, VkPhysicalDevice physicalDevice ) {
   for ( VkFormat format : candidates ) {
@@ -269,8 +320,9 @@ bool has_stencil_component( VkFormat format ) {
   return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
-void generate_mipmaps( VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight,
-                       uint32_t mipLevels, VulkanDevice *vulkanDevice, VkCommandPool commandPool ) {
+void generate_mipmaps( VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat,
+                       int32_t texWidth, int32_t texHeight, uint32_t mipLevels,
+                       VulkanDevice *vulkanDevice ) {
   // Check if image format supports linear blitting
   VkFormatProperties formatProperties;
   vkGetPhysicalDeviceFormatProperties( vulkanDevice->physicalDevice, imageFormat,
@@ -279,9 +331,8 @@ void generate_mipmaps( VkImage image, VkFormat imageFormat, int32_t texWidth, in
           VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT ) ) {
     Logger::log( "Texture image format does not support linear blitting!", Logger::CRITICAL );
   }
-
-  VkCommandBuffer commandBuffer =
-      Buffer::begin_single_time_commands( vulkanDevice->device, commandPool );
+  THUMPY_LOG_CHANNEL( imageChannel, Logger::DEBUG, "Generating ", mipLevels, " mip levels for ",
+                      texWidth, "x", texHeight, " image" );
 
   VkImageMemoryBarrier barrier{};
   barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -345,8 +396,6 @@ void generate_mipmaps( VkImage image, VkFormat imageFormat, int32_t texWidth, in
   vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
                         &barrier );
-
-  Buffer::end_single_time_commands( vulkanDevice, commandBuffer, commandPool );
 }
 
 void create_color_resources( VulkanImage *msaaColorBuffer, VulkanDevice *vulkanDevice,
@@ -356,7 +405,8 @@ void create_color_resources( VulkanImage *msaaColorBuffer, VulkanDevice *vulkanD
   create_image( swapChain->extent.width, swapChain->extent.height, 1, vulkanDevice->msaaSamples,
                 colorFormat, VK_IMAGE_TILING_OPTIMAL,
                 VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, msaaColorBuffer, vulkanDevice );
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                msaaColorBuffer, vulkanDevice );
   msaaColorBuffer->imageView = create_image_view( vulkanDevice->device, msaaColorBuffer->image,
                                                   colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1 );
 }
@@ -27,6 +27,9 @@ namespace Thumpy {
 namespace Core {
 namespace Windows {
 namespace Vulkan {
+
+class UploadQueue;
+
 namespace Image {
 
 void create_image( uint32_t width, uint32_t height, uint32_t mipLevels,
@@ -34,15 +37,20 @@ void create_image( uint32_t width, uint32_t height, uint32_t mipLevels,
                    VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
                    VulkanImage *textureImage, VulkanDevice *vulkanDevice );
 
+/**
+ * @brief Load a texture & queue its upload, it's sampleable once the upload queue's next flush
+ * completes
+ */
 void create_texture_image( VulkanDevice *vulkanDevice, VulkanTextureImage *textureImage,
-                           VkCommandPool commandPool, std::string filePath );
+                           UploadQueue *uploadQueue, std::string filePath );
 
-void transition_image_layout( VkImage image, VkFormat format, VkImageLayout oldLayout,
-                              VkImageLayout newLayout, VulkanDevice *vulkanDevice,
-                              VkCommandPool commandPool, uint32_t mipLevels );
+void transition_image_layout( VkCommandBuffer commandBuffer, VkImage image,
+                              VkImageLayout oldLayout, VkImageLayout newLayout,
+                              uint32_t mipLevels );
 
-void copy_buffer_to_image( VkBuffer buffer, VkImage image, uint32_t width, uint32_t height,
-                           VulkanDevice *vulkanDevice, VkCommandPool commandPool );
+void copy_buffer_to_image( VkCommandBuffer commandBuffer, VkBuffer buffer,
+                           VkDeviceSize bufferOffset, VkImage image, uint32_t width,
+                           uint32_t height );
 
 VkImageView create_image_view( VkDevice device, VkImage image, VkFormat format,
                                VkImageAspectFlags aspectFlags, uint32_t mipLevels );
@@ -51,8 +59,32 @@ void create_texture_image_view( VkDevice device, VulkanTextureImage *textureImag
 
 void create_texture_sampler( VulkanDevice *vulkanDevice, VulkanTextureImage *textureImage );
 
+/**
+ * @brief Create the depth buffer, sampleable when stored so the culling pass can build its
+ * depth pyramid from it. Otherwise it's a transient attachment in lazily allocated memory
+ * @param depthBuffer
+ * @param vulkanDevice
+ * @param swapChainExtent
+ * @param stored the swap chain's depthStored
+ */
 void create_depth_resources( VulkanImage *depthBuffer, VulkanDevice *vulkanDevice,
-                             VkExtent2D swapChainExtent );
+                             VkExtent2D swapChainExtent, bool stored );
+
+/**
+ * @brief Check the depth format can be sampled at the device's msaa sample count
+ *
+ * @param vulkanDevice
+ * @return bool
+ */
+bool depth_sampling_supported( VulkanDevice *vulkanDevice );
+
+/**
+ * @brief Check if the culling pass could seed its depth pyramid from the depth buffer, needs
+ * msaa & depth_sampling_supported. Depth is only stored if it then loads the pyramid pipelines
+ * @param vulkanDevice
+ * @return bool
+ */
+bool depth_pyramid_supported( VulkanDevice *vulkanDevice );
 
 VkFormat find_supported_format( const std::vector<VkFormat> &candidates, VkImageTiling tiling,
                                 VkFormatFeatureFlags features, VkPhysicalDevice physicalDevice );
@@ -61,9 +93,18 @@ VkFormat find_depth_format( VkPhysicalDevice physicalDevice );
 
 bool has_stencil_component( VkFormat format );
 
-void generate_mipmaps( VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight,
-                       uint32_t mipLevels, VulkanDevice *vulkanDevice, VkCommandPool commandPool );
+/**
+ * @brief Record blits filling mips 1+ from mip 0, every mip has to start in
+ * TRANSFER_DST_OPTIMAL & ends in SHADER_READ_ONLY_OPTIMAL. Needs a graphics queue
+ */
+void generate_mipmaps( VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat,
+                       int32_t texWidth, int32_t texHeight, uint32_t mipLevels,
+                       VulkanDevice *vulkanDevice );
 
+/**
+ * @brief Create the msaa color target, a transient attachment in lazily allocated memory since
+ * only its resolve is kept
+ */
 void create_color_resources( VulkanImage *msaaColorBuffer, VulkanDevice *vulkanDevice,
                              VulkanSwapChain *swapChain );
 
@@ -32,7 +32,8 @@ inline VkApplicationInfo application_info() {
   appInfo.applicationVersion = VK_MAKE_VERSION( 1, 0, 0 );
   appInfo.pEngineName = "Thumpy Engine";
   appInfo.engineVersion = VK_MAKE_VERSION( 1, 0, 0 );
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  // 1.2 for timeline semaphores, older devices fall back to fences
+  appInfo.apiVersion = VK_API_VERSION_1_2;
   return appInfo;
 }
 
@@ -203,6 +204,26 @@ inline VkCommandBufferBeginInfo command_buffer_begin_info() {
   return beginInfo;
 }
 
+inline VkCommandBufferInheritanceInfo command_buffer_inheritance_info( VkRenderPass renderPass,
+                                                                       VkFramebuffer frameBuffer ) {
+  VkCommandBufferInheritanceInfo inheritanceInfo{};
+  inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  inheritanceInfo.renderPass = renderPass;
+  inheritanceInfo.subpass = 0;
+  inheritanceInfo.framebuffer = frameBuffer;
+  return inheritanceInfo;
+}
+
+inline VkCommandBufferBeginInfo secondary_command_buffer_begin_info(
+    const VkCommandBufferInheritanceInfo *inheritanceInfo ) {
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                    VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  beginInfo.pInheritanceInfo = inheritanceInfo;
+  return beginInfo;
+}
+
 inline VkRenderPassBeginInfo render_pass_info( VkRenderPass renderPass, VkFramebuffer frameBuffer,
                                                VkExtent2D extent ) {
   VkRenderPassBeginInfo renderPassInfo{};
@@ -214,6 +235,45 @@ inline VkRenderPassBeginInfo render_pass_info( VkRenderPass renderPass, VkFrameb
   return renderPassInfo;
 }
 
+inline VkCommandBufferInheritanceRenderingInfoKHR command_buffer_inheritance_rendering_info(
+    const VkFormat *colorFormat, VkFormat depthFormat, VkSampleCountFlagBits samples ) {
+  VkCommandBufferInheritanceRenderingInfoKHR renderingInfo{};
+  renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+  renderingInfo.colorAttachmentCount = 1;
+  renderingInfo.pColorAttachmentFormats = colorFormat;
+  renderingInfo.depthAttachmentFormat = depthFormat;
+  renderingInfo.rasterizationSamples = samples;
+  return renderingInfo;
+}
+
+inline VkRenderingAttachmentInfoKHR rendering_attachment_info( VkImageView imageView,
+                                                               VkImageLayout layout,
+                                                               VkClearValue clearValue ) {
+  VkRenderingAttachmentInfoKHR attachmentInfo{};
+  attachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+  attachmentInfo.imageView = imageView;
+  attachmentInfo.imageLayout = layout;
+  attachmentInfo.resolveMode = VK_RESOLVE_MODE_NONE;
+  attachmentInfo.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  attachmentInfo.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  attachmentInfo.clearValue = clearValue;
+  return attachmentInfo;
+}
+
+inline VkRenderingInfoKHR rendering_info( VkExtent2D extent,
+                                          const VkRenderingAttachmentInfoKHR *colorAttachment,
+                                          const VkRenderingAttachmentInfoKHR *depthAttachment ) {
+  VkRenderingInfoKHR renderingInfo{};
+  renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+  renderingInfo.renderArea.offset = { 0, 0 };
+  renderingInfo.renderArea.extent = extent;
+  renderingInfo.layerCount = 1;
+  renderingInfo.colorAttachmentCount = 1;
+  renderingInfo.pColorAttachments = colorAttachment;
+  renderingInfo.pDepthAttachment = depthAttachment;
+  return renderingInfo;
+}
+
 inline VkSemaphoreCreateInfo semaphore_info() {
   VkSemaphoreCreateInfo semaphoreInfo{};
   semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
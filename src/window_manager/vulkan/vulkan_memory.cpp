@@ -0,0 +1,534 @@
+/**
+ * @file vulkan_memory.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_memory cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_memory.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "channel.hpp"
+#include "logger.hpp"
+#include "vulkan_device.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+Logger::Channel &memoryChannel = Logger::get_channel( "Vulkan::Memory" );
+
+uint32_t most_significant_bit( VkDeviceSize value ) {
+  return 63 - static_cast<uint32_t>( std::countl_zero( static_cast<uint64_t>( value ) ) );
+}
+
+// Sizes below TLSF_SL_COUNT get a list each, above that every power of two is split in
+// TLSF_SL_COUNT lists
+void tlsf_mapping( VkDeviceSize size, uint32_t *fl, uint32_t *sl ) {
+  if ( size < TLSF_SL_COUNT ) {
+    *fl = 0;
+    *sl = static_cast<uint32_t>( size );
+    return;
+  }
+  uint32_t msb = most_significant_bit( size );
+  *fl = msb - TLSF_SL_BITS + 1;
+  *sl = static_cast<uint32_t>( size >> ( msb - TLSF_SL_BITS ) ) - TLSF_SL_COUNT;
+}
+
+VkDeviceSize align_up( VkDeviceSize value, VkDeviceSize alignment ) {
+  return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+double to_megabytes( VkDeviceSize bytes ) {
+  return static_cast<double>( bytes ) / ( 1024.0 * 1024.0 );
+}
+
+}  // namespace
+
+#pragma region TLSF
+
+TlsfAllocator::TlsfAllocator( VkDeviceSize capacity ) : capacity_( capacity ) {
+  freeLists_.fill( NO_BLOCK );
+  if ( capacity_ == 0 ) {
+    return;
+  }
+
+  uint32_t block = new_block();
+  blocks_[block] = Block{ 0, capacity_, NO_BLOCK, NO_BLOCK, NO_BLOCK, NO_BLOCK, true };
+  insert_free( block );
+}
+
+bool TlsfAllocator::allocate( VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset,
+                              uint32_t *handle ) {
+  size = std::max<VkDeviceSize>( size, 1 );
+  alignment = std::max<VkDeviceSize>( alignment, 1 );
+
+  // Any free block this large fits the allocation wherever it starts
+  uint32_t block = find_free( size + alignment - 1 );
+  if ( block == NO_BLOCK ) {
+    return false;
+  }
+  remove_free( block );
+
+  // Padding in front of the aligned start goes back as its own free block
+  VkDeviceSize aligned = align_up( blocks_[block].offset, alignment );
+  VkDeviceSize padding = aligned - blocks_[block].offset;
+  if ( padding > 0 ) {
+    uint32_t front = new_block();
+    Block &current = blocks_[block];
+    blocks_[front] = Block{ current.offset, padding, current.prevPhysical, block,
+                            NO_BLOCK,       NO_BLOCK, true };
+    if ( current.prevPhysical != NO_BLOCK ) {
+      blocks_[current.prevPhysical].nextPhysical = front;
+    }
+    current.prevPhysical = front;
+    current.offset = aligned;
+    current.size -= padding;
+    insert_free( front );
+  }
+
+  // So does whatever is left after it
+  if ( blocks_[block].size > size ) {
+    uint32_t back = new_block();
+    Block &current = blocks_[block];
+    blocks_[back] = Block{ current.offset + size, current.size - size, block,
+                           current.nextPhysical,  NO_BLOCK,            NO_BLOCK,
+                           true };
+    if ( current.nextPhysical != NO_BLOCK ) {
+      blocks_[current.nextPhysical].prevPhysical = back;
+    }
+    current.nextPhysical = back;
+    current.size = size;
+    insert_free( back );
+  }
+
+  blocks_[block].free = false;
+  used_ += size;
+  allocationCount_++;
+
+  *offset = blocks_[block].offset;
+  *handle = block;
+  return true;
+}
+
+void TlsfAllocator::free( uint32_t handle ) {
+  uint32_t block = handle;
+  blocks_[block].free = true;
+  used_ -= blocks_[block].size;
+  allocationCount_--;
+
+  // Merge with free neighbours, there are never two free blocks next to each other
+  uint32_t prev = blocks_[block].prevPhysical;
+  if ( prev != NO_BLOCK && blocks_[prev].free ) {
+    remove_free( prev );
+    blocks_[prev].size += blocks_[block].size;
+    blocks_[prev].nextPhysical = blocks_[block].nextPhysical;
+    if ( blocks_[block].nextPhysical != NO_BLOCK ) {
+      blocks_[blocks_[block].nextPhysical].prevPhysical = prev;
+    }
+    unusedBlocks_.push_back( block );
+    block = prev;
+  }
+
+  uint32_t next = blocks_[block].nextPhysical;
+  if ( next != NO_BLOCK && blocks_[next].free ) {
+    remove_free( next );
+    blocks_[block].size += blocks_[next].size;
+    blocks_[block].nextPhysical = blocks_[next].nextPhysical;
+    if ( blocks_[next].nextPhysical != NO_BLOCK ) {
+      blocks_[blocks_[next].nextPhysical].prevPhysical = block;
+    }
+    unusedBlocks_.push_back( next );
+  }
+
+  insert_free( block );
+}
+
+uint32_t TlsfAllocator::new_block() {
+  if ( !unusedBlocks_.empty() ) {
+    uint32_t block = unusedBlocks_.back();
+    unusedBlocks_.pop_back();
+    return block;
+  }
+  blocks_.emplace_back();
+  return static_cast<uint32_t>( blocks_.size() - 1 );
+}
+
+void TlsfAllocator::insert_free( uint32_t block ) {
+  uint32_t fl, sl;
+  tlsf_mapping( blocks_[block].size, &fl, &sl );
+  uint32_t &head = freeLists_[fl * TLSF_SL_COUNT + sl];
+
+  blocks_[block].prevFree = NO_BLOCK;
+  blocks_[block].nextFree = head;
+  if ( head != NO_BLOCK ) {
+    blocks_[head].prevFree = block;
+  }
+  head = block;
+
+  flBitmap_ |= uint64_t( 1 ) << fl;
+  slBitmaps_[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::remove_free( uint32_t block ) {
+  uint32_t fl, sl;
+  tlsf_mapping( blocks_[block].size, &fl, &sl );
+  uint32_t &head = freeLists_[fl * TLSF_SL_COUNT + sl];
+
+  Block &current = blocks_[block];
+  if ( current.prevFree != NO_BLOCK ) {
+    blocks_[current.prevFree].nextFree = current.nextFree;
+  } else {
+    head = current.nextFree;
+  }
+  if ( current.nextFree != NO_BLOCK ) {
+    blocks_[current.nextFree].prevFree = current.prevFree;
+  }
+
+  if ( head == NO_BLOCK ) {
+    slBitmaps_[fl] &= ~( 1u << sl );
+    if ( slBitmaps_[fl] == 0 ) {
+      flBitmap_ &= ~( uint64_t( 1 ) << fl );
+    }
+  }
+}
+
+uint32_t TlsfAllocator::find_free( VkDeviceSize size ) {
+  // Round up to the next list so every block in the list found is large enough
+  if ( size >= TLSF_SL_COUNT ) {
+    size += ( VkDeviceSize( 1 ) << ( most_significant_bit( size ) - TLSF_SL_BITS ) ) - 1;
+  }
+  uint32_t fl, sl;
+  tlsf_mapping( size, &fl, &sl );
+  if ( fl >= TLSF_FL_COUNT ) {
+    return NO_BLOCK;
+  }
+
+  uint32_t slMap = slBitmaps_[fl] & ( ~0u << sl );
+  if ( slMap == 0 ) {
+    uint64_t flMap = fl + 1 < TLSF_FL_COUNT ? flBitmap_ & ( ~uint64_t( 0 ) << ( fl + 1 ) ) : 0;
+    if ( flMap == 0 ) {
+      return NO_BLOCK;
+    }
+    fl = static_cast<uint32_t>( std::countr_zero( flMap ) );
+    slMap = slBitmaps_[fl];
+  }
+  sl = static_cast<uint32_t>( std::countr_zero( slMap ) );
+  return freeLists_[fl * TLSF_SL_COUNT + sl];
+}
+
+#pragma endregion TLSF
+
+#pragma region Device memory
+
+MemoryAllocator::MemoryAllocator( VulkanDevice *vulkanDevice ) : vulkanDevice_( vulkanDevice ) {
+  vkGetPhysicalDeviceMemoryProperties( vulkanDevice_->physicalDevice, &memoryProperties_ );
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( vulkanDevice_->physicalDevice, &properties );
+  bufferImageGranularity_ = properties.limits.bufferImageGranularity;
+  dedicatedAllocation_ = properties.apiVersion >= VK_API_VERSION_1_1;
+
+  for ( uint32_t i = 0; i < memoryProperties_.memoryTypeCount; i++ ) {
+    uint32_t heap = memoryProperties_.memoryTypes[i].heapIndex;
+    VkDeviceSize heapSize = memoryProperties_.memoryHeaps[heap].size;
+    types_[i].blockSize = std::min( MEMORY_BLOCK_SIZE, heapSize / 8 );
+  }
+}
+
+void MemoryAllocator::destroy() {
+  MemoryStats total = stats();
+  if ( total.allocations > 0 ) {
+    THUMPY_LOG_CHANNEL( memoryChannel, Logger::WARNING, total.allocations,
+                        " allocations still alive, ", total.used, " bytes" );
+  }
+
+  for ( MemoryType &type : types_ ) {
+    for ( Block &block : type.blocks ) {
+      if ( block.memory != VK_NULL_HANDLE ) {
+        vkFreeMemory( vulkanDevice_->device, block.memory, nullptr );
+      }
+    }
+    type.blocks.clear();
+    type.stats = MemoryStats();
+  }
+}
+
+MemoryAllocation MemoryAllocator::allocate_buffer( VkBuffer buffer,
+                                                   VkMemoryPropertyFlags properties ) {
+  MemoryAllocation allocation;
+  if ( dedicatedAllocation_ ) {
+    VkBufferMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    info.buffer = buffer;
+
+    VkMemoryDedicatedRequirements dedicatedRequirements{};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+    vkGetBufferMemoryRequirements2( vulkanDevice_->device, &info, &requirements );
+
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.buffer = buffer;
+    allocation = allocate( requirements.memoryRequirements, properties, TILING_LINEAR,
+                           dedicatedRequirements.prefersDedicatedAllocation ? &dedicatedInfo
+                                                                            : nullptr );
+  } else {
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements( vulkanDevice_->device, buffer, &requirements );
+    allocation = allocate( requirements, properties, TILING_LINEAR );
+  }
+
+  vkBindBufferMemory( vulkanDevice_->device, buffer, allocation.memory, allocation.offset );
+  return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate_image( VkImage image, VkMemoryPropertyFlags properties,
+                                                  VkImageTiling tiling ) {
+  ResourceTiling resourceTiling =
+      tiling == VK_IMAGE_TILING_LINEAR ? TILING_LINEAR : TILING_OPTIMAL;
+
+  MemoryAllocation allocation;
+  if ( dedicatedAllocation_ ) {
+    VkImageMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    info.image = image;
+
+    VkMemoryDedicatedRequirements dedicatedRequirements{};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+    vkGetImageMemoryRequirements2( vulkanDevice_->device, &info, &requirements );
+
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.image = image;
+    allocation = allocate( requirements.memoryRequirements, properties, resourceTiling,
+                           dedicatedRequirements.prefersDedicatedAllocation ? &dedicatedInfo
+                                                                            : nullptr );
+  } else {
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements( vulkanDevice_->device, image, &requirements );
+    allocation = allocate( requirements, properties, resourceTiling );
+  }
+
+  vkBindImageMemory( vulkanDevice_->device, image, allocation.memory, allocation.offset );
+  return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate( const VkMemoryRequirements &requirements,
+                                            VkMemoryPropertyFlags properties,
+                                            ResourceTiling tiling,
+                                            const VkMemoryDedicatedAllocateInfo *dedicated ) {
+  MemoryAllocation allocation;
+  allocation.memoryType = find_memory_type( requirements.memoryTypeBits, properties );
+  if ( allocation.memoryType == UINT32_MAX &&
+       ( properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT ) ) {
+    // Only tilers have lazy memory, everything else backs transient attachments normally
+    properties &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    allocation.memoryType = find_memory_type( requirements.memoryTypeBits, properties );
+  }
+  if ( allocation.memoryType == UINT32_MAX ) {
+    Logger::log( "Failed to find suitable memory type!", Logger::CRITICAL );
+    return allocation;
+  }
+  MemoryType &type = types_[allocation.memoryType];
+  allocation.size = requirements.size;
+
+  // Big resources would leave most of a block unused, e.g. render targets. Lazy memory is
+  // committed per allocation, a shared block would never stay uncommitted
+  bool lazy = memoryProperties_.memoryTypes[allocation.memoryType].propertyFlags &
+              VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  if ( dedicated != nullptr || lazy || requirements.size > type.blockSize / 2 ) {
+    uint8_t *mapped;
+    allocation.memory = allocate_device_memory( allocation.memoryType, requirements.size,
+                                                dedicated, &mapped );
+    allocation.mapped = mapped;
+    allocation.block = UINT32_MAX;
+    type.stats.dedicated++;
+    type.stats.allocations++;
+    type.stats.reserved += requirements.size;
+    type.stats.used += requirements.size;
+    return allocation;
+  }
+
+  // Linear & optimal resources only share a block when the granularity can't split a page
+  bool separateTiling = bufferImageGranularity_ > 1;
+
+  uint32_t freeSlot = UINT32_MAX;
+  for ( uint32_t i = 0; i < type.blocks.size(); i++ ) {
+    Block &block = type.blocks[i];
+    if ( block.memory == VK_NULL_HANDLE ) {
+      freeSlot = std::min( freeSlot, i );
+      continue;
+    }
+    if ( separateTiling && block.tiling != tiling ) {
+      continue;
+    }
+    if ( block.allocator.allocate( requirements.size, requirements.alignment, &allocation.offset,
+                                   &allocation.handle ) ) {
+      allocation.memory = block.memory;
+      allocation.mapped = block.mapped != nullptr ? block.mapped + allocation.offset : nullptr;
+      allocation.block = i;
+      type.stats.allocations++;
+      type.stats.used += requirements.size;
+      return allocation;
+    }
+  }
+
+  // Nothing has room, start a new block
+  Block block;
+  block.tiling = tiling;
+  block.allocator = TlsfAllocator( type.blockSize );
+  block.memory =
+      allocate_device_memory( allocation.memoryType, type.blockSize, nullptr, &block.mapped );
+  if ( freeSlot == UINT32_MAX ) {
+    freeSlot = static_cast<uint32_t>( type.blocks.size() );
+    type.blocks.push_back( std::move( block ) );
+  } else {
+    type.blocks[freeSlot] = std::move( block );
+  }
+  type.stats.blocks++;
+  type.stats.reserved += type.blockSize;
+  THUMPY_LOG_CHANNEL( memoryChannel, Logger::DEBUG, "New ", to_megabytes( type.blockSize ),
+                      " MB block for memory type ", allocation.memoryType );
+
+  Block &newBlock = type.blocks[freeSlot];
+  if ( !newBlock.allocator.allocate( requirements.size, requirements.alignment, &allocation.offset,
+                                     &allocation.handle ) ) {
+    Logger::log( "Failed to sub-allocate from a new memory block!", Logger::CRITICAL );
+  }
+  allocation.memory = newBlock.memory;
+  allocation.mapped = newBlock.mapped != nullptr ? newBlock.mapped + allocation.offset : nullptr;
+  allocation.block = freeSlot;
+  type.stats.allocations++;
+  type.stats.used += requirements.size;
+  return allocation;
+}
+
+void MemoryAllocator::free( MemoryAllocation &allocation ) {
+  if ( allocation.memory == VK_NULL_HANDLE ) {
+    return;
+  }
+  MemoryType &type = types_[allocation.memoryType];
+  type.stats.allocations--;
+  type.stats.used -= allocation.size;
+
+  if ( allocation.block == UINT32_MAX ) {
+    vkFreeMemory( vulkanDevice_->device, allocation.memory, nullptr );
+    type.stats.dedicated--;
+    type.stats.reserved -= allocation.size;
+    allocation = MemoryAllocation();
+    return;
+  }
+
+  Block &block = type.blocks[allocation.block];
+  block.allocator.free( allocation.handle );
+
+  // Keep one block around so a type that empties out doesn't thrash vkAllocateMemory
+  if ( block.allocator.empty() && type.stats.blocks > 1 ) {
+    vkFreeMemory( vulkanDevice_->device, block.memory, nullptr );
+    block.memory = VK_NULL_HANDLE;
+    block.mapped = nullptr;
+    block.allocator = TlsfAllocator();
+    type.stats.blocks--;
+    type.stats.reserved -= type.blockSize;
+  }
+  allocation = MemoryAllocation();
+}
+
+uint32_t MemoryAllocator::find_memory_type( uint32_t typeFilter,
+                                            VkMemoryPropertyFlags properties ) const {
+  for ( uint32_t i = 0; i < memoryProperties_.memoryTypeCount; i++ ) {
+    if ( ( typeFilter & ( 1 << i ) ) &&
+         ( memoryProperties_.memoryTypes[i].propertyFlags & properties ) == properties ) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+MemoryStats MemoryAllocator::stats() const {
+  MemoryStats total;
+  for ( uint32_t i = 0; i < memoryProperties_.memoryTypeCount; i++ ) {
+    const MemoryStats &stats = types_[i].stats;
+    total.blocks += stats.blocks;
+    total.dedicated += stats.dedicated;
+    total.allocations += stats.allocations;
+    total.reserved += stats.reserved;
+    total.used += stats.used;
+    if ( memoryProperties_.memoryTypes[i].propertyFlags &
+         VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT ) {
+      total.lazilyAllocated += stats.reserved;
+    }
+  }
+  return total;
+}
+
+void MemoryAllocator::log_stats() const {
+  for ( uint32_t i = 0; i < memoryProperties_.memoryTypeCount; i++ ) {
+    const MemoryStats &stats = types_[i].stats;
+    if ( stats.device_memory_count() == 0 ) {
+      continue;
+    }
+    THUMPY_LOG_CHANNEL( memoryChannel, Logger::DEBUG, "Memory type ", i, " (heap ",
+                        memoryProperties_.memoryTypes[i].heapIndex, "): ", stats.allocations,
+                        " allocations in ", stats.blocks, " blocks + ", stats.dedicated,
+                        " dedicated, ", to_megabytes( stats.used ), " / ",
+                        to_megabytes( stats.reserved ), " MB" );
+  }
+
+  MemoryStats total = stats();
+  THUMPY_LOG_CHANNEL( memoryChannel, Logger::INFO, "Memory: ", total.allocations,
+                      " allocations in ", total.device_memory_count(), " device allocations, ",
+                      to_megabytes( total.used ), " / ", to_megabytes( total.reserved ),
+                      " MB used, ", to_megabytes( total.lazilyAllocated ),
+                      " MB lazily allocated" );
+}
+
+VkDeviceMemory MemoryAllocator::allocate_device_memory( uint32_t memoryType, VkDeviceSize size,
+                                                        const void *pNext, uint8_t **mapped ) {
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.pNext = pNext;
+  allocInfo.allocationSize = size;
+  allocInfo.memoryTypeIndex = memoryType;
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if ( vkAllocateMemory( vulkanDevice_->device, &allocInfo, nullptr, &memory ) != VK_SUCCESS ) {
+    Logger::log( "Failed to allocate device memory!", Logger::CRITICAL );
+  }
+
+  *mapped = nullptr;
+  if ( memoryProperties_.memoryTypes[memoryType].propertyFlags &
+       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) {
+    void *data;
+    if ( vkMapMemory( vulkanDevice_->device, memory, 0, VK_WHOLE_SIZE, 0, &data ) != VK_SUCCESS ) {
+      Logger::log( "Failed to map device memory!", Logger::CRITICAL );
+    }
+    *mapped = static_cast<uint8_t *>( data );
+  }
+  return memory;
+}
+
+#pragma endregion Device memory
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,244 @@
+/**
+ * @file vulkan_memory.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Device memory sub-allocator, buffers & images share a few large allocations
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+class VulkanDevice;
+
+// Preferred size of a memory block, smaller heaps get an eighth of the heap instead
+const VkDeviceSize MEMORY_BLOCK_SIZE = 64 * 1024 * 1024;
+
+// TLSF second level lists per power of two
+const uint32_t TLSF_SL_BITS = 4;
+const uint32_t TLSF_SL_COUNT = 1 << TLSF_SL_BITS;
+const uint32_t TLSF_FL_COUNT = 64;
+
+/**
+ * @brief Two level segregated fit allocator over a fixed number of bytes, only hands out
+ * offsets. Allocate & free are O(1), neighbouring free ranges are merged on free.
+ */
+class TlsfAllocator {
+ public:
+  explicit TlsfAllocator( VkDeviceSize capacity = 0 );
+
+  /**
+   * @brief Take size bytes starting at a multiple of alignment
+   *
+   * @param size
+   * @param alignment power of two
+   * @param offset set on success
+   * @param handle set on success, passed to free
+   * @return false if no free range is large enough
+   */
+  bool allocate( VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset,
+                 uint32_t *handle );
+
+  /**
+   * @brief Give an allocation back
+   *
+   * @param handle from allocate
+   */
+  void free( uint32_t handle );
+
+  VkDeviceSize used() const { return used_; }
+  VkDeviceSize capacity() const { return capacity_; }
+  uint32_t allocation_count() const { return allocationCount_; }
+  bool empty() const { return allocationCount_ == 0; }
+
+ private:
+  static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+
+  // A used or free range, linked to its neighbours in memory & in its free list
+  struct Block {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    uint32_t prevPhysical;
+    uint32_t nextPhysical;
+    uint32_t prevFree;
+    uint32_t nextFree;
+    bool free;
+  };
+
+  uint32_t new_block();
+  void insert_free( uint32_t block );
+  void remove_free( uint32_t block );
+  uint32_t find_free( VkDeviceSize size );
+
+  VkDeviceSize capacity_;
+  VkDeviceSize used_ = 0;
+  uint32_t allocationCount_ = 0;
+
+  std::vector<Block> blocks_;
+  std::vector<uint32_t> unusedBlocks_;
+
+  uint64_t flBitmap_ = 0;
+  std::array<uint32_t, TLSF_FL_COUNT> slBitmaps_{};
+  std::array<uint32_t, TLSF_FL_COUNT * TLSF_SL_COUNT> freeLists_;
+};
+
+/**
+ * @brief Whether a resource is laid out linearly (buffers) or optimally (optimal tiled images).
+ * The two are kept bufferImageGranularity apart by never sharing a block when it matters.
+ */
+enum ResourceTiling { TILING_LINEAR, TILING_OPTIMAL };
+
+/**
+ * @brief Where a resource's memory lives, bind it at memory + offset
+ *
+ */
+struct MemoryAllocation {
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  // Set for host visible memory, blocks stay mapped for their whole life
+  void *mapped = nullptr;
+  uint32_t memoryType = 0;
+  uint32_t block = UINT32_MAX;  // UINT32_MAX for a dedicated allocation
+  uint32_t handle = 0;
+};
+
+/**
+ * @brief Device memory in use, summed over every memory type
+ *
+ */
+struct MemoryStats {
+  uint32_t blocks = 0;
+  uint32_t dedicated = 0;     // Allocations that got their own VkDeviceMemory
+  uint32_t allocations = 0;   // Resources bound, sub-allocated or dedicated
+  VkDeviceSize reserved = 0;  // Bytes taken from the device with vkAllocateMemory
+  VkDeviceSize used = 0;      // Bytes handed out to resources
+  // Part of reserved in lazily allocated memory, only backed by tile memory on tilers
+  VkDeviceSize lazilyAllocated = 0;
+
+  uint32_t device_memory_count() const { return blocks + dedicated; }
+};
+
+/**
+ * @brief Every vkAllocateMemory goes through here. Each memory type gets large blocks that
+ * resources are TLSF sub-allocated from; resources bigger than half a block, or that the driver
+ * prefers dedicated, get their own allocation. Host visible blocks are mapped once, so callers
+ * use MemoryAllocation::mapped instead of vkMapMemory. Not thread safe.
+ */
+class MemoryAllocator {
+ public:
+  MemoryAllocator( VulkanDevice *vulkanDevice );
+
+  /**
+   * @brief Free every block, logs anything still allocated
+   *
+   */
+  void destroy();
+
+  /**
+   * @brief Allocate & bind memory for a buffer
+   *
+   * @param buffer
+   * @param properties
+   * @return MemoryAllocation
+   */
+  MemoryAllocation allocate_buffer( VkBuffer buffer, VkMemoryPropertyFlags properties );
+
+  /**
+   * @brief Allocate & bind memory for an image
+   *
+   * @param image
+   * @param properties
+   * @param tiling VK_IMAGE_TILING_LINEAR images are placed like buffers
+   * @return MemoryAllocation
+   */
+  MemoryAllocation allocate_image( VkImage image, VkMemoryPropertyFlags properties,
+                                   VkImageTiling tiling );
+
+  /**
+   * @brief Allocate memory matching requirements
+   *
+   * @param requirements
+   * @param properties VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT is only a preference, dropped when
+   * no memory type has it. Lazily allocated memory always gets its own allocation
+   * @param tiling
+   * @param dedicated pNext of a dedicated allocation, nullptr to sub-allocate when it fits
+   * @return MemoryAllocation
+   */
+  MemoryAllocation allocate( const VkMemoryRequirements &requirements,
+                             VkMemoryPropertyFlags properties, ResourceTiling tiling,
+                             const VkMemoryDedicatedAllocateInfo *dedicated = nullptr );
+
+  /**
+   * @brief Give memory back, the resource bound to it has to be destroyed already.
+   * Empty blocks are freed, except the last one of each memory type.
+   * @param allocation reset to an empty allocation
+   */
+  void free( MemoryAllocation &allocation );
+
+  /**
+   * @brief Find a memory type with the properties
+   *
+   * @param typeFilter
+   * @param properties
+   * @return uint32_t UINT32_MAX if none
+   */
+  uint32_t find_memory_type( uint32_t typeFilter, VkMemoryPropertyFlags properties ) const;
+
+  /**
+   * @brief Totals over every memory type
+   *
+   * @return MemoryStats
+   */
+  MemoryStats stats() const;
+
+  /**
+   * @brief Log each memory type in use & the totals to the Vulkan::Memory channel
+   *
+   */
+  void log_stats() const;
+
+ private:
+  struct Block {
+    VkDeviceMemory memory;
+    uint8_t *mapped;
+    ResourceTiling tiling;
+    TlsfAllocator allocator;
+  };
+
+  struct MemoryType {
+    VkDeviceSize blockSize = 0;
+    // Freed blocks leave a VK_NULL_HANDLE slot so allocations keep their block index
+    std::vector<Block> blocks;
+    MemoryStats stats;
+  };
+
+  VkDeviceMemory allocate_device_memory( uint32_t memoryType, VkDeviceSize size,
+                                         const void *pNext, uint8_t **mapped );
+
+  VulkanDevice *vulkanDevice_;
+  VkPhysicalDeviceMemoryProperties memoryProperties_;
+  VkDeviceSize bufferImageGranularity_;
+  // vkGet*MemoryRequirements2 & dedicated allocations are Vulkan 1.1
+  bool dedicatedAllocation_;
+
+  std::array<MemoryType, VK_MAX_MEMORY_TYPES> types_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
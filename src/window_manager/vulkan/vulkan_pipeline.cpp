@@ -13,6 +13,7 @@
 
 #include "vulkan_pipeline.hpp"
 
+#include <filesystem>
 #include <fstream>
 #include <ios>
 #include <string>
@@ -27,11 +28,11 @@ namespace Vulkan {
 
 // Please move this to a better place
 static std::vector<char> read_file( const std::string &filename ) {
-  Logger::log( "opening file: " + filename, Logger::INFO );
+  THUMPY_LOG( Logger::INFO, "opening file: ", filename );
   std::ifstream file( filename, std::ios::ate | std::ios::binary );
 
   if ( !file.is_open() ) {
-    Logger::log( "failed to open file: " + filename, Logger::CRITICAL );
+    THUMPY_LOG( Logger::CRITICAL, "failed to open file: ", filename );
   }
 
   size_t fileSize = (size_t)file.tellg();
@@ -47,8 +48,8 @@ static std::vector<char> read_file( const std::string &filename ) {
 
 VulkanPipeline *create_graphics_pipeline( VulkanSwapChain *swapChain, VulkanDevice *vulkanDevice,
                                           VkDescriptorSetLayout descriptorSetLayout ) {
-  Logger::log( "Loading shaders from: " + get_shader_path(), Logger::INFO );
-  auto vertShaderCode = read_file( get_shader_path() + "texture.vert.spv" );
+  THUMPY_LOG( Logger::INFO, "Loading shaders from: ", get_shader_path() );
+  auto vertShaderCode = read_file( get_shader_path() + "instanced.vert.spv" );
   auto fragShaderCode = read_file( get_shader_path() + +"texture.frag.spv" );
 
   VkShaderModule vertShaderModule = create_shader_module( vertShaderCode, vulkanDevice->device );
@@ -140,8 +141,15 @@ VulkanPipeline *create_graphics_pipeline( VulkanSwapChain *swapChain, VulkanDevi
   // ### pipeline layout ###
 
   VulkanPipeline *pipeline = new VulkanPipeline();
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = sizeof( DrawConstants );
+
   VkPipelineLayoutCreateInfo pipelineLayoutInfo =
       Initializer::pipeline_layout_info( descriptorSetLayout );
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
   if ( vkCreatePipelineLayout( vulkanDevice->device, &pipelineLayoutInfo, nullptr,
                                &pipeline->pipelineLayout ) != VK_SUCCESS ) {
@@ -163,6 +171,16 @@ VulkanPipeline *create_graphics_pipeline( VulkanSwapChain *swapChain, VulkanDevi
   pipelineInfo.layout = pipeline->pipelineLayout;
   pipelineInfo.renderPass = swapChain->renderPass;
   pipelineInfo.subpass = 0;
+
+  // Without a render pass the attachment formats are given up front
+  VkPipelineRenderingCreateInfoKHR renderingInfo{};
+  renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+  renderingInfo.colorAttachmentCount = 1;
+  renderingInfo.pColorAttachmentFormats = &swapChain->swapChainImageFormat;
+  renderingInfo.depthAttachmentFormat = swapChain->depthFormat;
+  if ( vulkanDevice->dynamicRendering ) {
+    pipelineInfo.pNext = &renderingInfo;
+  }
   pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;  // Optional
   pipelineInfo.basePipelineIndex = -1;               // Optional
 
@@ -183,6 +201,60 @@ void destroy_graphics_pipeline( VkDevice device, VulkanPipeline *pipeline ) {
   vkDestroyPipelineLayout( device, pipeline->pipelineLayout, nullptr );
 }
 
+VulkanComputePipeline *create_compute_pipeline( VulkanDevice *vulkanDevice,
+                                                const std::string &shaderFile,
+                                                VkDescriptorSetLayout descriptorSetLayout,
+                                                uint32_t pushConstantSize ) {
+  if ( !std::filesystem::exists( get_shader_path() + shaderFile ) ) {
+    THUMPY_LOG( Logger::WARNING, shaderFile, " not found" );
+    return nullptr;
+  }
+  auto shaderCode = read_file( get_shader_path() + shaderFile );
+  VkShaderModule shaderModule = create_shader_module( shaderCode, vulkanDevice->device );
+
+  VkPipelineShaderStageCreateInfo stageInfo{};
+  stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  stageInfo.module = shaderModule;
+  stageInfo.pName = "main";
+
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = pushConstantSize;
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo =
+      Initializer::pipeline_layout_info( descriptorSetLayout );
+  if ( pushConstantSize > 0 ) {
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+  }
+
+  VulkanComputePipeline *pipeline = new VulkanComputePipeline();
+  if ( vkCreatePipelineLayout( vulkanDevice->device, &pipelineLayoutInfo, nullptr,
+                               &pipeline->pipelineLayout ) != VK_SUCCESS ) {
+    Logger::log( "Failed to create compute pipeline layout!", Logger::CRITICAL );
+  }
+
+  VkComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  pipelineInfo.stage = stageInfo;
+  pipelineInfo.layout = pipeline->pipelineLayout;
+
+  if ( vkCreateComputePipelines( vulkanDevice->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+                                 &pipeline->computePipeline ) != VK_SUCCESS ) {
+    Logger::log( "Failed to create compute pipeline!", Logger::CRITICAL );
+  }
+
+  vkDestroyShaderModule( vulkanDevice->device, shaderModule, nullptr );
+  return pipeline;
+}
+
+void destroy_compute_pipeline( VkDevice device, VulkanComputePipeline *pipeline ) {
+  vkDestroyPipeline( device, pipeline->computePipeline, nullptr );
+  vkDestroyPipelineLayout( device, pipeline->pipelineLayout, nullptr );
+}
+
 VkShaderModule create_shader_module( const std::vector<char> &code, VkDevice vulkanDevice ) {
   VkShaderModuleCreateInfo createInfo = Initializer::shader_module_create_info( code );
 
@@ -13,6 +13,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <glm/glm.hpp>
+#include <string>
 #include <vector>
 
 #include "vulkan_device.hpp"
@@ -23,16 +25,46 @@ namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+/**
+ * @brief Per draw push constants, matches DrawConstants in instanced.vert.
+ * Every graphics pipeline layout has room for them, so changing them between draws needs no
+ * descriptor updates.
+ */
+struct DrawConstants {
+  uint32_t material;  // Batch's index into CameraData::materials
+};
+
 struct VulkanPipeline {
   VkPipelineLayout pipelineLayout;
   VkPipeline graphicsPipeline;
 };
 
+struct VulkanComputePipeline {
+  VkPipelineLayout pipelineLayout;
+  VkPipeline computePipeline;
+};
+
 VulkanPipeline *create_graphics_pipeline( VulkanSwapChain *swapChain, VulkanDevice *vulkanDevice,
                                           VkDescriptorSetLayout descriptorSetLayout );
 
 void destroy_graphics_pipeline( VkDevice vulkanDevice, VulkanPipeline *pipeline );
 
+/**
+ * @brief Create a compute pipeline with one descriptor set & an optional push constant range
+ *
+ * @param vulkanDevice
+ * @param shaderFile spv file in the shader folder
+ * @param descriptorSetLayout
+ * @param pushConstantSize 0 for none
+ * @return VulkanComputePipeline* nullptr if the shader has not been compiled
+ */
+VulkanComputePipeline *create_compute_pipeline( VulkanDevice *vulkanDevice,
+                                                const std::string &shaderFile,
+                                                VkDescriptorSetLayout descriptorSetLayout,
+                                                uint32_t pushConstantSize );
+
+void destroy_compute_pipeline( VkDevice device, VulkanComputePipeline *pipeline );
+
 VkShaderModule create_shader_module( const std::vector<char> &code, VkDevice vulkanDevice );
 
 }  // namespace Vulkan
@@ -0,0 +1,149 @@
+/**
+ * @file vulkan_present_timer.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_present_timer cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_present_timer.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "vulkan_device.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+PresentTimer::PresentTimer( VulkanDevice *vulkanDevice )
+    : vulkanDevice_( vulkanDevice ), enabled_( vulkanDevice->presentWait ) {
+  if ( !enabled_ ) {
+    return;
+  }
+  pending_.resize( MAX_PENDING_PRESENTS );
+  thread_ = std::thread( &PresentTimer::wait_loop, this );
+}
+
+void PresentTimer::destroy() {
+  if ( !thread_.joinable() ) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    stopping_ = true;
+  }
+  condition_.notify_one();
+  thread_.join();
+}
+
+VkResult PresentTimer::present( VkQueue queue, const VkPresentInfoKHR &presentInfo,
+                                std::chrono::steady_clock::time_point start ) {
+  if ( !enabled_ ) {
+    return vkQueuePresentKHR( queue, &presentInfo );
+  }
+
+  presentWaiting_ = true;
+  std::unique_lock<std::mutex> lock( mutex_ );
+  presentWaiting_ = false;
+
+  uint64_t id = nextId_++;
+  VkPresentIdKHR presentId{};
+  presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+  presentId.pNext = presentInfo.pNext;
+  presentId.swapchainCount = 1;
+  presentId.pPresentIds = &id;
+
+  VkPresentInfoKHR info = presentInfo;
+  info.pNext = &presentId;
+  VkResult result = vkQueuePresentKHR( queue, &info );
+  if ( result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR ) {
+    return result;
+  }
+
+  if ( pendingCount_ == MAX_PENDING_PRESENTS ) {
+    pendingStart_ = ( pendingStart_ + 1 ) % MAX_PENDING_PRESENTS;
+    pendingCount_--;
+  }
+  pending_[( pendingStart_ + pendingCount_ ) % MAX_PENDING_PRESENTS] =
+      PendingPresent{ info.pSwapchains[0], id, start };
+  pendingCount_++;
+
+  lock.unlock();
+  condition_.notify_one();
+  return result;
+}
+
+void PresentTimer::retire() {
+  if ( !enabled_ ) {
+    return;
+  }
+
+  presentWaiting_ = true;
+  std::lock_guard<std::mutex> lock( mutex_ );
+  presentWaiting_ = false;
+  pendingStart_ = 0;
+  pendingCount_ = 0;
+}
+
+void PresentTimer::collect( double *milliseconds, uint64_t *samples ) {
+  if ( !enabled_ ) {
+    return;
+  }
+
+  presentWaiting_ = true;
+  std::lock_guard<std::mutex> lock( mutex_ );
+  presentWaiting_ = false;
+  *milliseconds += latencyMilliseconds_;
+  *samples += latencySamples_;
+  latencyMilliseconds_ = 0.0;
+  latencySamples_ = 0;
+}
+
+void PresentTimer::wait_loop() {
+  std::unique_lock<std::mutex> lock( mutex_ );
+  while ( true ) {
+    condition_.wait( lock, [this] { return stopping_ || pendingCount_ > 0; } );
+    if ( stopping_ ) {
+      return;
+    }
+
+    // The lock is held, so nothing presents to or recreates the swap chain during the wait
+    const PendingPresent &present = pending_[pendingStart_];
+    VkResult result = vulkanDevice_->waitForPresent( vulkanDevice_->device, present.swapChain,
+                                                     present.id, PRESENT_WAIT_TIMEOUT );
+    if ( result == VK_TIMEOUT ) {
+      // Not on screen yet, let the render thread in before waiting again
+      lock.unlock();
+      while ( presentWaiting_ ) {
+        std::this_thread::yield();
+      }
+      lock.lock();
+      continue;
+    }
+
+    if ( result == VK_SUCCESS ) {
+      latencyMilliseconds_ += std::chrono::duration<double, std::chrono::milliseconds::period>(
+                                  std::chrono::steady_clock::now() - present.start )
+                                  .count();
+      latencySamples_++;
+    }
+    // Presents to an out of date or lost surface never show up, skip them
+    pendingStart_ = ( pendingStart_ + 1 ) % MAX_PENDING_PRESENTS;
+    pendingCount_--;
+  }
+}
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,113 @@
+/**
+ * @file vulkan_present_timer.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Times frames up to when they reach the screen with VK_KHR_present_wait
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+class VulkanDevice;
+
+// Presents waited on at once, the oldest is dropped if the waiter falls this far behind
+const size_t MAX_PENDING_PRESENTS = 16;
+
+// Longest the waiter holds the swap chain per vkWaitForPresentKHR call, presents wait for it
+const uint64_t PRESENT_WAIT_TIMEOUT = 1000000;  // ns
+
+/**
+ * @brief Latency from the start of a frame to its present, waited for on its own thread with
+ * vkWaitForPresentKHR. The swap chain has to be externally synchronized for that, so presents
+ * & swap chain recreation go through present() & retire(), which take the waiter's lock.
+ * Without present wait support present() only presents and nothing is timed.
+ */
+class PresentTimer {
+ public:
+  PresentTimer( VulkanDevice *vulkanDevice );
+
+  /**
+   * @brief Stop the waiter thread
+   *
+   */
+  void destroy();
+
+  bool enabled() const { return enabled_; }
+
+  /**
+   * @brief Present with the next present id and time it once it's on screen
+   *
+   * @param queue
+   * @param presentInfo one swap chain
+   * @param start when the frame started
+   * @return VkResult of vkQueuePresentKHR
+   */
+  VkResult present( VkQueue queue, const VkPresentInfoKHR &presentInfo,
+                    std::chrono::steady_clock::time_point start );
+
+  /**
+   * @brief Stop waiting on presents to the current swap chain, before it's recreated
+   *
+   */
+  void retire();
+
+  /**
+   * @brief Add the latency measured since the last call, never blocks on a present
+   *
+   * @param milliseconds
+   * @param samples
+   */
+  void collect( double *milliseconds, uint64_t *samples );
+
+ private:
+  struct PendingPresent {
+    VkSwapchainKHR swapChain;
+    uint64_t id;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  void wait_loop();
+
+  VulkanDevice *vulkanDevice_;
+  bool enabled_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  // Set while present() waits for the lock, so the waiter lets it in between timeouts
+  std::atomic<bool> presentWaiting_{ false };
+  bool stopping_ = false;
+
+  uint64_t nextId_ = 1;
+  // Ring, oldest first. Sized once so presenting never allocates
+  std::vector<PendingPresent> pending_;
+  size_t pendingStart_ = 0;
+  size_t pendingCount_ = 0;
+
+  double latencyMilliseconds_ = 0.0;
+  uint64_t latencySamples_ = 0;
+
+  std::thread thread_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -0,0 +1,170 @@
+/**
+ * @file vulkan_recorder.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_recorder cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_recorder.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include "channel.hpp"
+#include "logger.hpp"
+#include "vulkan_initializers.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+Logger::Channel &recorderChannel = Logger::get_channel( "Vulkan::Recorder" );
+
+}  // namespace
+
+VulkanRecorder::VulkanRecorder( VulkanDevice *vulkanDevice, int maxFramesInFlight,
+                                uint32_t threadCount, RecordDraws recordDraws ) {
+  vulkanDevice_ = vulkanDevice;
+  threadCount_ = std::clamp( threadCount, 1u, MAX_RECORD_THREADS );
+  recordDraws_ = std::move( recordDraws );
+
+  QueueFamilyIndices queueFamilyIndices =
+      vulkanDevice_->find_queue_families( vulkanDevice_->physicalDevice );
+
+  // Pools are reset whole each frame instead of per buffer
+  VkCommandPoolCreateInfo poolInfo =
+      Initializer::pool_info( queueFamilyIndices.graphicsFamily.value() );
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+  size_t poolCount = static_cast<size_t>( maxFramesInFlight ) * threadCount_;
+  commandPools_.resize( poolCount );
+  commandBuffers_.resize( poolCount );
+  for ( size_t i = 0; i < poolCount; i++ ) {
+    if ( vkCreateCommandPool( vulkanDevice_->device, &poolInfo, nullptr, &commandPools_[i] ) !=
+         VK_SUCCESS ) {
+      Logger::log( "Failed to create recording command pool!", Logger::CRITICAL );
+    }
+
+    VkCommandBufferAllocateInfo allocInfo =
+        Initializer::command_buffer_allocate_info( commandPools_[i], 1 );
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    if ( vkAllocateCommandBuffers( vulkanDevice_->device, &allocInfo, &commandBuffers_[i] ) !=
+         VK_SUCCESS ) {
+      Logger::log( "Failed to allocate secondary command buffers!", Logger::CRITICAL );
+    }
+  }
+
+  // The calling thread records the first range itself
+  for ( uint32_t thread = 1; thread < threadCount_; thread++ ) {
+    workers_.emplace_back( &VulkanRecorder::worker_loop, this, thread );
+  }
+
+  THUMPY_LOG_CHANNEL( recorderChannel, Logger::DEBUG, "Recording draws on up to ", threadCount_,
+                      " threads" );
+}
+
+void VulkanRecorder::destroy() {
+  {
+    std::lock_guard<std::mutex> lock( jobMutex_ );
+    running_ = false;
+    jobCondition_.notify_all();
+  }
+  for ( std::thread &worker : workers_ ) {
+    worker.join();
+  }
+  workers_.clear();
+
+  // Destroying a pool frees its buffers
+  for ( VkCommandPool pool : commandPools_ ) {
+    vkDestroyCommandPool( vulkanDevice_->device, pool, nullptr );
+  }
+  commandPools_.clear();
+  commandBuffers_.clear();
+}
+
+uint32_t VulkanRecorder::recorder_count( uint32_t commandCount ) const {
+  return std::clamp( commandCount / MIN_COMMANDS_PER_RECORDER, 1u, threadCount_ );
+}
+
+uint32_t VulkanRecorder::record( uint32_t frame, const VkCommandBufferInheritanceInfo &inheritance,
+                                 uint32_t commandCount ) {
+  uint32_t rangeCount = recorder_count( commandCount );
+  {
+    std::lock_guard<std::mutex> lock( jobMutex_ );
+    frame_ = frame;
+    inheritance_ = inheritance;
+    commandCount_ = commandCount;
+    rangeCount_ = rangeCount;
+    pending_ = rangeCount - 1;
+    failed_ = false;
+    generation_++;
+  }
+  if ( rangeCount > 1 ) {
+    jobCondition_.notify_all();
+  }
+
+  bool recorded = record_range( 0 );
+
+  std::unique_lock<std::mutex> lock( jobMutex_ );
+  doneCondition_.wait( lock, [this] { return pending_ == 0; } );
+  if ( !recorded || failed_ ) {
+    Logger::log( "Failed to record secondary command buffer!", Logger::CRITICAL );
+  }
+  return rangeCount;
+}
+
+void VulkanRecorder::worker_loop( uint32_t thread ) {
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock( jobMutex_ );
+  while ( true ) {
+    jobCondition_.wait( lock, [&] { return generation_ != seen || !running_; } );
+    if ( !running_ ) {
+      break;
+    }
+    seen = generation_;
+    if ( thread >= rangeCount_ ) {
+      continue;
+    }
+
+    lock.unlock();
+    bool recorded = record_range( thread );
+    lock.lock();
+
+    failed_ = failed_ || !recorded;
+    if ( --pending_ == 0 ) {
+      doneCondition_.notify_one();
+    }
+  }
+}
+
+bool VulkanRecorder::record_range( uint32_t thread ) {
+  size_t slot = static_cast<size_t>( frame_ ) * threadCount_ + thread;
+  if ( vkResetCommandPool( vulkanDevice_->device, commandPools_[slot], 0 ) != VK_SUCCESS ) {
+    return false;
+  }
+
+  VkCommandBuffer commandBuffer = commandBuffers_[slot];
+  VkCommandBufferBeginInfo beginInfo =
+      Initializer::secondary_command_buffer_begin_info( &inheritance_ );
+  if ( vkBeginCommandBuffer( commandBuffer, &beginInfo ) != VK_SUCCESS ) {
+    return false;
+  }
+  recordDraws_( commandBuffer, split_draws( commandCount_, rangeCount_, thread ) );
+  return vkEndCommandBuffer( commandBuffer ) == VK_SUCCESS;
+}
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
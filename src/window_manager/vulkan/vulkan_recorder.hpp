@@ -0,0 +1,132 @@
+/**
+ * @file vulkan_recorder.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Records draw list commands into secondary command buffers on a worker pool
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "vulkan_device.hpp"
+#include "vulkan_draw_list.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+// Below this many commands per thread, handing work to another thread costs more than it saves
+const uint32_t MIN_COMMANDS_PER_RECORDER = 64;
+const uint32_t MAX_RECORD_THREADS = 8;
+
+/**
+ * @brief Splits a frame's draw commands across threads, each recording its range into a secondary
+ * command buffer from its own per frame command pool. The calling thread records the first range.
+ * Buffers come back in command order, ready for vkCmdExecuteCommands.
+ */
+class VulkanRecorder {
+ public:
+  // Records one range of draws, called from any recording thread
+  using RecordDraws = std::function<void( VkCommandBuffer commandBuffer, DrawRange range )>;
+
+  /**
+   * @brief Create the command pools & start the worker threads
+   *
+   * @param vulkanDevice
+   * @param maxFramesInFlight
+   * @param threadCount recording threads including the caller's, clamped to MAX_RECORD_THREADS
+   * @param recordDraws
+   */
+  VulkanRecorder( VulkanDevice *vulkanDevice, int maxFramesInFlight, uint32_t threadCount,
+                  RecordDraws recordDraws );
+
+  /**
+   * @brief Stop the workers & destroy the command pools, the device has to be idle
+   *
+   */
+  void destroy();
+
+  uint32_t thread_count() const { return threadCount_; }
+
+  /**
+   * @brief How many threads a draw list of commandCount would be recorded on
+   *
+   * @param commandCount
+   * @return uint32_t 1 when recording inline is cheaper
+   */
+  uint32_t recorder_count( uint32_t commandCount ) const;
+
+  /**
+   * @brief Record commandCount draws in parallel, blocks until every range is recorded.
+   * The frame's pools are reset first, so its last submission must have completed.
+   * @param frame frame in flight index
+   * @param inheritance render pass & framebuffer the buffers execute in, or the dynamic rendering
+   * formats chained in pNext, which only has to live until this returns
+   * @param commandCount
+   * @return uint32_t number of secondary buffers recorded, see command_buffers
+   */
+  uint32_t record( uint32_t frame, const VkCommandBufferInheritanceInfo &inheritance,
+                   uint32_t commandCount );
+
+  /**
+   * @brief A frame's secondary command buffers, in command order
+   *
+   * @param frame frame in flight index
+   * @return const VkCommandBuffer*
+   */
+  const VkCommandBuffer *command_buffers( uint32_t frame ) const {
+    return &commandBuffers_[frame * threadCount_];
+  }
+
+ private:
+  void worker_loop( uint32_t thread );
+
+  /**
+   * @brief Record the thread's range of the current job
+   *
+   * @param thread
+   * @return false if Vulkan failed, CRITICAL can't be thrown from a worker
+   */
+  bool record_range( uint32_t thread );
+
+  VulkanDevice *vulkanDevice_;
+  uint32_t threadCount_;
+  RecordDraws recordDraws_;
+
+  // One pool & buffer per frame in flight per thread, indexed frame * threadCount_ + thread
+  std::vector<VkCommandPool> commandPools_;
+  std::vector<VkCommandBuffer> commandBuffers_;
+
+  std::vector<std::thread> workers_;
+  std::mutex jobMutex_;
+  std::condition_variable jobCondition_;
+  std::condition_variable doneCondition_;
+  bool running_ = true;
+
+  // Current job, written under jobMutex_ before workers are woken
+  uint64_t generation_ = 0;
+  uint32_t frame_ = 0;
+  VkCommandBufferInheritanceInfo inheritance_{};
+  uint32_t commandCount_ = 0;
+  uint32_t rangeCount_ = 0;
+  uint32_t pending_ = 0;
+  bool failed_ = false;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -12,152 +12,308 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/glm.hpp>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "channel.hpp"
 #include "logger.hpp"
+#include "vulkan_deletion_queue.hpp"
+#include "vulkan_image.hpp"
 #include "vulkan_initializers.hpp"
+#include "vulkan_memory.hpp"
+#include "vulkan_timeline.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+namespace {
+
+Logger::Channel &renderChannel = Logger::get_channel( "Vulkan::Render" );
+
+}  // namespace
+
 VulkanRender::VulkanRender( int maxFramesInFlight, VulkanDevice *vulkanDevice,
                             VulkanSwapChain *swapChain,
-                            std::vector<VkCommandBuffer> *commandBuffers,
-                            VulkanPipeline *pipeline ) {
+                            const std::vector<VkCommandBuffer> &commandBuffers,
+                            FrameAllocator *frameAllocator,
+                            const Construct::DrawBuffers &drawBuffers,
+                            const std::vector<VkDescriptorSet> &descriptorSets,
+                            VulkanPipeline *pipeline, VulkanCulling *culling ) {
   maxFramesInFlight_ = maxFramesInFlight;
   vulkanDevice_ = vulkanDevice;
   swapChain_ = swapChain;
-  commandBuffers_ = *commandBuffers;
   pipeline_ = pipeline;
+  culling_ = culling;
+  frameAllocator_ = frameAllocator;
+
+  frames_.resize( maxFramesInFlight_ );
+  for ( size_t i = 0; i < maxFramesInFlight_; i++ ) {
+    frames_[i].index = static_cast<uint32_t>( i );
+    frames_[i].commandBuffer = commandBuffers[i];
+    frames_[i].indirectBuffer = drawBuffers.indirectBuffers[i].buffer;
+    frames_[i].indirectMapped = drawBuffers.indirectMapped[i];
+    frames_[i].descriptorSet = descriptorSets[i];
+  }
 
   create_sync_objects();
+  reset_images_in_flight();
+  presentTimer_ = new PresentTimer( vulkanDevice_ );
+
+  recorder_ = new VulkanRecorder(
+      vulkanDevice_, maxFramesInFlight_, std::thread::hardware_concurrency(),
+      [this]( VkCommandBuffer commandBuffer, DrawRange range ) {
+        record_draw_state( commandBuffer, *recordingDrawList_ );
+        record_draws( commandBuffer, *recordingFrame_, *recordingDrawList_, range );
+      } );
 }
 
 void VulkanRender::destroy() {
-  for ( size_t i = 0; i < maxFramesInFlight_; i++ ) {
-    vkDestroySemaphore( vulkanDevice_->device, renderFinishedSemaphores_[i], nullptr );
-    vkDestroySemaphore( vulkanDevice_->device, imageAvailableSemaphores_[i], nullptr );
-    vkDestroyFence( vulkanDevice_->device, inFlightFences_[i], nullptr );
+  recorder_->destroy();
+  delete recorder_;
+  presentTimer_->destroy();
+  delete presentTimer_;
+
+  for ( FrameContext &frame : frames_ ) {
+    vkDestroySemaphore( vulkanDevice_->device, frame.renderFinished, nullptr );
+    vkDestroySemaphore( vulkanDevice_->device, frame.imageAvailable, nullptr );
   }
 }
 
 void VulkanRender::create_sync_objects() {
-  imageAvailableSemaphores_.resize( maxFramesInFlight_ );
-  renderFinishedSemaphores_.resize( maxFramesInFlight_ );
-  inFlightFences_.resize( maxFramesInFlight_ );
-
+  // Binary semaphores for the swap chain, frame completion is tracked on the device timeline
   VkSemaphoreCreateInfo semaphoreInfo = Initializer::semaphore_info();
 
-  VkFenceCreateInfo fenceInfo = Initializer::fence_info();
-
-  for ( size_t i = 0; i < maxFramesInFlight_; i++ ) {
+  for ( FrameContext &frame : frames_ ) {
     if ( vkCreateSemaphore( vulkanDevice_->device, &semaphoreInfo, nullptr,
-                            &imageAvailableSemaphores_[i] ) != VK_SUCCESS ||
+                            &frame.imageAvailable ) != VK_SUCCESS ||
          vkCreateSemaphore( vulkanDevice_->device, &semaphoreInfo, nullptr,
-                            &renderFinishedSemaphores_[i] ) != VK_SUCCESS ||
-         vkCreateFence( vulkanDevice_->device, &fenceInfo, nullptr, &inFlightFences_[i] ) !=
-             VK_SUCCESS ) {
+                            &frame.renderFinished ) != VK_SUCCESS ) {
       Logger::log( "Failed to create synchronization objects for a frame!", Logger::CRITICAL );
     }
   }
 }
 
-void VulkanRender::draw_frame( VkBuffer vertexBuffer, uint32_t vertexCount, VkBuffer indexBuffer,
-                               uint32_t indexCount, std::vector<void *> uniformBuffersMapped,
-                               std::vector<VkDescriptorSet> descriptorSets, VulkanImage *depthImage,
-                               VulkanImage *colorImage ) {
-  vkWaitForFences( vulkanDevice_->device, 1, &inFlightFences_[currentFrame_], VK_TRUE, UINT64_MAX );
+FrameResult VulkanRender::draw_frame( const DrawList &drawList, VulkanImage *depthImage,
+                                      VulkanImage *colorImage ) {
+  auto frameStart = std::chrono::steady_clock::now();
+  FrameContext &frame = frames_[currentFrame_];
+
+  // Objects replaced earlier go once the frames using them are done
+  vulkanDevice_->deletionQueue->process();
+  if ( swapChainOutOfDate_ ||
+       ( resizePending_ && frameStart - lastResize_ >= RESIZE_SETTLE_TIME ) ) {
+    if ( !recreate_swap_chain( depthImage, colorImage ) ) {
+      return FRAME_MINIMIZED;
+    }
+  }
+
+  presentTimer_->collect( &pacing_.latencyMilliseconds, &pacing_.latencySamples );
+
+  // Only wait for the frame that last used this slot, the others keep the GPU busy
+  vulkanDevice_->timeline->wait( frame.timelineValue );
+  if ( frame.timelineValue != 0 ) {
+    if ( !presentTimer_->enabled() &&
+         frame.startTime != std::chrono::steady_clock::time_point() ) {
+      pacing_.latencyMilliseconds +=
+          std::chrono::duration<double, std::chrono::milliseconds::period>(
+              std::chrono::steady_clock::now() - frame.startTime )
+              .count();
+      pacing_.latencySamples++;
+      // Once per submission, a skipped frame comes back to the same slot
+      frame.startTime = std::chrono::steady_clock::time_point();
+    }
+
+    if ( culling_->enabled() ) {
+      culling_->read_stats( frame.index );
+    }
+  }
 
   uint32_t imageIndex;
   VkResult result = vkAcquireNextImageKHR( vulkanDevice_->device, swapChain_->swapChain, UINT64_MAX,
-                                           imageAvailableSemaphores_[currentFrame_], VK_NULL_HANDLE,
-                                           &imageIndex );
+                                           frame.imageAvailable, VK_NULL_HANDLE, &imageIndex );
 
   if ( result == VK_ERROR_OUT_OF_DATE_KHR ) {
-    swapChain_->recreate_swap_chain( depthImage, colorImage );
-    return;
+    // Nothing was submitted, the slot is retried next frame against the new swap chain
+    swapChainOutOfDate_ = true;
+    return recreate_swap_chain( depthImage, colorImage ) ? FRAME_SKIPPED : FRAME_MINIMIZED;
   } else if ( result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR ) {
     Logger::log( "Failed to acquire swap chain image!", Logger::CRITICAL );
   }
 
-  update_uniform_buffer( currentFrame_, uniformBuffersMapped );
+  // With more frames in flight than swap chain images an image can still be in use
+  vulkanDevice_->timeline->wait( imagesInFlight_[imageIndex] );
 
-  vkResetFences( vulkanDevice_->device, 1, &inFlightFences_[currentFrame_] );
+  // The slot's previous frame is done, so its allocator region & indirect buffer are free to
+  // overwrite
+  frameAllocator_->begin_frame( frame.index );
 
-  vkResetCommandBuffer( commandBuffers_[currentFrame_],
-                        /*VkCommandBufferResetFlagBits*/ 0 );
-  record_command_buffer( commandBuffers_[currentFrame_], imageIndex, swapChain_, vertexBuffer,
-                         vertexCount, indexBuffer, indexCount, descriptorSets );
+  CameraData camera = update_camera( frame, drawList );
+
+  uint32_t instanceCount = static_cast<uint32_t>( drawList.instances().size() );
+  FrameAllocation instances =
+      frameAllocator_->allocate_storage( frame.index, instanceCount * sizeof( InstanceData ) );
+  std::memcpy( instances.mapped, drawList.instances().data(),
+               instanceCount * sizeof( InstanceData ) );
+  frame.dynamicOffsets[1] = static_cast<uint32_t>( instances.offset );
 
-  // vkAcquireNextImageKHR(vulkanDevice_->device, swapChain_->swapChain,
-  //                       UINT64_MAX, imageAvailableSemaphores_[currentFrame_],
-  //                       VK_NULL_HANDLE, &imageIndex);
+  std::memcpy( frame.indirectMapped, drawList.commands().data(),
+               drawList.commands().size() * sizeof( VkDrawIndexedIndirectCommand ) );
+
+  if ( culling_->enabled() ) {
+    FrameAllocation bounds =
+        frameAllocator_->allocate_storage( frame.index, instanceCount * sizeof( InstanceBounds ) );
+    std::memcpy( bounds.mapped, drawList.bounds().data(),
+                 instanceCount * sizeof( InstanceBounds ) );
+
+    // The culling pass counts the visible instances back in
+    VkDrawIndexedIndirectCommand *commands =
+        static_cast<VkDrawIndexedIndirectCommand *>( frame.indirectMapped );
+    for ( size_t i = 0; i < drawList.commands().size(); i++ ) {
+      commands[i].instanceCount = 0;
+    }
+    culling_->update( frame.index, camera.view, camera.proj, instanceCount, instances.offset,
+                      bounds.offset );
+  }
+
+  vkResetCommandBuffer( frame.commandBuffer,
+                        /*VkCommandBufferResetFlagBits*/ 0 );
+  record_command_buffer( frame, imageIndex, drawList, depthImage, colorImage );
 
   // submit command buffer
   VkSubmitInfo submitInfo{};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-  VkSemaphore waitSemaphores[] = { imageAvailableSemaphores_[currentFrame_] };
-  VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+  VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
   submitInfo.waitSemaphoreCount = 1;
-  submitInfo.pWaitSemaphores = waitSemaphores;
-  submitInfo.pWaitDstStageMask = waitStages;
+  submitInfo.pWaitSemaphores = &frame.imageAvailable;
+  submitInfo.pWaitDstStageMask = &waitStage;
 
   submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffers_[currentFrame_];
+  submitInfo.pCommandBuffers = &frame.commandBuffer;
 
-  VkSemaphore signalSemaphores[] = { renderFinishedSemaphores_[currentFrame_] };
   submitInfo.signalSemaphoreCount = 1;
-  submitInfo.pSignalSemaphores = signalSemaphores;
+  submitInfo.pSignalSemaphores = &frame.renderFinished;
 
-  if ( vkQueueSubmit( vulkanDevice_->graphicsQueue, 1, &submitInfo,
-                      inFlightFences_[currentFrame_] ) != VK_SUCCESS ) {
-    Logger::log( "Failed to submit draw command buffer!", Logger::CRITICAL );
-  }
+  frame.timelineValue = vulkanDevice_->timeline->submit( vulkanDevice_->graphicsQueue, submitInfo );
+  frame.startTime = frameStart;
+  frameAllocator_->end_frame( frame.index, frame.timelineValue );
+  imagesInFlight_[imageIndex] = frame.timelineValue;
 
   VkPresentInfoKHR presentInfo{};
   presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
   presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores = signalSemaphores;
+  presentInfo.pWaitSemaphores = &frame.renderFinished;
 
-  VkSwapchainKHR swapChains[] = { swapChain_->swapChain };
   presentInfo.swapchainCount = 1;
-  presentInfo.pSwapchains = swapChains;
+  presentInfo.pSwapchains = &swapChain_->swapChain;
   presentInfo.pImageIndices = &imageIndex;
   presentInfo.pResults = nullptr;  // Optional
 
-  result = vkQueuePresentKHR( vulkanDevice_->presentQueue, &presentInfo );
+  result = presentTimer_->present( vulkanDevice_->presentQueue, presentInfo, frameStart );
 
-  if ( result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized_ ) {
-    framebufferResized_ = false;
-    swapChain_->recreate_swap_chain( depthImage, colorImage );
+  // Recreated at the start of a later frame, a suboptimal swap chain still presents fine
+  if ( result == VK_ERROR_OUT_OF_DATE_KHR ) {
+    swapChainOutOfDate_ = true;
+  } else if ( result == VK_SUBOPTIMAL_KHR ) {
+    resizePending_ = true;
   } else if ( result != VK_SUCCESS ) {
     Logger::log( "Failed to present swap chain image!", Logger::CRITICAL );
   }
+
+  currentFrame_ = ( currentFrame_ + 1 ) % maxFramesInFlight_;
+
+  record_frame_pacing( std::chrono::duration<double, std::chrono::milliseconds::period>(
+                           std::chrono::steady_clock::now() - frameStart )
+                           .count() );
+  return FRAME_DRAWN;
 }
 
-void VulkanRender::record_command_buffer( VkCommandBuffer commandBuffer, uint32_t imageIndex,
-                                          VulkanSwapChain *swapChain, VkBuffer vertexBuffer,
-                                          uint32_t vertexCoundeptht, VkBuffer indexBuffer,
-                                          uint32_t indexCount,
-                                          std::vector<VkDescriptorSet> descriptorSets ) {
+void VulkanRender::framebuffer_resized() {
+  resizePending_ = true;
+  lastResize_ = std::chrono::steady_clock::now();
+}
+
+void VulkanRender::record_command_buffer( const FrameContext &frame, uint32_t imageIndex,
+                                          const DrawList &drawList, VulkanImage *depthImage,
+                                          VulkanImage *colorImage ) {
+  VkCommandBuffer commandBuffer = frame.commandBuffer;
   VkCommandBufferBeginInfo beginInfo = Initializer::command_buffer_begin_info();
 
   if ( vkBeginCommandBuffer( commandBuffer, &beginInfo ) != VK_SUCCESS ) {
     Logger::log( "Failed to begin recording command buffer!", Logger::CRITICAL );
   }
 
+  uint32_t instanceCount = static_cast<uint32_t>( drawList.instances().size() );
+  if ( culling_->enabled() ) {
+    culling_->record_cull( commandBuffer, frame.index, instanceCount );
+  }
+
+  // Large draw lists are split across the recorder's threads
+  uint32_t commandCount = static_cast<uint32_t>( drawList.commands().size() );
+  bool parallel = recorder_->recorder_count( commandCount ) > 1;
+
+  if ( vulkanDevice_->dynamicRendering ) {
+    begin_rendering( commandBuffer, imageIndex, depthImage, colorImage, parallel );
+  } else {
+    begin_render_pass( commandBuffer, imageIndex, parallel );
+  }
+
+  if ( parallel ) {
+    VkFramebuffer framebuffer = vulkanDevice_->dynamicRendering
+                                    ? VK_NULL_HANDLE
+                                    : swapChain_->swapChainFramebuffers[imageIndex];
+    VkCommandBufferInheritanceInfo inheritance =
+        Initializer::command_buffer_inheritance_info( swapChain_->renderPass, framebuffer );
+    // Without a render pass the secondaries are told the attachment formats instead
+    VkCommandBufferInheritanceRenderingInfoKHR renderingInheritance =
+        Initializer::command_buffer_inheritance_rendering_info( &swapChain_->swapChainImageFormat,
+                                                                swapChain_->depthFormat,
+                                                                vulkanDevice_->msaaSamples );
+    if ( vulkanDevice_->dynamicRendering ) {
+      inheritance.pNext = &renderingInheritance;
+    }
+
+    recordingFrame_ = &frame;
+    recordingDrawList_ = &drawList;
+    uint32_t recorded = recorder_->record( frame.index, inheritance, commandCount );
+    vkCmdExecuteCommands( commandBuffer, recorded, recorder_->command_buffers( frame.index ) );
+  } else {
+    record_draw_state( commandBuffer, drawList );
+    record_draws( commandBuffer, frame, drawList, DrawRange{ 0, commandCount } );
+  }
+
+  if ( vulkanDevice_->dynamicRendering ) {
+    end_rendering( commandBuffer, imageIndex );
+  } else {
+    vkCmdEndRenderPass( commandBuffer );
+  }
+
+  // Next frame culls against this frame's depth
+  if ( culling_->enabled() ) {
+    culling_->record_depth_pyramid( commandBuffer );
+  }
+
+  if ( vkEndCommandBuffer( commandBuffer ) != VK_SUCCESS ) {
+    Logger::log( "Failed to record command buffer!", Logger::CRITICAL );
+  }
+}
+
+void VulkanRender::begin_render_pass( VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                                      bool secondary ) {
   VkRenderPassBeginInfo renderPassInfo = Initializer::render_pass_info(
-      swapChain->renderPass, swapChain->swapChainFramebuffers[imageIndex], swapChain->extent );
+      swapChain_->renderPass, swapChain_->swapChainFramebuffers[imageIndex], swapChain_->extent );
 
   std::array<VkClearValue, 2> clearValues{};
   clearValues[0].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
@@ -170,61 +326,238 @@ void VulkanRender::record_command_buffer( VkCommandBuffer commandBuffer, uint32_
   // renderPassInfo.clearValueCount = 1;
   // renderPassInfo.pClearValues = &clearColor;
 
-  vkCmdBeginRenderPass( commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE );
+  vkCmdBeginRenderPass( commandBuffer, &renderPassInfo,
+                        secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                  : VK_SUBPASS_CONTENTS_INLINE );
+}
+
+void VulkanRender::begin_rendering( VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                                    VulkanImage *depthImage, VulkanImage *colorImage,
+                                    bool secondary ) {
+  // Single sampled devices draw straight into the swap chain image
+  bool resolve = vulkanDevice_->msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+
+  // Every attachment is cleared, so previous contents are discarded with UNDEFINED. The source
+  // stages cover the image available wait, last frame's attachment writes & depth pyramid reads
+  std::array<VkImageMemoryBarrier, 3> barriers{};
+  barriers[0] = Initializer::image_memory_barrier( swapChain_->image( imageIndex ),
+                                                   VK_IMAGE_LAYOUT_UNDEFINED,
+                                                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 1 );
+  barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  barriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  barriers[1] = Initializer::image_memory_barrier(
+      depthImage->image, VK_IMAGE_LAYOUT_UNDEFINED,
+      VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 1 );
+  barriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+  if ( Image::has_stencil_component( swapChain_->depthFormat ) ) {
+    barriers[1].subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+  }
+  barriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  barriers[1].dstAccessMask =
+      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+  barriers[2] = Initializer::image_memory_barrier( colorImage->image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 1 );
+  barriers[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  barriers[2].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  vkCmdPipelineBarrier( commandBuffer,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        0, 0, nullptr, 0, nullptr, resolve ? 3 : 2, barriers.data() );
+
+  VkClearValue colorClear{};
+  colorClear.color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+  VkClearValue depthClear{};
+  depthClear.depthStencil = { 1.0f, 0 };
+
+  VkImageView swapChainView = swapChain_->swapChainImageViews[imageIndex];
+  VkRenderingAttachmentInfoKHR colorAttachment = Initializer::rendering_attachment_info(
+      resolve ? colorImage->imageView : swapChainView, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+      colorClear );
+  if ( resolve ) {
+    // Only the resolved image is kept
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+    colorAttachment.resolveImageView = swapChainView;
+    colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  }
+
+  VkRenderingAttachmentInfoKHR depthAttachment = Initializer::rendering_attachment_info(
+      depthImage->imageView, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthClear );
+  // Only stored when the culling pass builds its depth pyramid from it
+  if ( !swapChain_->depthStored ) {
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  }
+
+  VkRenderingInfoKHR renderingInfo =
+      Initializer::rendering_info( swapChain_->extent, &colorAttachment, &depthAttachment );
+  if ( secondary ) {
+    renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+  }
+  vulkanDevice_->cmdBeginRendering( commandBuffer, &renderingInfo );
+}
 
-  vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_->graphicsPipeline );
+void VulkanRender::end_rendering( VkCommandBuffer commandBuffer, uint32_t imageIndex ) {
+  vulkanDevice_->cmdEndRendering( commandBuffer );
+
+  VkImageMemoryBarrier present = Initializer::image_memory_barrier(
+      swapChain_->image( imageIndex ), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+      VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 1 );
+  present.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  present.dstAccessMask = 0;
+  vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                        &present );
+}
 
-  VkViewport viewport = Initializer::viewport( static_cast<float>( swapChain->extent.height ),
-                                               static_cast<float>( swapChain->extent.width ) );
+void VulkanRender::record_draw_state( VkCommandBuffer commandBuffer, const DrawList &drawList ) {
+  VkViewport viewport = Initializer::viewport( static_cast<float>( swapChain_->extent.height ),
+                                               static_cast<float>( swapChain_->extent.width ) );
   vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
 
-  VkRect2D scissor = Initializer::scissor( swapChain->extent );
+  VkRect2D scissor = Initializer::scissor( swapChain_->extent );
   // VkRect2D scissor{};
   // scissor.offset = {0, 0};
   // scissor.extent = swapChain->extent;
   vkCmdSetScissor( commandBuffer, 0, 1, &scissor );
 
-  VkBuffer vertexBuffers[] = { vertexBuffer };
-  VkDeviceSize offsets[] = { 0 };
-  vkCmdBindVertexBuffers( commandBuffer, 0, 1, vertexBuffers, offsets );
+  VkBuffer vertexBuffer = drawList.vertex_buffer();
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers( commandBuffer, 0, 1, &vertexBuffer, &offset );
 
-  vkCmdBindVertexBuffers( commandBuffer, 0, 1, vertexBuffers, offsets );
+  vkCmdBindIndexBuffer( commandBuffer, drawList.index_buffer(), 0, VK_INDEX_TYPE_UINT16 );
+}
 
-  // vkCmdDraw( commandBuffer, vertexCount, 1, 0, 0 );
+void VulkanRender::record_draws( VkCommandBuffer commandBuffer, const FrameContext &frame,
+                                 const DrawList &drawList, DrawRange range ) {
+  const uint32_t stride = sizeof( VkDrawIndexedIndirectCommand );
+  VulkanPipeline *boundPipeline = nullptr;
+  uint32_t rangeEnd = range.firstCommand + range.commandCount;
+
+  for ( const DrawBatch &batch : drawList.batches() ) {
+    // Only the part of the batch inside the range
+    uint32_t firstCommand = std::max( batch.firstCommand, range.firstCommand );
+    uint32_t lastCommand = std::min( batch.firstCommand + batch.commandCount, rangeEnd );
+    if ( firstCommand >= lastCommand ) {
+      continue;
+    }
+    uint32_t commandCount = lastCommand - firstCommand;
+
+    VulkanPipeline *pipeline = batch.pipeline != nullptr ? batch.pipeline : pipeline_;
+    if ( pipeline != boundPipeline ) {
+      vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                         pipeline->graphicsPipeline );
+      vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                               pipeline->pipelineLayout, 0, 1, &frame.descriptorSet,
+                               static_cast<uint32_t>( frame.dynamicOffsets.size() ),
+                               frame.dynamicOffsets.data() );
+      boundPipeline = pipeline;
+    }
 
-  vkCmdBindIndexBuffer( commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16 );
+    // Ids that were never registered draw with the default material
+    DrawConstants constants{};
+    constants.material = batch.material < drawList.materials().size() ? batch.material : 0;
+    vkCmdPushConstants( commandBuffer, pipeline->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                        sizeof( constants ), &constants );
+
+    VkDeviceSize offset = static_cast<VkDeviceSize>( firstCommand ) * stride;
+    if ( vulkanDevice_->multiDrawIndirect && vulkanDevice_->drawIndirectFirstInstance ) {
+      // Whole batch in one call
+      vkCmdDrawIndexedIndirect( commandBuffer, frame.indirectBuffer, offset, commandCount, stride );
+    } else if ( vulkanDevice_->drawIndirectFirstInstance ) {
+      for ( uint32_t i = 0; i < commandCount; i++ ) {
+        vkCmdDrawIndexedIndirect( commandBuffer, frame.indirectBuffer, offset + i * stride, 1,
+                                  stride );
+      }
+    } else {
+      // Indirect draws can't offset gl_InstanceIndex, draw each mesh directly
+      for ( uint32_t i = 0; i < commandCount; i++ ) {
+        const VkDrawIndexedIndirectCommand &command = drawList.commands()[firstCommand + i];
+        vkCmdDrawIndexed( commandBuffer, command.indexCount, command.instanceCount,
+                          command.firstIndex, command.vertexOffset, command.firstInstance );
+      }
+    }
+  }
+}
 
-  vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                           pipeline_->pipelineLayout, 0, 1, &descriptorSets[currentFrame_], 0,
-                           nullptr );
+void VulkanRender::record_frame_pacing( double cpuMilliseconds ) {
+  pacing_.frames++;
+  pacing_.cpuMilliseconds += cpuMilliseconds;
+}
 
-  vkCmdDrawIndexed( commandBuffer, indexCount, 1, 0, 0, 0 );
-  vkCmdEndRenderPass( commandBuffer );
+void VulkanRender::report_frame_pacing() {
+  auto now = std::chrono::steady_clock::now();
+  if ( now - pacing_.windowStart < FRAME_PACING_INTERVAL ) {
+    return;
+  }
 
-  if ( vkEndCommandBuffer( commandBuffer ) != VK_SUCCESS ) {
-    Logger::log( "Failed to record command buffer!", Logger::CRITICAL );
+  double seconds = std::chrono::duration<double>( now - pacing_.windowStart ).count();
+  double latency = pacing_.latencySamples > 0
+                       ? pacing_.latencyMilliseconds / static_cast<double>( pacing_.latencySamples )
+                       : 0.0;
+  THUMPY_LOG_CHANNEL( renderChannel, Logger::INFO, maxFramesInFlight_, " frames in flight: ",
+                      static_cast<double>( pacing_.frames ) / seconds, " fps, cpu ",
+                      pacing_.cpuMilliseconds / static_cast<double>( pacing_.frames ),
+                      presentTimer_->enabled() ? " ms/frame, input to present "
+                                               : " ms/frame, input to GPU done ",
+                      latency, " ms" );
+  if ( culling_->enabled() ) {
+    const CullingStats &stats = culling_->stats();
+    THUMPY_LOG_CHANNEL( renderChannel, Logger::INFO, "Culling: ", stats.tested, " tested, ",
+                        stats.frustumCulled, " frustum culled, ", stats.occlusionCulled,
+                        " occlusion culled" );
   }
+  MemoryStats memory = vulkanDevice_->allocator->stats();
+  THUMPY_LOG_CHANNEL( renderChannel, Logger::INFO, "Memory: ", memory.allocations,
+                      " allocations in ", memory.device_memory_count(), " device allocations, ",
+                      memory.used / ( 1024 * 1024 ), " / ", memory.reserved / ( 1024 * 1024 ),
+                      " MB, ", memory.lazilyAllocated / ( 1024 * 1024 ), " MB lazy" );
+  pacing_ = FramePacing();
 }
 
-void VulkanRender::update_uniform_buffer( uint32_t currentImage,
-                                          std::vector<void *> uniformBuffersMapped ) {
-  static auto startTime = std::chrono::high_resolution_clock::now();
+void VulkanRender::reset_images_in_flight() {
+  imagesInFlight_.assign( swapChain_->swapChainImageViews.size(), 0 );
+}
 
-  auto currentTime = std::chrono::high_resolution_clock::now();
-  float run_time =
-      std::chrono::duration<float, std::chrono::seconds::period>( currentTime - startTime ).count();
-  // Logger::log( "Run time: " + std::to_string( run_time ), Logger::DEBUG );
+bool VulkanRender::recreate_swap_chain( VulkanImage *depthImage, VulkanImage *colorImage ) {
+  // Every submission so far may still be using the old swap chain images & attachments
+  uint64_t lastUse = vulkanDevice_->timeline->submitted_value();
+  presentTimer_->retire();
+  if ( !swapChain_->recreate_swap_chain( depthImage, colorImage, lastUse ) ) {
+    return false;
+  }
 
-  UniformBufferObject ubo{};
-  ubo.model = glm::rotate( glm::mat4( 1.0f ), run_time * glm::radians( 90.0f ),
-                           glm::vec3( 0.0f, 0.0f, 1.0f ) );
-  ubo.view = glm::lookAt( glm::vec3( 2.0f, 2.0f, 2.0f ), glm::vec3( 0.0f, 0.0f, 0.0f ),
-                          glm::vec3( 0.0f, 0.0f, 1.0f ) );
-  ubo.proj =
+  resizePending_ = false;
+  swapChainOutOfDate_ = false;
+  reset_images_in_flight();
+  culling_->resize( swapChain_->extent, lastUse );
+  return true;
+}
+
+CameraData VulkanRender::update_camera( FrameContext &frame, const DrawList &drawList ) {
+  CameraData camera{};
+  camera.view = glm::lookAt( glm::vec3( 2.0f, 2.0f, 2.0f ), glm::vec3( 0.0f, 0.0f, 0.0f ),
+                             glm::vec3( 0.0f, 0.0f, 1.0f ) );
+  camera.proj =
       glm::perspective( glm::radians( 45.0f ),
                         swapChain_->extent.width / (float)swapChain_->extent.height, 0.1f, 10.0f );
-  ubo.proj[1][1] *= -1;
-  memcpy( uniformBuffersMapped[currentImage], &ubo, sizeof( ubo ) );
+  camera.proj[1][1] *= -1;
+
+  // Only the registered materials are copied, no draw indexes past them
+  const std::vector<glm::vec4> &materials = drawList.materials();
+  std::copy( materials.begin(), materials.end(), camera.materials );
+
+  FrameAllocation allocation = frameAllocator_->allocate_uniform( frame.index, sizeof( camera ) );
+  memcpy( allocation.mapped, &camera,
+          offsetof( CameraData, materials ) + materials.size() * sizeof( glm::vec4 ) );
+  frame.dynamicOffsets[0] = static_cast<uint32_t>( allocation.offset );
+  return camera;
 }
 
 }  // namespace Vulkan
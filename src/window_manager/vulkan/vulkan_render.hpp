@@ -13,30 +13,91 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <chrono>
 #include <vector>
 
+#include "vulkan_construct.hpp"
+#include "vulkan_culling.hpp"
 #include "vulkan_device.hpp"
+#include "vulkan_draw_list.hpp"
+#include "vulkan_frame_allocator.hpp"
 #include "vulkan_helper.hpp"
 #include "vulkan_pipeline.hpp"
+#include "vulkan_present_timer.hpp"
+#include "vulkan_recorder.hpp"
 #include "vulkan_swap_chain.hpp"
 
 namespace Thumpy {
 namespace Core {
 namespace Windows {
 namespace Vulkan {
+
+// How often frame pacing is written to the Vulkan::Render channel
+const std::chrono::seconds FRAME_PACING_INTERVAL{ 5 };
+
+// How long resize events have to stop before a suboptimal swap chain is recreated, so dragging a
+// window edge recreates once instead of every frame. Out of date swap chains are always recreated
+const std::chrono::milliseconds RESIZE_SETTLE_TIME{ 50 };
+
+// What draw_frame did. A frame is skipped when the swap chain went out of date on acquire, it's
+// recreated and the next frame draws
+enum FrameResult { FRAME_DRAWN, FRAME_SKIPPED, FRAME_MINIMIZED };
+
+/**
+ * @brief Frame pacing accumulated since the last report
+ * Latency is measured from the start of draw_frame, right after input was polled, to when the
+ * frame is on screen, so it grows with every extra frame in flight. Devices without present
+ * wait measure to when the CPU sees the frame finished on the timeline instead.
+ */
+struct FramePacing {
+  uint64_t frames = 0;
+  uint64_t latencySamples = 0;
+  double cpuMilliseconds = 0.0;
+  double latencyMilliseconds = 0.0;
+  std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+};
+
+/**
+ * @brief Everything one frame in flight owns, created once and reused every time the slot
+ * comes around
+ */
+struct FrameContext {
+  uint32_t index = 0;
+  VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+  VkSemaphore imageAvailable = VK_NULL_HANDLE;
+  VkSemaphore renderFinished = VK_NULL_HANDLE;
+  // Device timeline value of the last submission from this slot, 0 before the first
+  uint64_t timelineValue = 0;
+  // Frame allocator offsets of the camera & instances, bound as dynamic offsets
+  std::array<uint32_t, 2> dynamicOffsets{};
+  // Draw list indirect commands are copied here each frame
+  VkBuffer indirectBuffer = VK_NULL_HANDLE;
+  void *indirectMapped = nullptr;
+  VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+  std::chrono::steady_clock::time_point startTime;
+};
+
 class VulkanRender {
  public:
   /**
    * @brief Construct and setup a new Vulkan Render object.
-   *
-   * @param max_frames_in_flight
+   * Takes one command buffer, draw buffers & descriptor set per frame in flight.
+   * @param maxFramesInFlight
    * @param vulkanDevice
    * @param swapchain
    * @param commandBuffers
-   * @param pipeline
+   * @param frameAllocator camera, instances & bounds are allocated from it each frame
+   * @param drawBuffers
+   * @param descriptorSets
+   * @param pipeline default pipeline for draw batches without one
+   * @param culling culling pass over the same draw buffers
    */
   VulkanRender( int maxFramesInFlight, VulkanDevice *vulkanDevice, VulkanSwapChain *swapchain,
-                std::vector<VkCommandBuffer> *commandBuffers, VulkanPipeline *pipeline );
+                const std::vector<VkCommandBuffer> &commandBuffers,
+                FrameAllocator *frameAllocator, const Construct::DrawBuffers &drawBuffers,
+                const std::vector<VkDescriptorSet> &descriptorSets, VulkanPipeline *pipeline,
+                VulkanCulling *culling );
 
   /**
    * @brief Destroy render
@@ -48,37 +109,167 @@ class VulkanRender {
 
   /**
    * @brief Draw to frame
+   * Only waits on the frame slot being reused, so recording this frame overlaps the GPU executing
+   * the previous ones. Does not touch the heap unless the swap chain has to be recreated.
+   * @return FrameResult FRAME_DRAWN if a frame was submitted & presented
+   */
+  FrameResult draw_frame( const DrawList &drawList, VulkanImage *depthImage,
+                          VulkanImage *colorImage );
+
+  /**
+   * @brief Note a window resize, the swap chain is recreated once the events settle
    *
    */
-  void draw_frame( VkBuffer vertexBuffer, uint32_t vertexCount, VkBuffer indexBuffer,
-                   uint32_t indexCount, std::vector<void *> uniformBuffersMapped,
-                   std::vector<VkDescriptorSet> descriptorSets, VulkanImage *depthImage,
-                   VulkanImage *colorImage );
+  void framebuffer_resized();
 
-  void record_command_buffer( VkCommandBuffer commandBuffer, uint32_t imageIndex,
-                              VulkanSwapChain *swapChain, VkBuffer vertexBuffer,
-                              uint32_t vertexCount, VkBuffer indexBuffer, uint32_t indexCount,
-                              std::vector<VkDescriptorSet> descriptorSets );
+  /**
+   * @brief Record the frame, inside a render pass or with dynamic rendering when the device
+   * supports it
+   * @param frame
+   * @param imageIndex swap chain image to render to
+   * @param drawList
+   * @param depthImage
+   * @param colorImage multisampled color, resolved into the swap chain image
+   */
+  void record_command_buffer( const FrameContext &frame, uint32_t imageIndex,
+                              const DrawList &drawList, VulkanImage *depthImage,
+                              VulkanImage *colorImage );
+
+  /**
+   * @brief Record a range of the draw list's commands, one multi-draw indirect call per batch
+   * when supported. Each batch's material index is pushed as a constant, not bound through
+   * a descriptor. Only reads, so ranges can be recorded from several threads at once.
+   * @param commandBuffer
+   * @param frame
+   * @param drawList
+   * @param range
+   */
+  void record_draws( VkCommandBuffer commandBuffer, const FrameContext &frame,
+                     const DrawList &drawList, DrawRange range );
+
+  /**
+   * @brief Allocate & write the frame's camera and the draw list's material colors
+   *
+   * @param frame its camera dynamic offset is set
+   * @param drawList
+   * @return CameraData what was written
+   */
+  CameraData update_camera( FrameContext &frame, const DrawList &drawList );
 
-  void update_uniform_buffer( uint32_t currentImage, std::vector<void *> uniformBuffersMapped );
+  int frames_in_flight() const { return maxFramesInFlight_; }
+
+  /**
+   * @brief Culling stats of the last frame the GPU finished
+   *
+   * @return const CullingStats&
+   */
+  const CullingStats &culling_stats() const { return culling_->stats(); }
+
+  /**
+   * @brief Log & reset the pacing stats once FRAME_PACING_INTERVAL has passed. Kept out of
+   * draw_frame since building the log lines allocates
+   */
+  void report_frame_pacing();
+
+  /**
+   * @brief Pacing since the last report, latency of the newest presents is still pending
+   *
+   * @return const FramePacing&
+   */
+  const FramePacing &frame_pacing() const { return pacing_; }
+
+  /**
+   * @brief If latency is measured up to present
+   *
+   * @return bool
+   */
+  bool times_present() const { return presentTimer_->enabled(); }
 
  protected:
+  /**
+   * @brief Add a frame to the pacing stats
+   *
+   * @param cpuMilliseconds
+   */
+  void record_frame_pacing( double cpuMilliseconds );
+
+  /**
+   * @brief Forget which frames own swap chain images, after the swap chain is recreated
+   *
+   */
+  void reset_images_in_flight();
+
+  /**
+   * @brief Recreate the swap chain & everything sized to it, without waiting on the device.
+   * The old objects are released once the newest submission finished.
+   * @param depthImage
+   * @param colorImage
+   * @return false if the window is minimized
+   */
+  bool recreate_swap_chain( VulkanImage *depthImage, VulkanImage *colorImage );
+
+  /**
+   * @brief Set the viewport & scissor and bind the draw list's geometry, a secondary command
+   * buffer inherits none of it
+   * @param commandBuffer
+   * @param drawList
+   */
+  void record_draw_state( VkCommandBuffer commandBuffer, const DrawList &drawList );
+
+  /**
+   * @brief Begin the swap chain render pass on the image's framebuffer
+   *
+   * @param commandBuffer
+   * @param imageIndex
+   * @param secondary draws are recorded into secondary command buffers
+   */
+  void begin_render_pass( VkCommandBuffer commandBuffer, uint32_t imageIndex, bool secondary );
+
+  /**
+   * @brief Transition the attachments & begin dynamic rendering into the swap chain image, the
+   * barriers a render pass would add itself are recorded explicitly
+   * @param commandBuffer
+   * @param imageIndex
+   * @param depthImage
+   * @param colorImage
+   * @param secondary draws are recorded into secondary command buffers
+   */
+  void begin_rendering( VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                        VulkanImage *depthImage, VulkanImage *colorImage, bool secondary );
+
+  /**
+   * @brief End dynamic rendering & transition the swap chain image for present
+   *
+   * @param commandBuffer
+   * @param imageIndex
+   */
+  void end_rendering( VkCommandBuffer commandBuffer, uint32_t imageIndex );
+
   int maxFramesInFlight_;
   uint32_t currentFrame_ = 0;
 
   VulkanDevice *vulkanDevice_;
   VulkanSwapChain *swapChain_;
   VulkanPipeline *pipeline_;
-  bool framebufferResized_;
+  VulkanCulling *culling_;
+  VulkanRecorder *recorder_;
+  PresentTimer *presentTimer_;
+  FrameAllocator *frameAllocator_;
+  // Recreate once resizing settles
+  bool resizePending_ = false;
+  // Recreate before the next acquire
+  bool swapChainOutOfDate_ = false;
+  std::chrono::steady_clock::time_point lastResize_;
 
-  std::vector<VkCommandBuffer> commandBuffers_;
+  std::vector<FrameContext> frames_;
+  // Timeline value of the frame last rendered to each swap chain image
+  std::vector<uint64_t> imagesInFlight_;
 
-  std::vector<VkSemaphore> imageAvailableSemaphores_;
-  std::vector<VkSemaphore> renderFinishedSemaphores_;
-  std::vector<VkFence> inFlightFences_;
+  FramePacing pacing_;
 
-  VkSemaphore imageAvailableSemaphore_;
-  VkSemaphore renderFinishedSemaphore_;
+  // What the recorder's threads are recording, set before each parallel record
+  const FrameContext *recordingFrame_ = nullptr;
+  const DrawList *recordingDrawList_ = nullptr;
 };
 }  // namespace Vulkan
 }  // namespace Windows
@@ -16,8 +16,10 @@
 #include <algorithm>  // Necessary for std::clamp
 #include <limits>
 
+#include "channel.hpp"
 #include "logger.hpp"
 #include "vulkan_buffers.hpp"
+#include "vulkan_deletion_queue.hpp"
 #include "vulkan_image.hpp"
 
 namespace Thumpy {
@@ -25,17 +27,22 @@ namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+namespace {
+Logger::Channel &swapChainChannel = Logger::get_channel( "Vulkan::SwapChain" );
+}  // namespace
+
 VulkanSwapChain::VulkanSwapChain( VulkanDevice *vulkanDevice, GLFWwindow *window,
                                   VkSurfaceKHR surface ) {
   vulkanDevice_ = vulkanDevice;
   surface_ = surface;
   window_ = window;
+  depthFormat = Image::find_depth_format( vulkanDevice_->physicalDevice );
   create_swap_chain();
   create_image_views();
   create_render_pass();
 }
 
-void VulkanSwapChain::create_swap_chain() {
+void VulkanSwapChain::create_swap_chain( VkSwapchainKHR oldSwapChain ) {
   SwapChainSupportDetails swapChainSupport = query_swap_chain_support();
 
   VkSurfaceFormatKHR surfaceFormat = choose_swap_surface_format( swapChainSupport.formats );
@@ -75,7 +82,8 @@ void VulkanSwapChain::create_swap_chain() {
   createInfo.presentMode = presentMode;
   createInfo.clipped = VK_TRUE;
 
-  createInfo.oldSwapchain = VK_NULL_HANDLE;
+  // Lets the driver reuse the old swap chain's resources, its acquired images stay presentable
+  createInfo.oldSwapchain = oldSwapChain;
 
   if ( vkCreateSwapchainKHR( vulkanDevice_->device, &createInfo, nullptr, &swapChain ) !=
        VK_SUCCESS ) {
@@ -90,27 +98,37 @@ void VulkanSwapChain::create_swap_chain() {
   extent = chosen_extent;
 }
 
-void VulkanSwapChain::recreate_swap_chain( VulkanImage *depthImage, VulkanImage *colorImage ) {
-  Logger::log( "Recreating swap chain...", Logger::INFO );
-  int width = 0, height = 0;
-  glfwGetFramebufferSize( window_, &width, &height );
-  while ( width == 0 || height == 0 ) {
-    glfwGetFramebufferSize( window_, &width, &height );
-    glfwWaitEvents();
+bool VulkanSwapChain::recreate_swap_chain( VulkanImage *depthImage, VulkanImage *colorImage,
+                                           uint64_t timelineValue ) {
+  // Nothing to render to, the caller tries again next frame instead of blocking here
+  if ( minimized() ) {
+    return false;
   }
+  THUMPY_LOG_CHANNEL( swapChainChannel, Logger::INFO, "Recreating swap chain..." );
 
-  vkDeviceWaitIdle( vulkanDevice_->device );
-
-  clear_swap_chain();
-  depthImage->destroy( vulkanDevice_->device );
-  colorImage->destroy( vulkanDevice_->device );
-
-  create_swap_chain();
+  // Frames still in flight keep rendering to & presenting the old objects
+  DeletionQueue *deletionQueue = vulkanDevice_->deletionQueue;
+  for ( auto framebuffer : swapChainFramebuffers ) {
+    deletionQueue->push( framebuffer, timelineValue );
+  }
+  for ( auto imageView : swapChainImageViews ) {
+    deletionQueue->push( imageView, timelineValue );
+  }
+  depthImage->reset( timelineValue );
+  colorImage->reset( timelineValue );
+  swapChainImageViews.clear();
+  swapChainFramebuffers.clear();
+
+  // Queued before it's handed over, only destroyed once the new one exists
+  VkSwapchainKHR oldSwapChain = swapChain;
+  deletionQueue->push( oldSwapChain, timelineValue );
+  create_swap_chain( oldSwapChain );
   create_image_views();
   Image::create_color_resources( colorImage, vulkanDevice_, this );
-  Image::create_depth_resources( depthImage, vulkanDevice_, extent );
+  Image::create_depth_resources( depthImage, vulkanDevice_, extent, depthStored );
   Buffer::create_framebuffers( this, depthImage->imageView, colorImage->imageView,
                                vulkanDevice_->device );
+  return true;
 }
 
 void VulkanSwapChain::clear_swap_chain() {
@@ -125,6 +143,12 @@ void VulkanSwapChain::clear_swap_chain() {
   vkDestroySwapchainKHR( vulkanDevice_->device, swapChain, nullptr );
 }
 
+bool VulkanSwapChain::minimized() const {
+  int width = 0, height = 0;
+  glfwGetFramebufferSize( window_, &width, &height );
+  return width == 0 || height == 0;
+}
+
 SwapChainSupportDetails VulkanSwapChain::query_swap_chain_support() {
   SwapChainSupportDetails details;
 
@@ -228,13 +252,32 @@ void VulkanSwapChain::create_image_views() {
 //   }
 // }
 
+void VulkanSwapChain::set_depth_stored( bool stored ) {
+  if ( stored == depthStored ) {
+    return;
+  }
+  depthStored = stored;
+
+  // Store ops aren't part of render pass compatibility, pipelines made against the old one work
+  if ( renderPass != VK_NULL_HANDLE ) {
+    vkDestroyRenderPass( vulkanDevice_->device, renderPass, nullptr );
+    renderPass = VK_NULL_HANDLE;
+    create_render_pass();
+  }
+}
+
 void VulkanSwapChain::create_render_pass() {
+  if ( vulkanDevice_->dynamicRendering ) {
+    return;
+  }
+
   // ### color ###
   VkAttachmentDescription colorAttachment{};
   colorAttachment.format = swapChainImageFormat;
   colorAttachment.samples = vulkanDevice_->msaaSamples;
   colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-  colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  // Only the resolve attachment is kept, the samples never leave tile memory
+  colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -246,10 +289,12 @@ void VulkanSwapChain::create_render_pass() {
 
   // ### depth buffer ###
   VkAttachmentDescription depthAttachment{};
-  depthAttachment.format = Image::find_depth_format( vulkanDevice_->physicalDevice );
+  depthAttachment.format = depthFormat;
   depthAttachment.samples = vulkanDevice_->msaaSamples;
   depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-  depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  // Kept only when the culling pass builds its depth pyramid from it
+  depthAttachment.storeOp =
+      depthStored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
   depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -14,6 +14,7 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <vector>
 
 #include "vulkan_device.hpp"
@@ -30,17 +31,30 @@ class VulkanSwapChain {
 
   /**
    * @brief Create swap chain
+   * @param oldSwapChain swap chain being replaced, VK_NULL_HANDLE for the first one
    */
-  void create_swap_chain();
+  void create_swap_chain( VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE );
   /**
-   * @brief Recreate swap chain
+   * @brief Recreate swap chain without waiting for the device. The old swap chain is handed to
+   * the new one & queued for deletion with its image views, framebuffers & attachments.
+   * @param depthImage rebuilt in place
+   * @param colorImage rebuilt in place
+   * @param timelineValue last submission that may use the old objects
+   * @return false if the window is minimized, nothing is recreated
    */
-  void recreate_swap_chain( VulkanImage *depthImage, VulkanImage *colorImage );
+  bool recreate_swap_chain( VulkanImage *depthImage, VulkanImage *colorImage,
+                            uint64_t timelineValue );
   /**
-   * @brief Clear the swap chain
+   * @brief Clear the swap chain, the device has to be idle
    */
   void clear_swap_chain();
 
+  /**
+   * @brief Check if the window's framebuffer has no area, e.g. while minimized
+   * @return bool
+   */
+  bool minimized() const;
+
   /**
    * @brief Get swap chain details
    * @return SwapChainSupportDetails
@@ -74,14 +88,30 @@ class VulkanSwapChain {
 
   void create_image_views();
   //   void create_framebuffers();
+  /**
+   * @brief Create the render pass, left VK_NULL_HANDLE when the device renders dynamically
+   */
   void create_render_pass();
 
+  /**
+   * @brief Keep or discard depth at the end of the pass, recreates the render pass. Call before
+   * the framebuffers are created
+   * @param stored
+   */
+  void set_depth_stored( bool stored );
+
+  VkImage image( uint32_t index ) const { return swapChainImages_[index]; }
+
  public:
   VkSwapchainKHR swapChain;
 
   VkFormat swapChainImageFormat;
+  VkFormat depthFormat;
+  // Set once the culling pass loaded its depth pyramid pipelines, depth is discarded at the end
+  // of the pass otherwise
+  bool depthStored = false;
   VkExtent2D extent;
-  VkRenderPass renderPass;
+  VkRenderPass renderPass = VK_NULL_HANDLE;
 
   std::vector<VkImageView> swapChainImageViews;
   std::vector<VkFramebuffer> swapChainFramebuffers;
@@ -0,0 +1,197 @@
+/**
+ * @file vulkan_timeline.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_timeline cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_timeline.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+
+#include "logger.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_initializers.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+// Binary semaphores a submission may signal besides the timeline
+const uint32_t MAX_SIGNAL_SEMAPHORES = 8;
+
+}  // namespace
+
+VulkanTimeline::VulkanTimeline( VulkanDevice *vulkanDevice ) : vulkanDevice_( vulkanDevice ) {
+  if ( !vulkanDevice_->timelineSemaphores ) {
+    Logger::log( "Timeline semaphores unsupported, falling back to fences", Logger::WARNING );
+    return;
+  }
+
+  VkSemaphoreTypeCreateInfo typeInfo{};
+  typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  typeInfo.initialValue = 0;
+
+  VkSemaphoreCreateInfo semaphoreInfo = Initializer::semaphore_info();
+  semaphoreInfo.pNext = &typeInfo;
+
+  if ( vkCreateSemaphore( vulkanDevice_->device, &semaphoreInfo, nullptr, &semaphore_ ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to create timeline semaphore!", Logger::CRITICAL );
+  }
+}
+
+void VulkanTimeline::destroy() {
+  if ( semaphore_ != VK_NULL_HANDLE ) {
+    vkDestroySemaphore( vulkanDevice_->device, semaphore_, nullptr );
+    semaphore_ = VK_NULL_HANDLE;
+  }
+
+  for ( PendingFence &pending : pendingFences_ ) {
+    vkDestroyFence( vulkanDevice_->device, pending.fence, nullptr );
+  }
+  pendingFences_.clear();
+  for ( VkFence fence : freeFences_ ) {
+    vkDestroyFence( vulkanDevice_->device, fence, nullptr );
+  }
+  freeFences_.clear();
+}
+
+uint64_t VulkanTimeline::submit( VkQueue queue, const VkSubmitInfo &submitInfo,
+                                 const uint64_t *waitValues ) {
+  uint64_t value = submitted_ + 1;
+  VkSubmitInfo info = submitInfo;
+
+  if ( semaphore_ == VK_NULL_HANDLE ) {
+    VkFence fence = acquire_fence();
+    if ( vkQueueSubmit( queue, 1, &info, fence ) != VK_SUCCESS ) {
+      Logger::log( "Failed to submit to queue!", Logger::CRITICAL );
+    }
+    pendingFences_.push_back( PendingFence{ value, fence } );
+    submitted_ = value;
+    return value;
+  }
+
+  if ( submitInfo.signalSemaphoreCount >= MAX_SIGNAL_SEMAPHORES ) {
+    Logger::log( "Too many signal semaphores for one submission!", Logger::CRITICAL );
+  }
+
+  // Binary semaphores ignore their value, the timeline goes last
+  std::array<VkSemaphore, MAX_SIGNAL_SEMAPHORES> signalSemaphores{};
+  std::array<uint64_t, MAX_SIGNAL_SEMAPHORES> signalValues{};
+  for ( uint32_t i = 0; i < submitInfo.signalSemaphoreCount; i++ ) {
+    signalSemaphores[i] = submitInfo.pSignalSemaphores[i];
+  }
+  signalSemaphores[submitInfo.signalSemaphoreCount] = semaphore_;
+  signalValues[submitInfo.signalSemaphoreCount] = value;
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.pNext = submitInfo.pNext;
+  timelineInfo.signalSemaphoreValueCount = submitInfo.signalSemaphoreCount + 1;
+  timelineInfo.pSignalSemaphoreValues = signalValues.data();
+  if ( waitValues != nullptr ) {
+    timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+  }
+
+  info.pNext = &timelineInfo;
+  info.signalSemaphoreCount = submitInfo.signalSemaphoreCount + 1;
+  info.pSignalSemaphores = signalSemaphores.data();
+
+  if ( vkQueueSubmit( queue, 1, &info, VK_NULL_HANDLE ) != VK_SUCCESS ) {
+    Logger::log( "Failed to submit to queue!", Logger::CRITICAL );
+  }
+  submitted_ = value;
+  return value;
+}
+
+bool VulkanTimeline::is_complete( uint64_t value ) {
+  if ( value <= completed_ ) {
+    return true;
+  }
+  return completed_value() >= value;
+}
+
+void VulkanTimeline::wait( uint64_t value ) {
+  if ( value <= completed_ ) {
+    return;
+  }
+
+  if ( semaphore_ == VK_NULL_HANDLE ) {
+    retire_fences( true, value );
+    return;
+  }
+
+  VkSemaphoreWaitInfo waitInfo{};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &semaphore_;
+  waitInfo.pValues = &value;
+
+  if ( vkWaitSemaphores( vulkanDevice_->device, &waitInfo, UINT64_MAX ) != VK_SUCCESS ) {
+    Logger::log( "Failed to wait on timeline semaphore!", Logger::CRITICAL );
+  }
+  completed_ = value > completed_ ? value : completed_;
+}
+
+uint64_t VulkanTimeline::completed_value() {
+  if ( semaphore_ == VK_NULL_HANDLE ) {
+    retire_fences( false, submitted_ );
+    return completed_;
+  }
+
+  uint64_t value = 0;
+  vkGetSemaphoreCounterValue( vulkanDevice_->device, semaphore_, &value );
+  completed_ = value > completed_ ? value : completed_;
+  return completed_;
+}
+
+VkFence VulkanTimeline::acquire_fence() {
+  if ( !freeFences_.empty() ) {
+    VkFence fence = freeFences_.back();
+    freeFences_.pop_back();
+    vkResetFences( vulkanDevice_->device, 1, &fence );
+    return fence;
+  }
+
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  VkFence fence;
+  if ( vkCreateFence( vulkanDevice_->device, &fenceInfo, nullptr, &fence ) != VK_SUCCESS ) {
+    Logger::log( "Failed to create fence!", Logger::CRITICAL );
+  }
+  return fence;
+}
+
+void VulkanTimeline::retire_fences( bool wait, uint64_t value ) {
+  // Queue submissions finish in order, so stop at the first one still running
+  size_t retired = 0;
+  for ( ; retired < pendingFences_.size() && pendingFences_[retired].value <= value; retired++ ) {
+    PendingFence &pending = pendingFences_[retired];
+    if ( wait ) {
+      vkWaitForFences( vulkanDevice_->device, 1, &pending.fence, VK_TRUE, UINT64_MAX );
+    } else if ( vkGetFenceStatus( vulkanDevice_->device, pending.fence ) != VK_SUCCESS ) {
+      break;
+    }
+    completed_ = pending.value;
+    freeFences_.push_back( pending.fence );
+  }
+  pendingFences_.erase( pendingFences_.begin(), pendingFences_.begin() + retired );
+}
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
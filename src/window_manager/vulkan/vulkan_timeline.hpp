@@ -0,0 +1,114 @@
+/**
+ * @file vulkan_timeline.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief One GPU timeline that frames, uploads & deferred destruction wait on by value
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+class VulkanDevice;
+
+/**
+ * @brief Monotonic counter the GPU advances as submissions finish.
+ * Built on a VK_KHR_timeline_semaphore, falls back to a fence per submission on devices without
+ * it. Not thread safe, submit from the render thread.
+ */
+class VulkanTimeline {
+ public:
+  VulkanTimeline( VulkanDevice *vulkanDevice );
+
+  /**
+   * @brief Destroy the semaphore & fences, the device has to be idle
+   *
+   */
+  void destroy();
+
+  /**
+   * @brief Submit to a queue and signal the next timeline value once it finishes
+   * Any binary semaphores in submitInfo are kept, e.g. for the swap chain.
+   * @param queue
+   * @param submitInfo
+   * @param waitValues one per wait semaphore when waiting on another timeline, binary
+   * semaphores ignore theirs. Needs timeline semaphores
+   * @return uint64_t value to wait on for this submission
+   */
+  uint64_t submit( VkQueue queue, const VkSubmitInfo &submitInfo,
+                   const uint64_t *waitValues = nullptr );
+
+  /**
+   * @brief Check if the GPU has reached value, never blocks
+   *
+   * @param value
+   * @return bool
+   */
+  bool is_complete( uint64_t value );
+
+  /**
+   * @brief Block until the GPU has reached value
+   *
+   * @param value
+   */
+  void wait( uint64_t value );
+
+  /**
+   * @brief Highest value the GPU has finished
+   *
+   * @return uint64_t
+   */
+  uint64_t completed_value();
+
+  /**
+   * @brief Value of the newest submission
+   *
+   * @return uint64_t
+   */
+  uint64_t submitted_value() const { return submitted_; }
+
+  bool uses_timeline_semaphore() const { return semaphore_ != VK_NULL_HANDLE; }
+
+  /**
+   * @brief The timeline semaphore, for other queues to wait on
+   *
+   * @return VkSemaphore VK_NULL_HANDLE with the fence fallback
+   */
+  VkSemaphore semaphore() const { return semaphore_; }
+
+ private:
+  struct PendingFence {
+    uint64_t value;
+    VkFence fence;
+  };
+
+  VkFence acquire_fence();
+  void retire_fences( bool wait, uint64_t value );
+
+  VulkanDevice *vulkanDevice_;
+  VkSemaphore semaphore_ = VK_NULL_HANDLE;
+
+  uint64_t submitted_ = 0;
+  uint64_t completed_ = 0;
+
+  // Fence fallback, submissions oldest first. Vectors so steady state never allocates
+  std::vector<PendingFence> pendingFences_;
+  std::vector<VkFence> freeFences_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
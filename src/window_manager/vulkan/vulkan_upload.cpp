@@ -0,0 +1,338 @@
+/**
+ * @file vulkan_upload.cpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief vulkan_upload cpp file
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "vulkan_upload.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "channel.hpp"
+#include "logger.hpp"
+#include "vulkan_deletion_queue.hpp"
+#include "vulkan_image.hpp"
+#include "vulkan_initializers.hpp"
+#include "vulkan_timeline.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+namespace {
+
+Logger::Channel &uploadChannel = Logger::get_channel( "Vulkan::Upload" );
+
+}  // namespace
+
+#pragma region Staging ring
+
+bool StagingRing::allocate( VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset ) {
+  VkDeviceSize start = ( head_ + alignment - 1 ) & ~( alignment - 1 );
+  // Skip what's left at the end instead of splitting the allocation
+  if ( start % capacity_ + size > capacity_ ) {
+    start = ( start / capacity_ + 1 ) * capacity_;
+  }
+  if ( start + size - tail_ > capacity_ ) {
+    return false;
+  }
+
+  *offset = start % capacity_;
+  head_ = start + size;
+  return true;
+}
+
+void StagingRing::release( VkDeviceSize position ) { tail_ = std::max( tail_, position ); }
+
+#pragma endregion Staging ring
+
+#pragma region Upload queue
+
+UploadQueue::UploadQueue( VulkanDevice *vulkanDevice, VkDeviceSize stagingSize )
+    : vulkanDevice_( vulkanDevice ), ring_( stagingSize ) {
+  QueueFamilyIndices indices = vulkanDevice_->find_queue_families( vulkanDevice_->physicalDevice );
+  dedicated_ = vulkanDevice_->dedicatedTransfer;
+  graphicsFamily_ = indices.graphicsFamily.value();
+  transferFamily_ = dedicated_ ? indices.transferFamily.value() : graphicsFamily_;
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties( vulkanDevice_->physicalDevice, &properties );
+  copyAlignment_ =
+      std::max<VkDeviceSize>( properties.limits.optimalBufferCopyOffsetAlignment, 16 );
+
+  batches_.resize( UPLOAD_BATCHES );
+  std::vector<VkCommandBuffer> commandBuffers( UPLOAD_BATCHES );
+
+  VkCommandPoolCreateInfo poolInfo = Initializer::pool_info( graphicsFamily_ );
+  if ( vkCreateCommandPool( vulkanDevice_->device, &poolInfo, nullptr, &graphicsPool_ ) !=
+       VK_SUCCESS ) {
+    Logger::log( "Failed to create upload command pool!", Logger::CRITICAL );
+  }
+  VkCommandBufferAllocateInfo allocInfo =
+      Initializer::command_buffer_allocate_info( graphicsPool_, UPLOAD_BATCHES );
+  vkAllocateCommandBuffers( vulkanDevice_->device, &allocInfo, commandBuffers.data() );
+  for ( uint32_t i = 0; i < UPLOAD_BATCHES; i++ ) {
+    batches_[i].graphics = commandBuffers[i];
+  }
+
+  if ( dedicated_ ) {
+    poolInfo = Initializer::pool_info( transferFamily_ );
+    if ( vkCreateCommandPool( vulkanDevice_->device, &poolInfo, nullptr, &transferPool_ ) !=
+         VK_SUCCESS ) {
+      Logger::log( "Failed to create transfer command pool!", Logger::CRITICAL );
+    }
+    allocInfo = Initializer::command_buffer_allocate_info( transferPool_, UPLOAD_BATCHES );
+    vkAllocateCommandBuffers( vulkanDevice_->device, &allocInfo, commandBuffers.data() );
+    for ( uint32_t i = 0; i < UPLOAD_BATCHES; i++ ) {
+      batches_[i].transfer = commandBuffers[i];
+    }
+    transferTimeline_ = new VulkanTimeline( vulkanDevice_ );
+  }
+
+  Buffer::create_buffer( stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                         staging_, vulkanDevice_ );
+  stagingMapped_ = static_cast<uint8_t *>( staging_.allocation.mapped );
+
+  if ( dedicated_ ) {
+    THUMPY_LOG_CHANNEL( uploadChannel, Logger::DEBUG, "Uploading on transfer queue family ",
+                        transferFamily_, ", ", stagingSize, " byte staging ring" );
+  } else {
+    THUMPY_LOG_CHANNEL( uploadChannel, Logger::DEBUG, "Uploading on the graphics queue, ",
+                        stagingSize, " byte staging ring" );
+  }
+}
+
+void UploadQueue::destroy() {
+  // Only batches never flushed still own their one-off staging
+  for ( Batch &batch : batches_ ) {
+    batch.oversized.clear();
+  }
+  staging_.reset();
+
+  // Frees the command buffers too
+  vkDestroyCommandPool( vulkanDevice_->device, graphicsPool_, nullptr );
+  if ( transferPool_ != VK_NULL_HANDLE ) {
+    vkDestroyCommandPool( vulkanDevice_->device, transferPool_, nullptr );
+  }
+  if ( transferTimeline_ != nullptr ) {
+    transferTimeline_->destroy();
+    delete transferTimeline_;
+    transferTimeline_ = nullptr;
+  }
+}
+
+void UploadQueue::upload_buffer( VkBuffer buffer, VkDeviceSize offset, const void *data,
+                                 VkDeviceSize size, VkPipelineStageFlags dstStage,
+                                 VkAccessFlags dstAccess ) {
+  VkBuffer source;
+  VkDeviceSize sourceOffset;
+  uint8_t *mapped = reserve_staging( size, copyAlignment_, &source, &sourceOffset );
+  std::memcpy( mapped, data, static_cast<size_t>( size ) );
+
+  Batch &batch = begin_batch();
+  VkBufferCopy region{ sourceOffset, offset, size };
+  vkCmdCopyBuffer( copy_commands( batch ), source, buffer, 1, &region );
+
+  VkBufferMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = dstAccess;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = buffer;
+  barrier.offset = offset;
+  barrier.size = size;
+
+  if ( dedicated_ ) {
+    // Release on the transfer queue, the matching acquire goes on the graphics queue
+    barrier.srcQueueFamilyIndex = transferFamily_;
+    barrier.dstQueueFamilyIndex = graphicsFamily_;
+    VkBufferMemoryBarrier release = barrier;
+    release.dstAccessMask = 0;
+    vkCmdPipelineBarrier( batch.transfer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release, 0,
+                          nullptr );
+    barrier.srcAccessMask = 0;
+  }
+  vkCmdPipelineBarrier( batch.graphics, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr, 1,
+                        &barrier, 0, nullptr );
+  batch.uploads++;
+}
+
+void UploadQueue::upload_image( VkImage image, VkFormat format, VkExtent2D extent,
+                                uint32_t mipLevels, const void *pixels, VkDeviceSize size ) {
+  VkBuffer source;
+  VkDeviceSize sourceOffset;
+  uint8_t *mapped = reserve_staging( size, copyAlignment_, &source, &sourceOffset );
+  std::memcpy( mapped, pixels, static_cast<size_t>( size ) );
+
+  Batch &batch = begin_batch();
+  VkCommandBuffer copy = copy_commands( batch );
+  Image::transition_image_layout( copy, image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels );
+  Image::copy_buffer_to_image( copy, source, sourceOffset, image, extent.width, extent.height );
+
+  if ( dedicated_ ) {
+    // Every mip changes queue, the blits write the ones the copy didn't
+    VkImageMemoryBarrier barrier = Initializer::image_memory_barrier(
+        image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        mipLevels );
+    barrier.srcQueueFamilyIndex = transferFamily_;
+    barrier.dstQueueFamilyIndex = graphicsFamily_;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    vkCmdPipelineBarrier( batch.transfer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                          &barrier );
+
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier( batch.graphics, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+  }
+
+  // Blits need a graphics queue
+  Image::generate_mipmaps( batch.graphics, image, format, static_cast<int32_t>( extent.width ),
+                           static_cast<int32_t>( extent.height ), mipLevels, vulkanDevice_ );
+  batch.uploads++;
+}
+
+UploadToken UploadQueue::flush() {
+  reclaim();
+
+  Batch &batch = batches_[current_];
+  if ( !batch.recording ) {
+    return lastToken_;
+  }
+  batch.stagingEnd = ring_.head();
+
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+
+  if ( dedicated_ ) {
+    vkEndCommandBuffer( batch.transfer );
+    submitInfo.pCommandBuffers = &batch.transfer;
+    uint64_t transferValue = transferTimeline_->submit( vulkanDevice_->transferQueue, submitInfo );
+
+    // The acquires wait for the copies, frames submitted later wait for the acquires
+    VkSemaphore transferSemaphore = transferTimeline_->semaphore();
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    vkEndCommandBuffer( batch.graphics );
+    submitInfo.pCommandBuffers = &batch.graphics;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &transferSemaphore;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    batch.timelineValue =
+        vulkanDevice_->timeline->submit( vulkanDevice_->graphicsQueue, submitInfo, &transferValue );
+  } else {
+    vkEndCommandBuffer( batch.graphics );
+    submitInfo.pCommandBuffers = &batch.graphics;
+    batch.timelineValue =
+        vulkanDevice_->timeline->submit( vulkanDevice_->graphicsQueue, submitInfo );
+  }
+
+  THUMPY_LOG_CHANNEL( uploadChannel, Logger::DEBUG, "Submitted ", batch.uploads, " uploads, ",
+                      ring_.used(), " staging bytes in use" );
+
+  // One-off staging goes once the copies reading it are done
+  for ( Buffer::Buffer &buffer : batch.oversized ) {
+    buffer.reset( batch.timelineValue );
+  }
+  batch.oversized.clear();
+
+  batch.recording = false;
+  batch.submitted = true;
+  batch.uploads = 0;
+  lastToken_ = UploadToken{ batch.timelineValue };
+  current_ = ( current_ + 1 ) % UPLOAD_BATCHES;
+  return lastToken_;
+}
+
+bool UploadQueue::is_complete( UploadToken token ) {
+  return vulkanDevice_->timeline->is_complete( token.timelineValue );
+}
+
+void UploadQueue::wait( UploadToken token ) {
+  vulkanDevice_->timeline->wait( token.timelineValue );
+  reclaim();
+}
+
+uint8_t *UploadQueue::reserve_staging( VkDeviceSize size, VkDeviceSize alignment,
+                                       VkBuffer *buffer, VkDeviceSize *offset ) {
+  // Anything this large would keep most of the ring busy, it gets its own staging buffer
+  if ( size > ring_.capacity() / 4 ) {
+    Batch &batch = begin_batch();
+    Buffer::Buffer &staging = batch.oversized.emplace_back();
+    Buffer::create_buffer( size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           staging, vulkanDevice_ );
+    *buffer = staging.buffer;
+    *offset = 0;
+    return static_cast<uint8_t *>( staging.allocation.mapped );
+  }
+
+  while ( !ring_.allocate( size, alignment, offset ) ) {
+    // Submit what's queued so it can finish, then wait for the oldest batch to give space back
+    if ( batches_[current_].recording ) {
+      flush();
+    }
+    THUMPY_LOG_CHANNEL( uploadChannel, Logger::DEBUG, "Staging ring full, waiting on the GPU" );
+    vulkanDevice_->timeline->wait( batches_[oldest_].timelineValue );
+    reclaim();
+  }
+  *buffer = staging_.buffer;
+  return stagingMapped_ + *offset;
+}
+
+UploadQueue::Batch &UploadQueue::begin_batch() {
+  Batch &batch = batches_[current_];
+  if ( batch.recording ) {
+    return batch;
+  }
+  if ( batch.submitted ) {
+    vulkanDevice_->timeline->wait( batch.timelineValue );
+    reclaim();
+  }
+
+  VkCommandBufferBeginInfo beginInfo = Initializer::command_buffer_begin_info();
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if ( dedicated_ ) {
+    vkBeginCommandBuffer( batch.transfer, &beginInfo );
+  }
+  vkBeginCommandBuffer( batch.graphics, &beginInfo );
+  batch.recording = true;
+  return batch;
+}
+
+void UploadQueue::reclaim() {
+  // Batches finish in submission order, stop at the first one still running
+  while ( batches_[oldest_].submitted ) {
+    Batch &batch = batches_[oldest_];
+    if ( !vulkanDevice_->timeline->is_complete( batch.timelineValue ) ) {
+      return;
+    }
+    ring_.release( batch.stagingEnd );
+    batch.submitted = false;
+    oldest_ = ( oldest_ + 1 ) % UPLOAD_BATCHES;
+  }
+}
+
+#pragma endregion Upload queue
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
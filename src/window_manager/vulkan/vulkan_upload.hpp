@@ -0,0 +1,207 @@
+/**
+ * @file vulkan_upload.hpp
+ * @author Thumpy (◕‿◕✿)
+ * @brief Streams buffer & image data to the GPU through one mapped staging ring
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "vulkan_buffers.hpp"
+#include "vulkan_device.hpp"
+
+namespace Thumpy {
+namespace Core {
+namespace Windows {
+namespace Vulkan {
+
+class VulkanTimeline;
+
+// Staging memory shared by every upload in flight
+const VkDeviceSize STAGING_RING_SIZE = 32 * 1024 * 1024;
+
+// Submitted batches before queuing more uploads waits on the oldest one
+const uint32_t UPLOAD_BATCHES = 4;
+
+/**
+ * @brief Ring of bytes handed out in order & given back in order once the GPU is done reading
+ * them. Allocations never wrap around the end, capacity has to be a multiple of every alignment.
+ */
+class StagingRing {
+ public:
+  explicit StagingRing( VkDeviceSize capacity ) : capacity_( capacity ) {}
+
+  /**
+   * @brief Take size bytes at the head of the ring
+   *
+   * @param size
+   * @param alignment power of two
+   * @param offset set on success
+   * @return false if the ring is too full, nothing changes
+   */
+  bool allocate( VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset );
+
+  /**
+   * @brief Give back everything allocated before position
+   *
+   * @param position head() when the allocations were submitted
+   */
+  void release( VkDeviceSize position );
+
+  // Ever increasing, counts every byte allocated & skipped
+  VkDeviceSize head() const { return head_; }
+  VkDeviceSize used() const { return head_ - tail_; }
+  VkDeviceSize capacity() const { return capacity_; }
+
+ private:
+  VkDeviceSize capacity_;
+  VkDeviceSize head_ = 0;
+  VkDeviceSize tail_ = 0;
+};
+
+/**
+ * @brief Completion of a flush, on the device timeline
+ *
+ */
+struct UploadToken {
+  uint64_t timelineValue = 0;
+};
+
+/**
+ * @brief Copies data to device local buffers & images without stalling the CPU.
+ * Data is copied into the staging ring when queued, every upload queued between two flushes is
+ * recorded into one batch & submitted at once. On devices with a dedicated transfer queue the
+ * copies run there and ownership is released to the graphics queue, which acquires it and
+ * generates mips. Work submitted to the graphics queue after a flush sees the uploaded data
+ * without waiting on the token. Destinations must not be in use by the GPU.
+ * Not thread safe, queue uploads from the render thread.
+ */
+class UploadQueue {
+ public:
+  UploadQueue( VulkanDevice *vulkanDevice, VkDeviceSize stagingSize = STAGING_RING_SIZE );
+
+  /**
+   * @brief Destroy the staging ring & command pools, the device has to be idle
+   *
+   */
+  void destroy();
+
+  /**
+   * @brief Queue a copy of size bytes into buffer
+   *
+   * @param buffer needs VK_BUFFER_USAGE_TRANSFER_DST_BIT
+   * @param offset into buffer
+   * @param data copied before returning
+   * @param size
+   * @param dstStage first stage that reads the buffer
+   * @param dstAccess how it reads it
+   */
+  void upload_buffer( VkBuffer buffer, VkDeviceSize offset, const void *data, VkDeviceSize size,
+                      VkPipelineStageFlags dstStage, VkAccessFlags dstAccess );
+
+  /**
+   * @brief Queue pixels into mip 0 of a new image, the other mips are generated from it and
+   * every mip ends in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+   * @param image in VK_IMAGE_LAYOUT_UNDEFINED, needs TRANSFER_SRC & TRANSFER_DST usage
+   * @param format
+   * @param extent
+   * @param mipLevels
+   * @param pixels copied before returning
+   * @param size
+   */
+  void upload_image( VkImage image, VkFormat format, VkExtent2D extent, uint32_t mipLevels,
+                     const void *pixels, VkDeviceSize size );
+
+  /**
+   * @brief Submit every upload queued since the last flush, never blocks unless the staging
+   * ring is full. Cheap when nothing is queued
+   * @return UploadToken completes once the uploads are done, the last token if nothing was queued
+   */
+  UploadToken flush();
+
+  bool is_complete( UploadToken token );
+
+  /**
+   * @brief Block until the uploads of a flush are done
+   *
+   * @param token
+   */
+  void wait( UploadToken token );
+
+  bool dedicated_transfer() const { return dedicated_; }
+
+ private:
+  struct Batch {
+    // Copies & ownership releases, on the transfer queue. Unused without one
+    VkCommandBuffer transfer = VK_NULL_HANDLE;
+    // Ownership acquires, mip generation & copies without a transfer queue
+    VkCommandBuffer graphics = VK_NULL_HANDLE;
+    bool recording = false;
+    bool submitted = false;
+    uint32_t uploads = 0;
+    // Ring head once submitted, everything before it is released on completion
+    VkDeviceSize stagingEnd = 0;
+    uint64_t timelineValue = 0;
+    // Staging for uploads too large for the ring, queued for deletion on flush
+    std::vector<Buffer::Buffer> oversized;
+  };
+
+  /**
+   * @brief Staging for size bytes in the current batch, flushes & waits if the ring is full
+   *
+   * @return uint8_t* where to write the data
+   */
+  uint8_t *reserve_staging( VkDeviceSize size, VkDeviceSize alignment, VkBuffer *buffer,
+                            VkDeviceSize *offset );
+
+  /**
+   * @brief The batch being recorded, begins it if it hasn't been yet
+   *
+   * @return Batch&
+   */
+  Batch &begin_batch();
+
+  /**
+   * @brief Release the ring space of every batch the GPU has finished, oldest first
+   *
+   */
+  void reclaim();
+
+  VkCommandBuffer copy_commands( Batch &batch ) {
+    return dedicated_ ? batch.transfer : batch.graphics;
+  }
+
+  VulkanDevice *vulkanDevice_;
+  bool dedicated_;
+  uint32_t graphicsFamily_;
+  uint32_t transferFamily_;
+  VkDeviceSize copyAlignment_;
+
+  VkCommandPool graphicsPool_ = VK_NULL_HANDLE;
+  VkCommandPool transferPool_ = VK_NULL_HANDLE;
+  // The transfer queue's own progress, the graphics queue waits on it
+  VulkanTimeline *transferTimeline_ = nullptr;
+
+  Buffer::Buffer staging_;
+  uint8_t *stagingMapped_;
+  StagingRing ring_;
+
+  std::vector<Batch> batches_;
+  uint32_t current_ = 0;
+  uint32_t oldest_ = 0;
+  UploadToken lastToken_;
+};
+
+}  // namespace Vulkan
+}  // namespace Windows
+}  // namespace Core
+}  // namespace Thumpy
@@ -15,19 +15,29 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>  // Necessary for uint32_t
+#include <cstdlib>
 #include <cstring>
+#include <glm/ext/matrix_transform.hpp>
 #include <glm/ext/vector_float2.hpp>
 #include <glm/ext/vector_float3.hpp>
 #include <string>
 #include <vector>
 
+#include "flight_recorder.hpp"
 #include "logger.hpp"
 #include "vulkan_buffers.hpp"
 #include "vulkan_construct.hpp"
+#include "vulkan_culling.hpp"
 #include "vulkan_debug.hpp"
+#include "vulkan_deletion_queue.hpp"
+#include "vulkan_frame_allocator.hpp"
 #include "vulkan_helper.hpp"
 #include "vulkan_image.hpp"
+#include "vulkan_timeline.hpp"
+#include "vulkan_upload.hpp"
 #include "vulkan_window.hpp"
 
 namespace Thumpy {
@@ -35,9 +45,36 @@ namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+namespace {
+
+int clamp_frames_in_flight( int framesInFlight ) {
+  int clamped = std::clamp( framesInFlight, MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT );
+  if ( clamped != framesInFlight ) {
+    THUMPY_LOG( Logger::WARNING, framesInFlight, " frames in flight is out of range, using ",
+                clamped );
+  }
+  return clamped;
+}
+
+int default_frames_in_flight() {
+  const char *value = std::getenv( frames_in_flight_variable.c_str() );
+  if ( value == nullptr ) {
+    return DEFAULT_FRAMES_IN_FLIGHT;
+  }
+  return std::atoi( value );
+}
+
+}  // namespace
+
 #pragma region Core
 
-VulkanWindow::VulkanWindow( std::string title ) : Window( title ) { init_vulkan(); }
+VulkanWindow::VulkanWindow( std::string title )
+    : VulkanWindow( title, default_frames_in_flight() ) {}
+
+VulkanWindow::VulkanWindow( std::string title, int framesInFlight )
+    : Window( title ), framesInFlight_( clamp_frames_in_flight( framesInFlight ) ) {
+  init_vulkan();
+}
 
 void VulkanWindow::init_vulkan() {
   // Create our instance
@@ -56,33 +93,24 @@ void VulkanWindow::init_vulkan() {
   swapChain_ = new VulkanSwapChain( vulkanDevice_, window_, surface_ );
 
   // Create descriptor layouts
-  descriptors_ = new Descriptors();
-  Construct::descriptor_set_layout( vulkanDevice_, descriptors_->setLayout );
+  Construct::descriptor_set_layout( vulkanDevice_, descriptors_ );
 
   // Create graphics pipeline
-  pipeline_ = create_graphics_pipeline( swapChain_, vulkanDevice_, descriptors_->setLayout );
+  pipeline_ = create_graphics_pipeline( swapChain_, vulkanDevice_, descriptors_.setLayout );
 
   // Multisampling
-  msaaColorBuffer_ = new VulkanImage();
-  Image::create_color_resources( msaaColorBuffer_, vulkanDevice_, swapChain_ );
-
-  // Depth buffer
-  depthBuffer_ = new VulkanImage();
-  Image::create_depth_resources( depthBuffer_, vulkanDevice_, swapChain_->extent );
-
-  // Create frame buffers
-  Buffer::create_framebuffers( swapChain_, depthBuffer_->imageView, msaaColorBuffer_->imageView,
-                               vulkanDevice_->device );
+  Image::create_color_resources( &msaaColorBuffer_, vulkanDevice_, swapChain_ );
 
   // Create command pool
-  commandPool_ = new Construct::CommandPool();
-  Construct::command_pool( vulkanDevice_, commandPool_->pool );
+  Construct::command_pool( vulkanDevice_, commandPool_ );
+
+  // Uploads stream through a staging ring, on the transfer queue when there is one
+  uploadQueue_ = new UploadQueue( vulkanDevice_ );
 
   // Create texture image / view / sampler
-  textureImage_ = new VulkanTextureImage();
-  Image::create_texture_image( vulkanDevice_, textureImage_, commandPool_->pool, TEXTURE_PATH );
-  Image::create_texture_image_view( vulkanDevice_->device, textureImage_ );
-  Image::create_texture_sampler( vulkanDevice_, textureImage_ );
+  Image::create_texture_image( vulkanDevice_, &textureImage_, uploadQueue_, TEXTURE_PATH );
+  Image::create_texture_image_view( vulkanDevice_->device, &textureImage_ );
+  Image::create_texture_sampler( vulkanDevice_, &textureImage_ );
 
   // Create vertex buffer
 
@@ -92,63 +120,70 @@ void VulkanWindow::init_vulkan() {
 
   // mesh_ = Shapes::generate_sierpinski_triangle( mesh_, 1 );
 
-  vertexBuffer_ = new Buffer::Buffer();
-  Buffer::create_vertex_buffer( mesh_->vertices, vulkanDevice_, vertexBuffer_, commandPool_->pool );
+  Buffer::create_vertex_buffer( mesh_->vertices, vulkanDevice_, &vertexBuffer_, uploadQueue_ );
 
   // Create Index Buffer
-  indexBuffer_ = new Buffer::Buffer();
-  Buffer::create_index_buffer( mesh_->indices, vulkanDevice_, indexBuffer_, commandPool_->pool );
+  Buffer::create_index_buffer( mesh_->indices, vulkanDevice_, &indexBuffer_, uploadQueue_ );
 
-  // Create uniform buffers
-  uniformBuffers_ = new Construct::UniformBuffers();
-  Construct::uniform_buffers( vulkanDevice_, uniformBuffers_, MAX_FRAMES_IN_FLIGHT );
+  // The first frame is submitted to the graphics queue after these, no need to wait on them
+  uploadQueue_->flush();
 
-  // Create descriptor pool
-  Construct::descriptor_pool( vulkanDevice_, descriptors_->pool, MAX_FRAMES_IN_FLIGHT );
+  // Every mesh is drawn from the shared vertex & index buffers
+  drawList_.set_geometry( vertexBuffer_.buffer, indexBuffer_.buffer );
+  meshId_ = drawList_.add_mesh( MeshRange{ 0, static_cast<uint32_t>( mesh_->indices.size() ), 0,
+                                           bounding_sphere( mesh_->vertices ) } );
+  startTime_ = std::chrono::steady_clock::now();
 
-  // Create descriptor sets
-  Construct::descriptor_sets( vulkanDevice_, descriptors_, uniformBuffers_->buffers, textureImage_,
-                              MAX_FRAMES_IN_FLIGHT );
+  // Create uniform buffers / descriptor sets / command buffers / render
+  create_frame_resources();
 
-  // Create command buffer
-  Construct::command_buffer( commandPool_->buffers, commandPool_->pool, vulkanDevice_->device,
-                             MAX_FRAMES_IN_FLIGHT );
+  // Depth buffer, only stored & sampled when the culling pass loaded its depth pyramid pipelines
+  swapChain_->set_depth_stored( culling_->occlusion_supported() );
+  Image::create_depth_resources( &depthBuffer_, vulkanDevice_, swapChain_->extent,
+                                 swapChain_->depthStored );
+  culling_->create_depth_pyramid( swapChain_->extent );
 
-  // Create render
-  render_ = new VulkanRender( MAX_FRAMES_IN_FLIGHT, vulkanDevice_, swapChain_,
-                              &commandPool_->buffers, pipeline_ );
+  // Create frame buffers
+  Buffer::create_framebuffers( swapChain_, depthBuffer_.imageView, msaaColorBuffer_.imageView,
+                               vulkanDevice_->device );
 }
 
 void VulkanWindow::deconstruct_window() {
   Logger::log( "Destroying vulkan..." );
 
+  // Frames may still be in flight
+  vkDeviceWaitIdle( vulkanDevice_->device );
+
   swapChain_->clear_swap_chain();
 
   destroy_graphics_pipeline( vulkanDevice_->device, pipeline_ );
 
   vkDestroyRenderPass( vulkanDevice_->device, swapChain_->renderPass, nullptr );
 
-  render_->destroy();
-
-  for ( size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ ) {
-    vkDestroyBuffer( vulkanDevice_->device, uniformBuffers_->buffers[i], nullptr );
-    vkFreeMemory( vulkanDevice_->device, uniformBuffers_->memory[i], nullptr );
-  }
-
-  vkDestroyDescriptorPool( vulkanDevice_->device, descriptors_->pool, nullptr );
+  destroy_frame_resources();
 
-  textureImage_->destroy( vulkanDevice_->device );
-  depthBuffer_->destroy( vulkanDevice_->device );
-  msaaColorBuffer_->destroy( vulkanDevice_->device );
+  // Queued for deletion, the queue is flushed once nothing else can add to it
+  textureImage_.reset();
+  depthBuffer_.reset();
+  msaaColorBuffer_.reset();
+  descriptors_.reset();
+  indexBuffer_.reset();
+  vertexBuffer_.reset();
+  commandPool_.reset();
 
-  vkDestroyDescriptorSetLayout( vulkanDevice_->device, descriptors_->setLayout, nullptr );
+  uploadQueue_->destroy();
+  delete uploadQueue_;
 
-  indexBuffer_->destroy( vulkanDevice_->device );
+  // Everything queued above or replaced while running, the device is idle so it all goes now
+  vulkanDevice_->deletionQueue->destroy();
+  delete vulkanDevice_->deletionQueue;
 
-  vertexBuffer_->destroy( vulkanDevice_->device );
+  vulkanDevice_->timeline->destroy();
+  delete vulkanDevice_->timeline;
 
-  // vkDestroyCommandPool( vulkanDevice_->device, commandPool_, nullptr );
-  commandPool_->destroy( vulkanDevice_->device );
+  vulkanDevice_->allocator->log_stats();
+  vulkanDevice_->allocator->destroy();
+  delete vulkanDevice_->allocator;
 
   vkDestroyDevice( vulkanDevice_->device, nullptr );
 
@@ -164,12 +199,40 @@ void VulkanWindow::deconstruct_window() {
 
 void VulkanWindow::loop() {
   Window::loop();
-  render_->draw_frame( vertexBuffer_->buffer, static_cast<uint32_t>( mesh_->vertices.size() ),
-                       indexBuffer_->buffer, static_cast<uint32_t>( mesh_->indices.size() ),
-                       uniformBuffers_->mapped, descriptors_->sets, depthBuffer_,
-                       msaaColorBuffer_ );
+  auto frameStart = std::chrono::steady_clock::now();
+  float time = std::chrono::duration<float>( frameStart - startTime_ ).count();
+  glm::mat4 model = glm::rotate( glm::mat4( 1.0f ), time * glm::radians( 90.0f ),
+                                 glm::vec3( 0.0f, 0.0f, 1.0f ) );
+
+  drawList_.clear();
+  drawList_.add_instance( meshId_, model );
+  drawList_.build();
+
+  FrameResult result = draw_frame();
+  if ( result == FRAME_MINIMIZED ) {
+    // Idle until something happens instead of spinning
+    glfwWaitEventsTimeout( MINIMIZED_WAIT_SECONDS );
+    return;
+  } else if ( result == FRAME_SKIPPED ) {
+    // Nothing was presented, so there are no stats to record
+    return;
+  }
 
-  vkDeviceWaitIdle( vulkanDevice_->device );
+  Logger::record_frame_stats( std::chrono::duration<float, std::chrono::milliseconds::period>(
+                                  std::chrono::steady_clock::now() - frameStart )
+                                  .count() );
+  render_->report_frame_pacing();
+}
+
+FrameResult VulkanWindow::draw_frame() {
+  // Every resize event since the last frame collapses into one
+  if ( framebufferResized ) {
+    framebufferResized = false;
+    render_->framebuffer_resized();
+  }
+  // Anything queued since the last frame goes out ahead of it
+  uploadQueue_->flush();
+  return render_->draw_frame( drawList_, &depthBuffer_, &msaaColorBuffer_ );
 }
 
 void VulkanWindow::create_surface() {
@@ -180,6 +243,75 @@ void VulkanWindow::create_surface() {
 
 #pragma endregion Core
 
+#pragma region Frames in flight
+
+void VulkanWindow::set_frames_in_flight( int framesInFlight ) {
+  framesInFlight = clamp_frames_in_flight( framesInFlight );
+  if ( framesInFlight == framesInFlight_ ) {
+    return;
+  }
+
+  THUMPY_LOG( Logger::INFO, "Frames in flight: ", framesInFlight_, " -> ", framesInFlight );
+  vkDeviceWaitIdle( vulkanDevice_->device );
+  destroy_frame_resources();
+  framesInFlight_ = framesInFlight;
+  create_frame_resources();
+  // Same device & shaders, so occlusion support & with it the depth buffer are unchanged
+  culling_->create_depth_pyramid( swapChain_->extent );
+}
+
+void VulkanWindow::create_frame_resources() {
+  // Create the ring the camera, instances & bounds are allocated from every frame
+  frameAllocator_ = new FrameAllocator( vulkanDevice_, framesInFlight_, FRAME_ALLOCATOR_SIZE,
+                                        sizeof( InstanceData ) * MAX_DRAW_INSTANCES );
+
+  // Create indirect & visible buffers
+  Construct::draw_buffers( vulkanDevice_, &drawBuffers_, framesInFlight_ );
+
+  // Create culling pass over the draw buffers
+  culling_ = new VulkanCulling( vulkanDevice_, framesInFlight_, frameAllocator_, drawBuffers_,
+                                &depthBuffer_ );
+
+  // Create descriptor pool
+  Construct::descriptor_pool( vulkanDevice_, descriptors_, framesInFlight_ );
+
+  // Create descriptor sets
+  Construct::descriptor_sets( vulkanDevice_, &descriptors_, frameAllocator_, &drawBuffers_,
+                              &textureImage_, framesInFlight_ );
+
+  // Create command buffer
+  Construct::command_buffer( commandPool_.buffers, commandPool_.pool, vulkanDevice_->device,
+                             framesInFlight_ );
+
+  // Create render
+  render_ = new VulkanRender( framesInFlight_, vulkanDevice_, swapChain_, commandPool_.buffers,
+                              frameAllocator_, drawBuffers_, descriptors_.sets, pipeline_,
+                              culling_ );
+}
+
+void VulkanWindow::destroy_frame_resources() {
+  render_->destroy();
+  delete render_;
+
+  vkFreeCommandBuffers( vulkanDevice_->device, commandPool_.pool,
+                        static_cast<uint32_t>( commandPool_.buffers.size() ),
+                        commandPool_.buffers.data() );
+  commandPool_.buffers.clear();
+
+  // Destroying the pool frees its descriptor sets
+  descriptors_.reset_pool();
+
+  frameAllocator_->destroy();
+  delete frameAllocator_;
+
+  culling_->destroy();
+  delete culling_;
+
+  drawBuffers_.reset();
+}
+
+#pragma endregion Frames in flight
+
 }  // namespace Vulkan
 }  // namespace Windows
 }  // namespace Core
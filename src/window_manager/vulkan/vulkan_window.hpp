@@ -13,8 +13,15 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <chrono>
+
 #include "vulkan/vulkan_buffers.hpp"
 #include "vulkan/vulkan_construct.hpp"
+#include "vulkan/vulkan_culling.hpp"
+#include "vulkan/vulkan_draw_list.hpp"
+#include "vulkan/vulkan_frame_allocator.hpp"
+#include "vulkan/vulkan_render.hpp"
+#include "vulkan/vulkan_upload.hpp"
 #include "vulkan_helper.hpp"
 #include "vulkan_pipeline.hpp"
 #include "window.hpp"
@@ -27,9 +34,20 @@ namespace Core {
 namespace Windows {
 namespace Vulkan {
 
+const int MIN_FRAMES_IN_FLIGHT = 1;
+const int MAX_FRAMES_IN_FLIGHT = 4;
+const int DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+// Longest a minimized window blocks the loop waiting for events
+const double MINIMIZED_WAIT_SECONDS = 0.1;
+
+// Overrides DEFAULT_FRAMES_IN_FLIGHT when set, e.g. THUMPY_FRAMES_IN_FLIGHT=3
+const std::string frames_in_flight_variable = "THUMPY_FRAMES_IN_FLIGHT";
+
 class VulkanWindow : public Window {
  public:
   VulkanWindow( std::string title );
+  VulkanWindow( std::string title, int framesInFlight );
 
 #pragma region Core
 
@@ -46,23 +64,115 @@ class VulkanWindow : public Window {
   void deconstruct_window();
 
   /**
-   * @brief Render loop
+   * @brief Render loop, rebuilds the draw list with the model & draws it
    *
    */
   void loop();
 
+  /**
+   * @brief Upload anything queued & draw the draw list as it is, without touching input,
+   * the flight recorder or the pacing log
+   * @return FrameResult
+   */
+  FrameResult draw_frame();
+
+  /**
+   * @brief Draw list the next frame draws, loop() refills it every frame
+   *
+   * @return DrawList&
+   */
+  DrawList &draw_list() { return drawList_; }
+
+  /**
+   * @brief Id of the loaded model in the draw list
+   *
+   * @return uint32_t
+   */
+  uint32_t mesh_id() const { return meshId_; }
+
   // move this to vulkan_construct
   void create_surface();
 
 #pragma endregion Core
 
+#pragma region Frames in flight
+
+  /**
+   * @brief Change how many frames the CPU may record ahead of the GPU, clamped to 1 - 4.
+   * Waits for the device to go idle and rebuilds the per frame resources.
+   * @param framesInFlight
+   */
+  void set_frames_in_flight( int framesInFlight );
+
+  int frames_in_flight() const { return framesInFlight_; }
+
+  /**
+   * @brief Frame rate & latency since the last pacing report
+   *
+   * @return const FramePacing&
+   */
+  const FramePacing &frame_pacing() const { return render_->frame_pacing(); }
+
+  /**
+   * @brief If frame latency is measured up to present, see FramePacing
+   *
+   * @return bool
+   */
+  bool times_present() const { return render_->times_present(); }
+
+#pragma endregion Frames in flight
+
+#pragma region Culling
+
+  /**
+   * @brief If instances are culled on the GPU, needs cull.comp.spv & drawIndirectFirstInstance
+   *
+   * @return bool
+   */
+  bool culling_enabled() const { return culling_->enabled(); }
+
+  /**
+   * @brief If the depth buffer can be sampled for occlusion culling
+   *
+   * @return bool
+   */
+  bool occlusion_supported() const { return culling_->occlusion_supported(); }
+
+  /**
+   * @brief Turn occlusion culling on or off, frustum culling stays on
+   *
+   * @param enabled
+   */
+  void set_occlusion_culling( bool enabled ) { culling_->set_occlusion_culling( enabled ); }
+
+  /**
+   * @brief Culling stats of the last frame the GPU finished
+   *
+   * @return const CullingStats&
+   */
+  const CullingStats &culling_stats() const { return culling_->stats(); }
+
+#pragma endregion Culling
+
   // const std::string TEXTURE_PATH = "vj_swirl.png";
 
   const std::string MODEL_PATH = "viking_room.obj";
   const std::string TEXTURE_PATH = "viking_room.png";
 
  private:
-  const int MAX_FRAMES_IN_FLIGHT = 2;
+  /**
+   * @brief Create the resources each frame in flight owns: frame allocator, indirect & visible
+   * buffers, culling, descriptor sets, command buffers & sync objects
+   */
+  void create_frame_resources();
+
+  /**
+   * @brief Destroy the per frame resources, the device has to be idle
+   *
+   */
+  void destroy_frame_resources();
+
+  int framesInFlight_;
 
   VkInstance instance_;
   VkSurfaceKHR surface_;
@@ -70,19 +180,26 @@ class VulkanWindow : public Window {
   VulkanDevice *vulkanDevice_;
   VulkanSwapChain *swapChain_;
   VulkanPipeline *pipeline_;
-  VulkanTextureImage *textureImage_;
-  VulkanImage *depthBuffer_;
-  VulkanImage *msaaColorBuffer_;
+  VulkanTextureImage textureImage_;
+  VulkanImage depthBuffer_;
+  VulkanImage msaaColorBuffer_;
   VulkanRender *render_;
 
-  Construct::CommandPool *commandPool_;
-  Construct::UniformBuffers *uniformBuffers_;
-  Buffer::Buffer *vertexBuffer_;
-  Buffer::Buffer *indexBuffer_;
-  Descriptors *descriptors_;
+  Construct::CommandPool commandPool_;
+  UploadQueue *uploadQueue_;
+  FrameAllocator *frameAllocator_;
+  Construct::DrawBuffers drawBuffers_;
+  VulkanCulling *culling_;
+  Buffer::Buffer vertexBuffer_;
+  Buffer::Buffer indexBuffer_;
+  Descriptors descriptors_;
 
   Mesh *mesh_;
 
+  DrawList drawList_;
+  uint32_t meshId_;
+  std::chrono::steady_clock::time_point startTime_;
+
   VkDebugUtilsMessengerEXT debugMessenger_;
 
   // warp t
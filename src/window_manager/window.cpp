@@ -31,7 +31,7 @@ void Window::deconstruct_window() {
   if (window_ == NULL) {
     return;
   }
-  Logger::log("Destroying window - " + title_ + "", Logger::INFO);
+  THUMPY_LOG(Logger::INFO, "Destroying window - ", title_);
   glfwDestroyWindow(window_);
 }
 